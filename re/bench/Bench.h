@@ -0,0 +1,31 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+namespace RE::Bench {
+
+/**
+ * Run the function `repeats` times and report the average time per run
+ */
+template <typename F>
+double measure(const std::string& name, const size_t repeats, F&& f) {
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < repeats; i++) {
+        f();
+    }
+    const std::chrono::duration<double, std::micro> elapsed =
+        std::chrono::steady_clock::now() - start;
+    const auto perRun = elapsed.count() / repeats;
+    std::printf("%-48s %12.3f us\n", name.c_str(), perRun);
+    return perRun;
+}
+
+/* Keep the optimizer from discarding a result */
+template <typename T>
+void doNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+} // namespace RE::Bench
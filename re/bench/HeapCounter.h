@@ -0,0 +1,103 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+/**
+ * Counts the bytes and the blocks allocated through operator new, so that a
+ * benchmark can report the peak of the heap while running a function, or
+ * the calls to the allocator it makes. It replaces the
+ * global operator new and delete, so it is included by a single file of the
+ * benchmark only. The counters are atomic, as the parallel compiles
+ * allocate from several threads; the peak is that of the whole heap.
+ */
+namespace RE::Bench::HeapCounter {
+
+inline std::atomic<size_t> current = 0u;
+inline std::atomic<size_t> peak = 0u;
+inline std::atomic<size_t> numAllocations = 0u;
+
+/* The peak of the heap while running the function, above its size before */
+template <typename F>
+size_t peakBytes(F&& f) {
+    const auto before = current.load();
+    peak = before;
+    f();
+    return peak - before;
+}
+
+/* The blocks allocated while running the function */
+template <typename F>
+size_t allocations(F&& f) {
+    const auto before = numAllocations.load();
+    f();
+    return numAllocations - before;
+}
+
+} // namespace RE::Bench::HeapCounter
+
+namespace {
+
+/* the size is kept in front of the block, which stays aligned for any type */
+constexpr size_t HEADER_SIZE = alignof(std::max_align_t);
+
+/* The header is as long as the alignment, so that the block after it stays aligned */
+void* allocate(const size_t size, const size_t alignment) {
+    const auto headerSize = alignment < HEADER_SIZE ? HEADER_SIZE : alignment;
+    const auto total = (size + 2u * headerSize - 1u) / headerSize * headerSize;
+    auto* block = static_cast<char*>(std::aligned_alloc(headerSize, total));
+    if (block == nullptr) {
+        throw std::bad_alloc();
+    }
+    *reinterpret_cast<size_t*>(block) = size;
+    namespace HeapCounter = RE::Bench::HeapCounter;
+    HeapCounter::numAllocations.fetch_add(1u, std::memory_order_relaxed);
+    const auto current = HeapCounter::current.fetch_add(size, std::memory_order_relaxed) + size;
+    auto peak = HeapCounter::peak.load(std::memory_order_relaxed);
+    while (current > peak and not HeapCounter::peak.compare_exchange_weak(peak, current, std::memory_order_relaxed)) {
+        // the failed exchange has reloaded the peak
+    }
+    return block + headerSize;
+}
+
+void deallocate(void* pointer, const size_t alignment) noexcept {
+    if (pointer == nullptr) {
+        return;
+    }
+    auto* block = static_cast<char*>(pointer) - (alignment < HEADER_SIZE ? HEADER_SIZE : alignment);
+    RE::Bench::HeapCounter::current.fetch_sub(*reinterpret_cast<size_t*>(block), std::memory_order_relaxed);
+    std::free(block);
+}
+
+} // namespace
+
+void* operator new(size_t size) { return allocate(size, HEADER_SIZE); }
+void operator delete(void* pointer) noexcept { deallocate(pointer, HEADER_SIZE); }
+void* operator new[](size_t size) { return operator new(size); }
+void operator delete[](void* pointer) noexcept { operator delete(pointer); }
+void operator delete(void* pointer, size_t) noexcept { operator delete(pointer); }
+void operator delete[](void* pointer, size_t) noexcept { operator delete(pointer); }
+// e.g. the temporary buffer of std::stable_sort, freed by the plain delete
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return operator new(size);
+    }
+    catch (const std::bad_alloc&) {
+        return nullptr;
+    }
+}
+void* operator new[](size_t size, const std::nothrow_t& nothrow) noexcept { return operator new(size, nothrow); }
+
+// the memory resources of std::pmr allocate from these
+void* operator new(size_t size, std::align_val_t alignment) { return allocate(size, static_cast<size_t>(alignment)); }
+void operator delete(void* pointer, std::align_val_t alignment) noexcept {
+    deallocate(pointer, static_cast<size_t>(alignment));
+}
+void* operator new[](size_t size, std::align_val_t alignment) { return operator new(size, alignment); }
+void operator delete[](void* pointer, std::align_val_t alignment) noexcept { operator delete(pointer, alignment); }
+void operator delete(void* pointer, size_t, std::align_val_t alignment) noexcept { operator delete(pointer, alignment); }
+void operator delete[](void* pointer, size_t, std::align_val_t alignment) noexcept {
+    operator delete(pointer, alignment);
+}
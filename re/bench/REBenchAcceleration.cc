@@ -0,0 +1,54 @@
+#include "Bench.h"
+
+#include <RE.h>
+
+#include <functional>
+#include <regex>
+#include <string>
+
+using RE::Bench::doNotOptimize;
+using RE::Bench::measure;
+
+namespace {
+
+std::string makeLine(const size_t size) {
+    std::string line;
+    for (auto i = 0; line.size() < size; i++) {
+        line += "worker-" + std::to_string(i % 7) + " handled request " + std::to_string(i) + "; ";
+    }
+    return line;
+}
+
+/* std::regex recurses on each byte, hence is run on a shorter input */
+void benchMatchExact(const char* re, const std::function<std::string(size_t)>& makeInput,
+                     const size_t repeats) {
+    std::printf("%s\n", re);
+    const auto input = makeInput(1u << 20);
+    RE::REParser parser(re);
+    const auto perRun = measure("  REParser::matchExact", repeats, [&] {
+        doNotOptimize(parser.matchExact(input));
+    });
+    std::printf("  %.1f MB/s\n", input.size() / double(1u << 20) / perRun * 1e6);
+
+    const auto shortInput = makeInput(1u << 14);
+    const std::regex stdRegex(re);
+    const auto stdPerRun = measure("  std::regex_match", repeats, [&] {
+        doNotOptimize(std::regex_match(shortInput, stdRegex));
+    });
+    std::printf("  %.1f MB/s\n", shortInput.size() / double(1u << 20) / stdPerRun * 1e6);
+}
+
+} // namespace
+
+int main() {
+    benchMatchExact(".*ERROR", [](const size_t size) {
+        return makeLine(size) + "ERROR";
+    }, 50);
+    benchMatchExact(".*ERROR.*", [](const size_t size) {
+        return makeLine(size / 2) + "ERROR" + makeLine(size / 2);
+    }, 50);
+    benchMatchExact(R"("[^"]*")", [](const size_t size) {
+        return "\"" + makeLine(size) + "\"";
+    }, 50);
+    return 0;
+}
@@ -0,0 +1,122 @@
+#include "Bench.h"
+
+#include <RE.h>
+#include <REApproxMatcher.h>
+
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using RE::Bench::doNotOptimize;
+using RE::Bench::measure;
+
+namespace {
+
+constexpr std::string_view LETTERS = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+const std::vector<std::string> IDENTIFIERS = {
+    "getUserName", "setUserName", "parseHeader", "readBuffer", "flushOutput", "openSocket", "closeSocket", "hashString",
+};
+
+/* The identifiers one edit away, as the alternation the approximate matching replaces */
+std::string variantsWithinOneEdit() {
+    std::set<std::string> variants;
+    for (const auto& word : IDENTIFIERS) {
+        for (size_t pos = 0u; pos <= word.size(); pos++) {
+            for (const auto c : LETTERS) {
+                variants.insert(word.substr(0u, pos) + c + word.substr(pos));
+                if (pos < word.size()) {
+                    variants.insert(word.substr(0u, pos) + c + word.substr(pos + 1u));
+                }
+            }
+            if (pos < word.size()) {
+                variants.insert(word.substr(0u, pos) + word.substr(pos + 1u));
+            }
+        }
+    }
+    std::string re;
+    for (const auto& variant : variants) {
+        re += (re.empty() ? "" : "|") + variant;
+    }
+    return re;
+}
+
+/* What users type: the identifiers with up to two random edits */
+std::vector<std::string> typed(const size_t count) {
+    std::mt19937 random(48u);
+    std::vector<std::string> words;
+    for (size_t i = 0u; i < count; i++) {
+        auto word = IDENTIFIERS[random() % IDENTIFIERS.size()];
+        for (auto numEdits = random() % 3u; numEdits > 0u; numEdits--) {
+            const auto pos = random() % word.size();
+            const auto c = LETTERS[random() % LETTERS.size()];
+            switch (random() % 3u) {
+            case 0u:
+                word.insert(word.begin() + pos, c);
+                break;
+            case 1u:
+                word[pos] = c;
+                break;
+            default:
+                word.erase(pos, 1u);
+            }
+        }
+        words.push_back(std::move(word));
+    }
+    return words;
+}
+
+std::string alternation() {
+    std::string re;
+    for (const auto& word : IDENTIFIERS) {
+        re += (re.empty() ? "" : "|") + word;
+    }
+    return "(" + re + ")";
+}
+
+template <typename Matcher>
+void benchMatch(const std::string& name, const Matcher& matcher, const std::vector<std::string>& words) {
+    size_t numBytes = 0u;
+    for (const auto& word : words) {
+        numBytes += word.size();
+    }
+    size_t numMatched = 0u;
+    const auto us = measure(name, 10, [&] {
+        numMatched = 0u;
+        for (const auto& word : words) {
+            numMatched += matcher.matchExact(word);
+        }
+        doNotOptimize(numMatched);
+    });
+    std::printf("  %.1f ns per byte, %zu of %zu matched\n", us * 1e3 / numBytes, numMatched, words.size());
+}
+
+} // namespace
+
+/**
+ * Typed identifiers matched against a list of identifiers with typos
+ * tolerated: the variants within one edit spelled out as an alternation
+ * and compiled into a DFA, against the bit-parallel simulation for up to
+ * three edits
+ */
+int main() {
+    const auto words = typed(10000u);
+
+    const auto variants = variantsWithinOneEdit();
+    std::unique_ptr<RE::REParser> parser;
+    measure("compile the variants within 1 edit", 1, [&] { parser = std::make_unique<RE::REParser>(variants); });
+    std::printf("  %zu bytes of pattern, table %zu bytes\n", variants.size(), parser->tableSize());
+    benchMatch("match the variants, DFA", *parser, words);
+
+    for (const auto maxEdits : {0u, 1u, 2u, 3u}) {
+        std::unique_ptr<RE::REApproxMatcher> matcher;
+        const auto k = std::to_string(maxEdits);
+        measure("compile, within " + k + " edits", 1, [&] {
+            matcher = std::make_unique<RE::REApproxMatcher>(alternation(), maxEdits);
+        });
+        benchMatch("match, bit-parallel within " + k + " edits", *matcher, words);
+    }
+    return 0;
+}
@@ -0,0 +1,114 @@
+#include "HeapCounter.h"
+
+#include <RE.h>
+
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace HeapCounter = RE::Bench::HeapCounter;
+
+namespace {
+
+constexpr size_t REPEATS = 5u;
+
+/* Compiles the pattern with the temporaries from the resource, which is released right after */
+using Compile_t = std::function<std::unique_ptr<RE::REParser>(const std::string&, uint32_t)>;
+
+/**
+ * The blocks the compilation allocates from the global heap, its peak, and
+ * its time: the temporaries of the compilation in the arena are allocated
+ * a chunk at a time and freed at once, at the cost of a higher peak as
+ * nothing is freed before the end.
+ */
+void benchResource(const char* name, const std::string& re, const uint32_t flags, const Compile_t& compile) {
+    size_t numAllocations = 0u;
+    size_t peak = 0u;
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0u; i < REPEATS; i++) {
+        numAllocations = HeapCounter::allocations([&] {
+            peak = HeapCounter::peakBytes([&] { compile(re, flags); });
+        });
+    }
+    const std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    std::printf("  %-28s %10zu allocations %8zu KB peak %12.0f us\n", name, numAllocations, peak >> 10u,
+                elapsed.count() / REPEATS);
+}
+
+std::vector<std::pair<const char*, Compile_t>> compilers() {
+    return {
+        {"global heap", [](const std::string& re, const uint32_t flags) {
+            return std::make_unique<RE::REParser>(re, flags);
+        }},
+        {"monotonic_buffer_resource", [](const std::string& re, const uint32_t flags) {
+            std::pmr::monotonic_buffer_resource arena;
+            return std::make_unique<RE::REParser>(re, flags, &arena);
+        }},
+        {"unsynchronized_pool_resource", [](const std::string& re, const uint32_t flags) {
+            std::pmr::unsynchronized_pool_resource pool;
+            return std::make_unique<RE::REParser>(re, flags, &pool);
+        }},
+        {"synchronized_pool_resource", [](const std::string& re, const uint32_t flags) {
+            std::pmr::synchronized_pool_resource pool;
+            return std::make_unique<RE::REParser>(re, flags, &pool);
+        }},
+    };
+}
+
+void benchPattern(const char* name, const std::string& re, const uint32_t flags = RE::REParser::NONE) {
+    std::printf("%s\n", name);
+    for (const auto& [resource, compile] : compilers()) {
+        benchResource(resource, re, flags, compile);
+    }
+}
+
+double microseconds(const std::function<void()>& run) {
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0u; i < REPEATS; i++) {
+        run();
+    }
+    const std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / REPEATS;
+}
+
+/**
+ * The speedup of the parallel subset construction with each resource: the
+ * workers take their temporaries from pools of their own, and only lock a
+ * resource which is not thread-safe for the states they add, so each one
+ * should scale about as the global heap does. The minimization, which is
+ * sequential, bounds the speedup.
+ */
+void benchParallelScaling(const char* name, const std::string& re) {
+    std::printf("%s, sequential and parallel, %u hardware threads\n", name, std::thread::hardware_concurrency());
+    for (const auto& [resource, compile] : compilers()) {
+        const auto sequential = microseconds([&] { compile(re, RE::REParser::NONE); });
+        const auto parallel = microseconds([&] { compile(re, RE::REParser::PARALLEL_DETERMINIZATION); });
+        std::printf("  %-28s %12.0f us %12.0f us %6.2fx\n", resource, sequential, parallel, sequential / parallel);
+    }
+}
+
+} // namespace
+
+/**
+ * The compilation with its NFA, subsets and minimization allocated from
+ * the global heap, from an arena, and from a pool. What remains with the
+ * arena is allocated by the AST and by the DFA kept by the parser.
+ */
+int main() {
+    benchPattern("(a|b)*a(a|b){10}", "(a|b)*a(a|b){10}");
+    benchPattern("(a|b)*a(a|b){10}, parallel", "(a|b)*a(a|b){10}", RE::REParser::PARALLEL_DETERMINIZATION);
+    benchPattern("e-mail", "[a-zA-Z_][a-zA-Z_0-9]*@[a-z]+\\.(com|org|net)");
+    std::string literals;
+    for (size_t i = 0u; i < 500u; i++) {
+        literals += (i == 0u ? "" : "|") + std::string("[a-z]+") + std::to_string(i * 7919u % 100003u);
+    }
+    benchPattern("500 alternatives", "(" + literals + ")");
+    benchParallelScaling("(a|b)*a(a|b){11}", "(a|b)*a(a|b){11}");
+    return 0;
+}
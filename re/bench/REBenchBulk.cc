@@ -0,0 +1,57 @@
+#include "Bench.h"
+
+#include <RE.h>
+#include <REBulkCompile.h>
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using RE::Bench::doNotOptimize;
+using RE::Bench::measure;
+
+namespace {
+
+/* Patterns of a rule set, a few of them much costlier than the others */
+std::vector<std::string> makePatterns(const size_t numPatterns) {
+    std::vector<std::string> patterns;
+    for (size_t i = 0u; i < numPatterns; i++) {
+        const auto id = std::to_string(i * 7919u % 100003u);
+        switch (i % 4u) {
+        case 0u: patterns.push_back("GET /api/v" + id + "/[a-z]+(/[0-9]+)?"); break;
+        case 1u: patterns.push_back("user" + id + "@[a-z0-9.]+\\.(com|org|net)"); break;
+        case 2u: patterns.push_back("(error|warn|fatal)[ :]+code=" + id + " [a-z ]*"); break;
+        default: patterns.push_back(i % 64u == 3u ? "[a-z]*" + id + "[a-z]{8}" : "id-" + id + "-[0-9a-f]{8}"); break;
+        }
+    }
+    return patterns;
+}
+
+} // namespace
+
+int main() {
+    std::printf("%u hardware threads\n", std::thread::hardware_concurrency());
+    const auto patterns = makePatterns(10000u);
+    const std::vector<std::string_view> views(patterns.begin(), patterns.end());
+    std::printf("%zu patterns\n", patterns.size());
+
+    measure("REParser constructor, one after another", 1, [&] {
+        std::vector<std::unique_ptr<RE::REParser>> parsers;
+        for (const auto pattern : views) {
+            parsers.push_back(std::make_unique<RE::REParser>(pattern));
+        }
+        doNotOptimize(parsers);
+    });
+    for (const auto numThreads : {1u, 2u, 4u, 0u}) {
+        RE::BulkCompilation compilation;
+        const auto name = "compileAll, " + (numThreads == 0u ? std::string("a thread per core") :
+                                            std::to_string(numThreads) + " threads");
+        measure(name, 1, [&] {
+            compilation = RE::compileAll(views, RE::REParser::NONE, numThreads);
+        });
+        std::printf("  %zu threads, wall %.0f us, summed over the patterns %.0f us, %zu errors\n", compilation.numThreads,
+                    compilation.wallMicroseconds, compilation.summedMicroseconds, compilation.numErrors);
+    }
+    return 0;
+}
@@ -0,0 +1,56 @@
+#include "Bench.h"
+
+#include <RE.h>
+
+#include <regex>
+#include <string>
+#include <vector>
+
+using RE::Bench::doNotOptimize;
+using RE::Bench::measure;
+
+namespace {
+
+void benchCapture(const char* re, const std::vector<std::string>& inputs,
+                  const size_t repeats) {
+    std::printf("%s\n", re);
+    RE::REParser parser(re);
+    RE::REParser::Groups_t groups;
+    measure("  REParser::matchExact with groups", repeats, [&] {
+        for (const auto& input : inputs) {
+            doNotOptimize(parser.matchExact(input, groups));
+        }
+    });
+
+    const std::regex stdRegex(re);
+    std::smatch match;
+    measure("  std::regex_match with std::smatch", repeats, [&] {
+        for (const auto& input : inputs) {
+            doNotOptimize(std::regex_match(input, match, stdRegex));
+        }
+    });
+}
+
+} // namespace
+
+int main() {
+    std::vector<std::string> dates;
+    for (auto i = 0; i < 1000; i++) {
+        dates.push_back(std::to_string(1900 + i) + "-" + std::to_string(i % 12 + 1) +
+                        "-" + std::to_string(i % 28 + 1));
+    }
+    benchCapture(R"((\d+)-(\d+)-(\d+))", dates, 100);
+
+    std::vector<std::string> keyValues;
+    for (auto i = 0; i < 1000; i++) {
+        keyValues.push_back(std::string(i % 16 + 1, 'k') + "=" + std::string(i % 32 + 1, 'v'));
+    }
+    benchCapture("(k+)=(v*)", keyValues, 100);
+
+    std::vector<std::string> repeats;
+    for (auto i = 0; i < 100; i++) {
+        repeats.push_back(std::string(200 + i, 'a'));
+    }
+    benchCapture("(a*)(a*)(a)", repeats, 20);
+    return 0;
+}
@@ -0,0 +1,89 @@
+#include "Bench.h"
+#include "HeapCounter.h"
+
+#include <RECompileProfile.h>
+
+#include <array>
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace HeapCounter = RE::Bench::HeapCounter;
+using RE::CompileProfile;
+
+namespace {
+
+/**
+ * A row per n: the time and the peak of the heap of each phase, the peak
+ * counting what the earlier phases left alive, and the number of states.
+ * An asymptotic regression shows as a column growing faster than before.
+ */
+void benchFamily(const char* name, const std::vector<size_t>& ns,
+                 const std::function<std::string(size_t)>& patternOf, const uint32_t flags = RE::REParser::NONE) {
+    std::printf("%s\n", name);
+    std::printf("%6s %10s %10s %10s %10s   %8s %8s %8s   %8s %8s %8s %8s\n", "n", "parse us", "NFA us",
+                "subsets us", "minim. us", "NFA", "DFA", "minimal", "parse KB", "NFA KB", "subs. KB", "minim. KB");
+    for (const auto n : ns) {
+        std::array<size_t, CompileProfile::NUM_PHASES> peaks{};
+        const auto base = HeapCounter::current.load();
+        HeapCounter::peak = base;
+        const auto profile = RE::profileCompile(patternOf(n), flags, [&](const CompileProfile::Phase phase) {
+            peaks[phase] = HeapCounter::peak - base;
+            HeapCounter::peak = HeapCounter::current.load();
+        });
+        const auto& us = profile.microseconds;
+        std::printf("%6zu %10.0f %10.0f %10.0f %10.0f   %8zu %8zu %8zu   %8zu %8zu %8zu %8zu\n", n,
+                    us[CompileProfile::PARSE], us[CompileProfile::NFA], us[CompileProfile::SUBSETS],
+                    us[CompileProfile::MINIMIZATION], profile.numNFAStates, profile.numDFAStates,
+                    profile.numMinimizedStates, peaks[CompileProfile::PARSE] >> 10u, peaks[CompileProfile::NFA] >> 10u,
+                    peaks[CompileProfile::SUBSETS] >> 10u, peaks[CompileProfile::MINIMIZATION] >> 10u);
+    }
+}
+
+std::string repeat(const std::string& re, const size_t n) {
+    return "(" + re + "){" + std::to_string(n) + "}";
+}
+
+} // namespace
+
+/* The scaling of REParser construction on families of pathological patterns */
+int main() {
+    // the DFA needs 2^(n+1) states to remember the last n+1 bytes
+    benchFamily("(a|b)*a(a|b){n}", {1u, 2u, 4u, 6u, 8u, 9u, 10u}, [](const size_t n) {
+        return "(a|b)*a" + repeat("a|b", n);
+    });
+    benchFamily("n literals", {64u, 256u, 1024u, 4096u, 16384u, 65536u}, [](const size_t n) {
+        std::string re;
+        for (size_t i = 0u; i < n; i++) {
+            re += (i == 0u ? "" : "|") + std::string("word") + std::to_string(i * 7919u % 100003u);
+        }
+        return re;
+    });
+    // unlike the numbered words, whose digits make few classes and share most suffixes
+    benchFamily("n random lowercase words", {10000u, 50000u, 100000u, 200000u}, [](const size_t n) {
+        std::mt19937 random(46u);
+        std::string re;
+        for (size_t i = 0u; i < n; i++) {
+            re += i == 0u ? "" : "|";
+            for (auto length = 5u + random() % 8u; length > 0u; length--) {
+                re += static_cast<char>('a' + random() % 26u);
+            }
+        }
+        return re;
+    });
+    benchFamily("((a{n}){n}){n}", {2u, 4u, 6u, 8u, 10u}, [](const size_t n) {
+        return repeat(repeat(repeat("a", n), n), n);
+    });
+    benchFamily("UTF-8 class of n ranges", {16u, 64u, 256u, 1024u}, [](const size_t n) {
+        std::string re = "[";
+        for (size_t i = 0u; i < n; i++) {
+            char range[32];
+            std::snprintf(range, sizeof(range), "\\u%04zx-\\u%04zx", 0x100u + i * 48u, 0x100u + i * 48u + 31u);
+            re += range;
+        }
+        return re + "]+x";
+    }, RE::REParser::UTF8);
+    return 0;
+}
@@ -0,0 +1,47 @@
+#include "Bench.h"
+#include "HeapCounter.h"
+
+#include <RE.h>
+
+#include <memory>
+#include <string>
+
+using RE::Bench::HeapCounter::peakBytes;
+using RE::Bench::doNotOptimize;
+using RE::Bench::measure;
+
+namespace {
+
+void benchCompile(const std::string& name, const std::string& re, const uint32_t flags = RE::REParser::NONE) {
+    std::printf("%s\n", name.c_str());
+    for (const auto& [path, pathFlags] : {std::make_pair("  Thompson NFA, subsets, minimizer", flags),
+                                         std::make_pair("  derivatives", flags | RE::REParser::DERIVATIVES)}) {
+        std::unique_ptr<RE::REParser> parser;
+        size_t peak = 0u;
+        measure(path, 1, [&] {
+            peak = peakBytes([&] { parser = std::make_unique<RE::REParser>(re, pathFlags); });
+        });
+        doNotOptimize(parser);
+        std::printf("  peak heap %zu KB, table %zu bytes\n", peak >> 10u, parser->tableSize());
+    }
+}
+
+std::string literals(const size_t count) {
+    std::string re;
+    for (size_t i = 0u; i < count; i++) {
+        re += (i == 0u ? "" : "|") + std::string("word") + std::to_string(i * 7919 % 100003);
+    }
+    return re;
+}
+
+} // namespace
+
+/* The cost of building the DFA of a pattern, by each of the two paths */
+int main() {
+    benchCompile("(a|b)*a(a|b){12}", "(a|b)*a(a|b){12}");
+    benchCompile("1000 literals", literals(1000u));
+    benchCompile("(((a{4}){4}){4})*", "(((a{4}){4}){4})*");
+    benchCompile("[a-zA-Z_][a-zA-Z_0-9]*@[a-z]+\\.(com|org|net)", "[a-zA-Z_][a-zA-Z_0-9]*@[a-z]+\\.(com|org|net)");
+    benchCompile("UTF-8 \\w+[α-ω]+.{3}", "\\w+[α-ω]+.{3}", RE::REParser::UTF8);
+    return 0;
+}
@@ -0,0 +1,71 @@
+#include "Bench.h"
+
+#include <RE.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+using RE::Bench::doNotOptimize;
+using RE::Bench::measure;
+
+namespace {
+
+/* A blocklist growing by a few entries: each one added or the list rebuilt, as patterns without groups */
+void benchGrowth(const char* name, const std::vector<std::string>& entries, const std::vector<std::string>& added) {
+    std::printf("%s, %zu entries + %zu\n", name, entries.size(), added.size());
+    std::string re;
+    for (const auto& entry : entries) {
+        re += (re.empty() ? "" : "|") + entry;
+    }
+    RE::REParser parser(re);
+    // the first one makes the dense table again, which the next ones are added to
+    measure("  REParser::addAlternative, first entry", 1, [&] { parser.addAlternative(added.front()); });
+    const auto perAddition = measure("  REParser::addAlternative, next entries", 1, [&] {
+        for (size_t i = 1u; i < added.size(); i++) {
+            parser.addAlternative(added[i]);
+        }
+    }) / (added.size() - 1u);
+    std::printf("  %.0f us per next entry, table %zu bytes\n", perAddition, parser.tableSize());
+
+    const auto perRebuild = measure("  REParser rebuilt", 1, [&] {
+        auto rebuilt = re;
+        for (const auto& entry : added) {
+            rebuilt += "|" + entry;
+            RE::REParser fresh(rebuilt);
+            doNotOptimize(fresh);
+        }
+    }) / added.size();
+    std::printf("  %.0f us per entry, %.0fx\n", perRebuild, perRebuild / perAddition);
+}
+
+} // namespace
+
+int main() {
+    std::vector<std::string> hosts, newHosts;
+    for (auto i = 0; i < 20000; i++) {
+        (i < 19990 ? hosts : newHosts).push_back("host" + std::to_string(i * 7919 % 1000003) + "\\.example\\.com");
+    }
+    benchGrowth("literals", hosts, newHosts);
+
+    // without the long prefixes shared by the hosts, each entry goes through states all over the DFA
+    for (const auto numWords : {3000u, 30000u}) {
+        std::mt19937 random(47u);
+        std::vector<std::string> words, newWords;
+        for (size_t i = 0u; i < numWords; i++) {
+            std::string word;
+            for (auto length = 5u + random() % 8u; length > 0u; length--) {
+                word += static_cast<char>('a' + random() % 26u);
+            }
+            (i < numWords - 10u ? words : newWords).push_back(word);
+        }
+        benchGrowth("random lowercase words", words, newWords);
+    }
+
+    std::vector<std::string> rules, newRules;
+    for (auto i = 0; i < 500; i++) {
+        (i < 490 ? rules : newRules).push_back("user" + std::to_string(i * 7919 % 100003) + "@[a-z0-9.]+\\.[a-z]{3}");
+    }
+    benchGrowth("rules with classes", rules, newRules);
+    return 0;
+}
@@ -0,0 +1,48 @@
+#include "Bench.h"
+
+#include <RE.h>
+
+#include <regex>
+#include <string>
+
+using RE::Bench::doNotOptimize;
+using RE::Bench::measure;
+
+namespace {
+
+/* Log lines without a match but for the last one */
+std::string makeLog(const std::string& lastLine) {
+    std::string log;
+    for (auto i = 0; i < 2000; i++) {
+        log += "2024-01-" + std::to_string(i % 28 + 1) + " INFO worker-" + std::to_string(i % 7) +
+               " handled request " + std::to_string(i * 7919 % 100000) + " for user" +
+               std::to_string(i % 113) + "\n";
+    }
+    return log + lastLine + "\n";
+}
+
+void benchFind(const char* re, const std::string& log, const size_t repeats) {
+    std::printf("%s\n", re);
+    RE::REParser parser(re);
+    measure("  REParser::find", repeats, [&] {
+        doNotOptimize(parser.find(log));
+    });
+
+    const std::regex stdRegex(re);
+    std::smatch match;
+    measure("  std::regex_search", repeats, [&] {
+        doNotOptimize(std::regex_search(log, match, stdRegex));
+    });
+}
+
+} // namespace
+
+int main() {
+    const auto log = makeLog("2024-02-01 ERROR worker-3 took 1234ms for user@example.com");
+    benchFind(R"(ERROR worker-\d)", log, 20);  // prefix
+    benchFind(R"(\d+ms)", log, 20);  // reverse suffix
+    benchFind(R"([a-z]+@example\.com)", log, 20);  // reverse suffix
+    benchFind(R"(\w+ took \d+)", log, 20);  // reverse inner
+    benchFind(R"([A-Z]+ worker-3 t)", log, 20);  // no literal
+    return 0;
+}
@@ -0,0 +1,55 @@
+#include "Bench.h"
+
+#include <RE.h>
+
+#include <regex>
+#include <string>
+
+using RE::Bench::doNotOptimize;
+using RE::Bench::measure;
+
+namespace {
+
+/* About 4 MB of key-value pairs, every word and number being a match */
+std::string makeBuffer() {
+    std::string buffer;
+    for (auto i = 0; buffer.size() < (4u << 20); i++) {
+        buffer += "user" + std::to_string(i % 1000) + "=" + std::to_string(i * 7919 % 100000) +
+                  (i % 10 == 9 ? " mail=u" + std::to_string(i) + "@example.com\n" : " ");
+    }
+    return buffer;
+}
+
+void benchFindAll(const char* re, const std::string& buffer, const size_t repeats) {
+    std::printf("%s\n", re);
+    const auto megabytes = buffer.size() / double(1u << 20);
+    RE::REParser parser(re);
+    size_t numMatches = 0u;
+    const auto perRun = measure("  REParser::findAll", repeats, [&] {
+        numMatches = 0u;
+        for (const auto match : parser.findAll(buffer)) {
+            doNotOptimize(match);
+            numMatches++;
+        }
+    });
+    std::printf("  %zu matches, %.1f MB/s\n", numMatches, megabytes / perRun * 1e6);
+
+    const std::regex stdRegex(re);
+    const auto stdPerRun = measure("  std::sregex_iterator", 1u, [&] {
+        for (auto it = std::sregex_iterator(buffer.begin(), buffer.end(), stdRegex);
+             it != std::sregex_iterator(); ++it) {
+            doNotOptimize(it->position());
+        }
+    });
+    std::printf("  %.1f MB/s\n", megabytes / stdPerRun * 1e6);
+}
+
+} // namespace
+
+int main() {
+    const auto buffer = makeBuffer();
+    benchFindAll(R"(\d+)", buffer, 5);
+    benchFindAll(R"([a-z]+\d+=\d+)", buffer, 5);
+    benchFindAll(R"(\w+@example\.com)", buffer, 5);
+    return 0;
+}
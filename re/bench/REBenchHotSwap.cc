@@ -0,0 +1,122 @@
+#include "Bench.h"
+
+#include <RE.h>
+#include <REHotSwap.h>
+
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using RE::Bench::doNotOptimize;
+
+namespace {
+
+constexpr size_t NUM_READERS = 4u;
+constexpr size_t MATCHES_PER_READER = 2000000u;
+constexpr auto RELOAD_PERIOD = std::chrono::milliseconds(1);
+
+/* A rule set, of which the version changes one rule */
+std::string ruleSet(const size_t version) {
+    std::string re = "(GET|POST) /v" + std::to_string(version) + "/[a-z]+";
+    for (size_t i = 0u; i < 40u; i++) {
+        re += "|(error|warn) code=" + std::to_string(i * 7919u % 100003u) + " [a-z ]*";
+    }
+    return re;
+}
+
+std::vector<std::string> makeLines() {
+    std::vector<std::string> lines;
+    for (size_t i = 0u; i < 64u; i++) {
+        lines.push_back(i % 3u == 0u ? "GET /v0/users" :
+                        i % 3u == 1u ? "warn code=" + std::to_string(i * 7919u % 100003u) + " disk almost full" :
+                                       "info code=" + std::to_string(i) + " nothing to see");
+    }
+    return lines;
+}
+
+/* The CPU time of the calling thread, which the other threads sharing its core do not count in */
+double threadMicroseconds() {
+    timespec time;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+    return time.tv_sec * 1e6 + time.tv_nsec * 1e-3;
+}
+
+using Match_t = std::function<bool(const std::string&)>;
+using Reload_t = std::function<void(size_t version)>;
+
+/**
+ * The CPU time per match of the readers, while the writer compiles and
+ * publishes a new version of the rule set every RELOAD_PERIOD, if any
+ */
+void bench(const char* name, const std::vector<std::string>& lines, const Match_t& match,
+           const Reload_t& reload = nullptr) {
+    std::atomic<size_t> numReadersLeft{NUM_READERS};
+    std::atomic<double> readerMicroseconds{0.0};
+    std::vector<std::thread> readers;
+    for (size_t reader = 0u; reader < NUM_READERS; reader++) {
+        readers.emplace_back([&] {
+            const auto start = threadMicroseconds();
+            size_t numMatched = 0u;
+            for (size_t i = 0u; i < MATCHES_PER_READER; i++) {
+                numMatched += match(lines[i % lines.size()]);
+            }
+            doNotOptimize(numMatched);
+            const auto us = threadMicroseconds() - start;
+            for (auto sum = readerMicroseconds.load(); not readerMicroseconds.compare_exchange_weak(sum, sum + us);) {}
+            numReadersLeft--;
+        });
+    }
+    size_t numReloads = 0u;
+    while (reload and numReadersLeft.load() != 0u) {
+        reload(++numReloads);
+        std::this_thread::sleep_for(RELOAD_PERIOD);
+    }
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    std::printf("%-56s %8.1f ns per match, %zu reloads\n", name,
+                readerMicroseconds.load() * 1e3 / (NUM_READERS * MATCHES_PER_READER), numReloads);
+}
+
+} // namespace
+
+/**
+ * Readers matching lines against a rule set reloaded under them: the
+ * parser itself, the hot-swapped handle with and without reloads, and a
+ * shared_ptr behind a reader-writer lock as the usual alternative
+ */
+int main() {
+    std::printf("%u hardware threads, %zu readers\n", std::thread::hardware_concurrency(), NUM_READERS);
+    const auto lines = makeLines();
+
+    const RE::REParser parser(ruleSet(0u));
+    bench("REParser, never reloaded", lines, [&](const std::string& line) { return parser.matchExact(line); });
+
+    RE::REHotSwap handle(std::make_unique<RE::REParser>(ruleSet(0u)));
+    const auto matchHandle = [&](const std::string& line) { return handle.matchExact(line); };
+    bench("REHotSwap, no reloads", lines, matchHandle);
+    bench("REHotSwap, reloaded", lines, matchHandle, [&](const size_t version) {
+        handle.publish(std::make_unique<RE::REParser>(ruleSet(version)));
+    });
+
+    std::shared_mutex mutex;
+    auto shared = std::make_shared<const RE::REParser>(ruleSet(0u));
+    bench("shared_ptr under a shared_mutex, reloaded", lines, [&](const std::string& line) {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        const auto current = shared;
+        lock.unlock();
+        return current->matchExact(line);
+    }, [&](const size_t version) {
+        auto parser = std::make_shared<const RE::REParser>(ruleSet(version));
+        const std::lock_guard<std::shared_mutex> lock(mutex);
+        shared = std::move(parser);
+    });
+    return 0;
+}
@@ -0,0 +1,83 @@
+#include "Bench.h"
+
+#include <RE.h>
+#include <RELexer.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+using RE::Bench::doNotOptimize;
+using RE::Bench::measure;
+
+namespace {
+
+const std::vector<std::string_view> RULES = {
+    "select|from|where|and|or|not|limit",
+    "[a-z_][a-z_0-9]*",
+    "[0-9]+(\\.[0-9]+)?",
+    "'[^']*'",
+    "==|!=|<=|>=|<|>|=|\\(|\\)|,|\\*",
+    "[ \\n]+",
+};
+
+/* About 1 MB of queries */
+std::string makeQueries() {
+    std::string queries;
+    for (auto i = 0; queries.size() < (1u << 20); i++) {
+        queries += "select name, count_" + std::to_string(i % 97) + " from table_" + std::to_string(i % 13) +
+                   " where id >= " + std::to_string(i * 7919 % 100000) + " and name != 'user " +
+                   std::to_string(i % 1000) + "' limit 10\n";
+    }
+    return queries;
+}
+
+/**
+ * The hand-rolled way: the longest prefix matched by each rule in turn, up
+ * to the length of the longest token
+ */
+size_t scanByPrefixes(const std::vector<std::unique_ptr<RE::REParser>>& parsers, std::string_view str, const size_t maxLength) {
+    size_t numTokens = 0u;
+    for (size_t pos = 0u; pos < str.size(); numTokens++) {
+        size_t longest = 1u;
+        for (const auto& parser : parsers) {
+            for (auto length = std::min(maxLength, str.size() - pos); length > longest; length--) {
+                if (parser->matchExact(str.substr(pos, length))) {
+                    longest = length;
+                    break;
+                }
+            }
+        }
+        pos += longest;
+    }
+    return numTokens;
+}
+
+} // namespace
+
+int main() {
+    const auto queries = makeQueries();
+    const auto megabytes = queries.size() / double(1u << 20);
+
+    RE::RELexer lexer(RULES);
+    size_t numTokens = 0u;
+    const auto perRun = measure("RELexer::tokenize", 10, [&] {
+        numTokens = 0u;
+        for (const auto token : lexer.tokenize(queries)) {
+            doNotOptimize(token);
+            numTokens++;
+        }
+    });
+    std::printf("  %zu tokens, %.1f MB/s\n", numTokens, megabytes / perRun * 1e6);
+
+    std::vector<std::unique_ptr<RE::REParser>> parsers;
+    for (const auto rule : RULES) {
+        parsers.push_back(std::make_unique<RE::REParser>(rule));
+    }
+    const auto sample = std::string_view(queries).substr(0u, 64u << 10);
+    const auto prefixesPerRun = measure("REParser::matchExact on prefixes, 64 KB", 1, [&] {
+        doNotOptimize(scanByPrefixes(parsers, sample, 32u));
+    });
+    std::printf("  %.1f MB/s\n", sample.size() / double(1u << 20) / prefixesPerRun * 1e6);
+    return 0;
+}
@@ -0,0 +1,68 @@
+#include "Bench.h"
+
+#include <RE.h>
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using RE::Bench::doNotOptimize;
+using RE::Bench::measure;
+
+namespace {
+
+/* The resident set size of the process, from /proc on Linux, 0 elsewhere */
+size_t residentBytes() {
+    std::ifstream statm("/proc/self/statm");
+    size_t size = 0u, resident = 0u;
+    statm >> size >> resident;
+    return resident * 4096u;
+}
+
+void benchMemory(const char* name, const std::vector<std::string>& patterns) {
+    std::printf("%s\n", name);
+    std::vector<std::unique_ptr<RE::REParser>> parsers;
+    const auto rssBefore = residentBytes();
+    measure("  compile", 1, [&] {
+        for (const auto& pattern : patterns) {
+            parsers.push_back(std::make_unique<RE::REParser>(pattern));
+        }
+    });
+    const auto rssAfter = residentBytes();
+    size_t memoryUsage = 0u;
+    for (const auto& parser : parsers) {
+        memoryUsage += parser->memoryUsage();
+    }
+    doNotOptimize(parsers);
+    std::printf("  %zu patterns, memoryUsage %zu bytes per pattern, resident %zu bytes per pattern\n",
+                patterns.size(), memoryUsage / patterns.size(), (rssAfter - rssBefore) / patterns.size());
+}
+
+} // namespace
+
+int main() {
+    std::vector<std::string> rules;
+    for (auto i = 0; i < 2000; i++) {
+        const auto id = std::to_string(i * 7919 % 100003);
+        rules.push_back(i % 2 ? "user" + id + "@[a-z0-9.]+\\.(com|org|net)" : "(error|warn) code=" + id + " [a-z ]*");
+    }
+    benchMemory("2000 small rules", rules);
+
+    std::vector<std::string> captures;
+    for (auto i = 0; i < 2000; i++) {
+        captures.push_back("id-" + std::to_string(i) + "-([0-9a-f]{8})-(\\w+)");
+    }
+    benchMemory("2000 rules with captures", captures);
+
+    std::vector<std::string> alternations;
+    for (auto i = 0; i < 20; i++) {
+        std::string re;
+        for (auto j = 0; j < 200; j++) {
+            re += (j ? "|" : "") + std::string("kw") + std::to_string(i * 7919 + j * 104729);
+        }
+        alternations.push_back(re);
+    }
+    benchMemory("20 alternations of 200 keywords", alternations);
+    return 0;
+}
@@ -0,0 +1,38 @@
+#include "Bench.h"
+
+#include <RE.h>
+
+#include <string>
+#include <thread>
+
+using RE::Bench::doNotOptimize;
+using RE::Bench::measure;
+
+namespace {
+
+void benchCompile(const std::string& re, const size_t repeats) {
+    std::printf("%.60s%s\n", re.c_str(), re.size() > 60u ? "..." : "");
+    measure("  sequential subset construction", repeats, [&] {
+        RE::REParser parser(re);
+        doNotOptimize(parser);
+    });
+    measure("  parallel subset construction", repeats, [&] {
+        RE::REParser parser(re, RE::REParser::PARALLEL_DETERMINIZATION);
+        doNotOptimize(parser);
+    });
+}
+
+} // namespace
+
+int main() {
+    std::printf("%u hardware threads\n", std::thread::hardware_concurrency());
+    benchCompile("(a|b)*a(a|b){9}", 5);
+    benchCompile("[a-z]*(x|y)[a-z]{6}", 5);
+
+    std::string rules;
+    for (auto i = 0; i < 50; i++) {
+        rules += (i ? "|" : "") + std::string("rule") + std::to_string(i * 7919 % 10007) + "[a-z]+";
+    }
+    benchCompile(".*(" + rules + ")", 5);
+    return 0;
+}
@@ -0,0 +1,41 @@
+#include "Bench.h"
+
+#include <RE.h>
+
+#include <string>
+
+using RE::Bench::doNotOptimize;
+using RE::Bench::measure;
+
+namespace {
+
+/* About 16 MB built by repeating the unit */
+std::string repeat(const std::string& unit) {
+    std::string text;
+    while (text.size() < (16u << 20)) {
+        text += unit;
+    }
+    return text;
+}
+
+void benchMatchExact(const char* re, const std::string& text) {
+    std::printf("%s\n", re);
+    RE::REParser parser(re);
+    bool isMatch = false;
+    const auto perRun = measure("  REParser::matchExact", 5, [&] {
+        isMatch = parser.matchExact(text);
+        doNotOptimize(isMatch);
+    });
+    std::printf("  %s, %.1f MB/s\n", isMatch ? "match" : "no match", text.size() / double(1u << 20) / perRun * 1e6);
+}
+
+} // namespace
+
+/* Validators of a few states, none of them looping on almost every byte */
+int main() {
+    benchMatchExact("[0-9a-f]*", repeat("0123456789abcdef"));
+    benchMatchExact("([a-z]+[0-9]+[ \\n])*", repeat("abc123 de4\nfghij56789 "));
+    benchMatchExact("([A-Za-z0-9+/]{4})*", repeat("QUJDREVGR0hJSktMTU5PUFFSU1RVVldYWVo+"
+                                                 "YWJjZGVmZ2hpamtsbW5vcHFyc3R1dnd4eXo/"));
+    return 0;
+}
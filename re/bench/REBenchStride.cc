@@ -0,0 +1,46 @@
+#include "Bench.h"
+
+#include <RE.h>
+
+#include <string>
+
+using RE::Bench::doNotOptimize;
+using RE::Bench::measure;
+
+namespace {
+
+/* Lines of 8 words and numbers, about 16 MB */
+std::string makeText() {
+    std::string text;
+    uint32_t seed = 12345u;
+    for (auto word = 1u; text.size() < (16u << 20); word++) {
+        seed = seed * 1103515245u + 12345u;
+        const auto length = 2u + (seed >> 16) % 9u;
+        for (auto i = 0u; i < length; i++) {
+            text += static_cast<char>('a' + (seed >> (i % 16u)) % 26u);
+        }
+        text += std::to_string(seed % 10007u) + (word % 8u == 0u ? "\n" : " ");
+    }
+    return text;
+}
+
+void benchMatchExact(const char* re, const std::string& text) {
+    std::printf("%s\n", re);
+    RE::REParser parser(re);
+    bool isMatch = false;
+    const auto perRun = measure("  REParser::matchExact", 5, [&] {
+        isMatch = parser.matchExact(text);
+        doNotOptimize(isMatch);
+    });
+    std::printf("  %s, %.1f MB/s\n", isMatch ? "match" : "no match", text.size() / double(1u << 20) / perRun * 1e6);
+}
+
+} // namespace
+
+int main() {
+    const auto text = makeText();
+    // 4 byte classes, and too many states for the shuffle engine
+    benchMatchExact("(([a-z]+[0-9]+ ){7}[a-z]+[0-9]+\\n)*", text);
+    benchMatchExact("(([a-z]+[0-9]+ ){7}[a-z]+[0-9]+\\n)*([a-z]+[0-9]+ )*", text);
+    return 0;
+}
@@ -0,0 +1,89 @@
+#include "Bench.h"
+
+#include <RE.h>
+#include <RECompileProfile.h>
+
+#include <string>
+#include <vector>
+
+using RE::Bench::doNotOptimize;
+using RE::Bench::measure;
+
+namespace {
+
+std::vector<std::string> makeWords(const size_t numWords) {
+    std::vector<std::string> words;
+    uint32_t seed = 12345u;
+    for (size_t i = 0u; i < numWords; i++) {
+        std::string word;
+        for (auto length = 0; length < 8; length++) {
+            seed = seed * 1103515245u + 12345u;
+            word += static_cast<char>('a' + (seed >> 16) % 26);
+        }
+        words.push_back(word);
+    }
+    return words;
+}
+
+/* About 4 MB of words, one in 16 of them being a keyword */
+std::string makeText(const std::vector<std::string>& keywords) {
+    const auto others = makeWords(keywords.size() * 16u);
+    std::string text;
+    for (size_t i = 0u; text.size() < (4u << 20); i++) {
+        text += (i % 16u == 0u ? keywords[i / 16u % keywords.size()] : others[i % others.size()]) + " ";
+    }
+    return text;
+}
+
+void benchTable(const char* name, const std::string& re, const std::string& text) {
+    std::printf("%s\n", name);
+    RE::REParser parser(re);
+    std::printf("  table size %zu bytes\n", parser.tableSize());
+    const auto benchFindAll = [&](const std::string& layout) {
+        size_t numMatches = 0u;
+        const auto perRun = measure("  REParser::findAll, " + layout, 5, [&] {
+            numMatches = 0u;
+            for (const auto match : parser.findAll(text)) {
+                doNotOptimize(match);
+                numMatches++;
+            }
+        });
+        std::printf("  %zu matches, %.1f MB/s\n", numMatches, text.size() / double(1u << 20) / perRun * 1e6);
+    };
+    benchFindAll("breadth-first layout");
+    parser.optimizeLayout({std::string_view(text).substr(0u, 256u << 10)});
+    benchFindAll("layout trained on 256 KB");
+}
+
+/* Re-laying out the table of a large dictionary, whose rows are nearly all packed */
+void benchLayout(const size_t numWords) {
+    std::string re;
+    for (const auto& word : makeWords(numWords)) {
+        re += (re.empty() ? "" : "|") + word;
+    }
+    RE::REParser parser(re);
+    const auto numStates = RE::profileCompile(re).numMinimizedStates;
+    const auto name = "  optimizeLayout, " + std::to_string(numWords) + " words, " + std::to_string(numStates) +
+                      " states";
+    measure(name, 1, [&] { parser.optimizeLayout({re.substr(0u, 64u << 10)}); });
+    std::printf("  table size %zu bytes\n", parser.tableSize());
+}
+
+} // namespace
+
+int main() {
+    for (const auto numKeywords : {100u, 1000u, 5000u}) {
+        const auto keywords = makeWords(numKeywords);
+        std::string re;
+        for (const auto& keyword : keywords) {
+            re += (re.empty() ? "" : "|") + keyword;
+        }
+        const auto name = std::to_string(numKeywords) + " keywords";
+        benchTable(name.c_str(), re, makeText(keywords));
+    }
+    std::printf("layout of large tables\n");
+    for (const auto numWords : {5000u, 20000u, 50000u, 100000u}) {
+        benchLayout(numWords);
+    }
+    return 0;
+}
@@ -1,8 +1,12 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
+#include <iterator>
 #include <string_view>
 #include <memory>
+#include <memory_resource>
+#include <vector>
 
 namespace RE {
 
@@ -12,13 +16,155 @@ class REParser {
 public:
     using RE_t = const std::string_view&;
     using Str_t = const std::string_view&;
-    REParser(RE_t);
+    /**
+     * Spans of the capture groups into the matched string, group 0 being the
+     * whole match. A group that did not participate has a null data().
+     */
+    using Groups_t = std::vector<std::string_view>;
+
+    enum Flags : uint32_t {
+        NONE = 0u,
+        /* the pattern and the inputs are UTF-8, classes and '.' match codepoints */
+        UTF8 = 1u << 0,
+        /* letters match regardless of their case */
+        CASE_INSENSITIVE = 1u << 1,
+        /* the DFA states are expanded by a thread per core when compiling */
+        PARALLEL_DETERMINIZATION = 1u << 2,
+        /**
+         * the DFA is built from the pattern by derivatives, without an NFA
+         * nor the subset construction, then minimized on its table if not
+         * small; the scanners of RELexer ignore it
+         */
+        DERIVATIVES = 1u << 3,
+    };
+
+    /**
+     * Iterates over the non-overlapping matches of a string from left to
+     * right, each one being the leftmost-longest match after the previous
+     * one. The matches are spans into the string, which must outlive the
+     * iterator.
+     */
+    class MatchIterator {
+        friend class REParser;
+
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const std::string_view*;
+        using reference = const std::string_view&;
+
+        MatchIterator() = default;  // the end of the matches
+
+        reference operator*() const { return m_match; }
+        pointer operator->() const { return &m_match; }
+        MatchIterator& operator++();
+        MatchIterator operator++(int) {
+            auto it = *this;
+            ++*this;
+            return it;
+        }
+        bool operator==(const MatchIterator& other) const {
+            return m_parser == other.m_parser and m_match.data() == other.m_match.data();
+        }
+        bool operator!=(const MatchIterator& other) const { return not (*this == other); }
+
+    private:
+        MatchIterator(REParserImpl const* parser, std::string_view str) :
+            m_parser(parser), m_str(str)
+        {
+            ++*this;
+        }
+
+        REParserImpl const* m_parser = nullptr;
+        std::string_view m_str;
+        std::string_view m_match;
+        size_t m_next = 0u;  // where the search for the next match starts
+    };
+
+    class MatchRange {
+        friend class REParser;
+
+    public:
+        MatchIterator begin() const { return MatchIterator(m_parser, m_str); }
+        MatchIterator end() const { return MatchIterator(); }
+
+    private:
+        MatchRange(REParserImpl const* parser, std::string_view str) :
+            m_parser(parser), m_str(str) {}
+
+        REParserImpl const* m_parser;
+        std::string_view m_str;
+    };
+
+    REParser(RE_t, const uint32_t flags = NONE);
+    /**
+     * The structures built and freed while compiling, i.e. the parsing
+     * stack, the NFA, the subsets and the partitions of the minimization,
+     * are allocated from the resource, e.g. a monotonic_buffer_resource
+     * released in one step once the parser is built. The parser does not
+     * refer to the resource. With PARALLEL_DETERMINIZATION, the resource
+     * need not be thread-safe.
+     */
+    REParser(RE_t, const uint32_t flags, std::pmr::memory_resource* compileResource);
+    REParser(REParser&&) noexcept;
+    REParser& operator=(REParser&&) noexcept;
     ~REParser();
 
+    /**
+     * The patterns matching the strings matched by both patterns, by either
+     * of them and by the first but not the second, each built as a single
+     * minimized DFA. Their capture groups are dropped.
+     */
+    static REParser intersectionOf(const REParser&, const REParser&);
+    static REParser unionOf(const REParser&, const REParser&);
+    static REParser differenceOf(const REParser&, const REParser&);
+    /* The pattern of all the byte strings the pattern does not match, e.g. invalid UTF-8 */
+    static REParser complementOf(const REParser&);
+    /* Whether no string is matched, e.g. by a rule which can never fire */
+    bool isEmpty() const;
+    /* Whether all the strings matched are matched by the other pattern too */
+    bool isSubsetOf(const REParser&) const;
+
     bool matchExact(Str_t) const;
+    bool matchExact(Str_t, Groups_t&) const;
+    size_t numGroups() const;
+    /**
+     * The position of the leftmost match in the string, the longest one
+     * being reported if several start there, or -1 if there is none
+     */
     int32_t find(Str_t) const;
+    int32_t find(Str_t, std::string_view& match) const;
+    /* e.g. for (const auto match : parser.findAll(str)) */
+    MatchRange findAll(Str_t) const;
+    /* The bytes taken by the transition tables the matching runs on */
+    size_t tableSize() const;
+    /**
+     * Lay the transition table out for inputs like the ones of the corpus,
+     * the states most visited on them being put together. Not to be called
+     * while the parser is matching.
+     */
+    void optimizeLayout(const std::vector<std::string_view>& corpus);
+    /**
+     * Extend the pattern to the strings matched by the alternative, as if
+     * compiled as pattern|alternative with the same flags. The states of
+     * the compiled DFA are reused, so the cost grows with the states the
+     * alternative goes through rather than with the pattern. The parser then
+     * keeps the dense table of its DFA, for the next alternatives, until
+     * optimizeLayout. Throws for a pattern with capture groups. Not to be
+     * called while the parser is matching.
+     */
+    void addAlternative(RE_t alternative);
+    /**
+     * The bytes taken by the parser, i.e. by its automata, as everything
+     * used to build them is freed by the constructor, but for the dense
+     * table kept by addAlternative
+     */
+    size_t memoryUsage() const;
 
    private:
+    explicit REParser(std::unique_ptr<REParserImpl>);
+
     std::unique_ptr<REParserImpl> m_parser;
 };
 
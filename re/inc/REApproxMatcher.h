@@ -0,0 +1,54 @@
+#pragma once
+
+#include "RE.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
+namespace RE {
+
+class GlushkovNFA;
+
+/**
+ * Matches the strings within a number of edits of a pattern, e.g. the
+ * identifiers a user types with typos. An edit inserts, deletes or
+ * substitutes a character, i.e. a byte, or a codepoint with the UTF8 flag.
+ *
+ * No DFA is built: the pattern is simulated bit-parallel over its
+ * characters, so that a character of the input costs O(maxEdits) steps
+ * on sets of them rather than the states of every variant of the pattern.
+ * The pattern is limited to 512 characters once its counted repetitions
+ * are unrolled, and its capture groups are ignored.
+ */
+class REApproxMatcher {
+public:
+    /* Of the flags of REParser, UTF8 and CASE_INSENSITIVE apply */
+    REApproxMatcher(REParser::RE_t, const uint32_t maxEdits, const uint32_t flags = REParser::NONE);
+    REApproxMatcher(REApproxMatcher&&) noexcept;
+    REApproxMatcher& operator=(REApproxMatcher&&) noexcept;
+    ~REApproxMatcher();
+
+    uint32_t maxEdits() const { return m_maxEdits; }
+    /* Whether the whole string is within maxEdits of a match */
+    bool matchExact(REParser::Str_t) const;
+    /* The fewest edits making the whole string match, or -1 if more than maxEdits */
+    int32_t distance(REParser::Str_t) const;
+    /**
+     * The position of the substring matched with the fewest edits which
+     * ends first, or -1 if there is none. The match is extended to the
+     * right while its edits do not grow, then to the left as far as they
+     * allow, e.g. "hello" in "say helo!" with one edit is "helo".
+     */
+    int32_t find(REParser::Str_t) const;
+    int32_t find(REParser::Str_t, std::string_view& match) const;
+    /* The characters of the pattern, each being a state of the simulation */
+    size_t numPositions() const;
+
+private:
+    std::unique_ptr<GlushkovNFA> m_nfa;
+    uint32_t m_maxEdits;
+};
+
+} // namespace RE
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "RE.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace RE {
+
+struct CompiledPattern {
+    std::unique_ptr<REParser> parser;  // null if the constructor threw
+    /* what the constructor threw, e.g. an REException, to be rethrown by
+     * std::rethrow_exception to catch its exact type */
+    std::exception_ptr error;
+    double microseconds = 0.0;  // spent compiling the pattern
+};
+
+struct BulkCompilation {
+    std::vector<CompiledPattern> patterns;  // in the order they were given
+    size_t numErrors = 0u;
+    size_t numThreads = 0u;
+    double wallMicroseconds = 0.0;
+    double summedMicroseconds = 0.0;  // the sum of the times of the patterns
+};
+
+/**
+ * Compile the patterns on a pool of numThreads threads, one per core if 0,
+ * an invalid pattern failing alone. Each thread starts on its own share of
+ * the patterns and steals from the others once it is done, as the compile
+ * times of patterns vary by orders of magnitude. The patterns being the
+ * unit of parallelism, REParser::PARALLEL_DETERMINIZATION is ignored.
+ */
+BulkCompilation compileAll(const std::vector<std::string_view>& patterns,
+                           const uint32_t flags = REParser::NONE, size_t numThreads = 0u);
+
+} // namespace RE
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "RE.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace RE {
+
+/* What the construction of the DFA of a pattern cost, phase by phase */
+struct CompileProfile {
+    enum Phase : size_t {
+        PARSE,         // into the simplified AST
+        NFA,           // the Thompson construction, if any
+        SUBSETS,       // the subset construction, or the DFA built and minimized directly
+        MINIMIZATION,  // nothing for a DFA built directly
+        NUM_PHASES,
+    };
+
+    std::array<double, NUM_PHASES> microseconds{};
+    size_t numNFAStates = 0u;
+    size_t numDFAStates = 0u;        // out of the subset construction or the derivatives
+    size_t numMinimizedStates = 0u;  // the dead state included
+};
+
+/**
+ * Build the DFA of the pattern as REParser does, timing each phase, e.g.
+ * to catch the patterns whose compile time blows up. The callback runs as
+ * each phase ends, with the states of the construction still alive, e.g.
+ * to sample the heap. Throws as REParser does on an invalid pattern.
+ */
+CompileProfile profileCompile(REParser::RE_t, const uint32_t flags = REParser::NONE,
+                              const std::function<void(CompileProfile::Phase)>& onPhaseEnd = {});
+
+} // namespace RE
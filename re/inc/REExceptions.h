@@ -41,6 +41,35 @@ public:
     {}
 };
 
+class UnbalancedBracketException : public REException {
+public:
+    explicit UnbalancedBracketException(const size_t pos) :
+        REException("Unbalanced bracket at position " + std::to_string(pos))
+    {}
+};
+
+class MissingBracketException : public REException {
+public:
+    explicit MissingBracketException(const size_t posOpenBracket) :
+        REException("Missing bracket, unterminated open bracket at position " +
+                    std::to_string(posOpenBracket))
+    {}
+};
+
+class InvalidRangeException : public REException {
+public:
+    explicit InvalidRangeException(const size_t pos) :
+        REException("Invalid range in brackets at position " + std::to_string(pos))
+    {}
+};
+
+class InvalidUTF8Exception : public REException {
+public:
+    explicit InvalidUTF8Exception(const size_t pos) :
+        REException("Invalid UTF-8 sequence at position " + std::to_string(pos))
+    {}
+};
+
 class NondigitInBracesException : public REException {
 public:
     explicit NondigitInBracesException(const char sym, const size_t pos) : 
@@ -97,4 +126,19 @@ public:
     {}
 };
 
+class AlternativeToGroupsException : public REException {
+public:
+    explicit AlternativeToGroupsException() :
+        REException("An alternative cannot be added to a pattern with capture groups")
+    {}
+};
+
+class TooManyPositionsException : public REException {
+public:
+    explicit TooManyPositionsException(const size_t maxPositions) :
+        REException("The pattern has more than " + std::to_string(maxPositions) +
+                    " characters for approximate matching")
+    {}
+};
+
 } // namespace RE
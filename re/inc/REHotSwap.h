@@ -0,0 +1,94 @@
+#pragma once
+
+#include "RE.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace RE {
+
+/**
+ * A compiled pattern which a writer replaces while readers match with it,
+ * e.g. a rule set reloaded under traffic, without stopping the readers nor
+ * keeping them behind a lock.
+ *
+ * A reader takes a snapshot, which marks a slot of the handle with the
+ * current epoch and then loads the current parser: a compare-and-swap on
+ * a slot the thread usually has to itself, and a load. The writer swaps the
+ * new parser in and advances the epoch, and the parser replaced is deleted
+ * once no slot is marked with an epoch up to the one it was replaced in,
+ * i.e. by the first publish or reclaim after the snapshots which may hold
+ * it are destroyed (epoch-based reclamation).
+ *
+ * Snapshots are meant to be short, e.g. a match: a parser replaced is kept
+ * alive by any snapshot older than it, and a thread taking a snapshot while
+ * every slot is held waits for one.
+ */
+class REHotSwap {
+    struct Slot;
+
+public:
+    /* The parser current when it was taken, which lives as long as the snapshot */
+    class Snapshot {
+        friend class REHotSwap;
+
+    public:
+        Snapshot(Snapshot&&) noexcept;
+        Snapshot& operator=(Snapshot&&) = delete;
+        ~Snapshot();
+
+        const REParser& operator*() const { return *m_parser; }
+        const REParser* operator->() const { return m_parser; }
+
+    private:
+        Snapshot(Slot* slot, REParser const* parser) :
+            m_slot(slot), m_parser(parser) {}
+
+        Slot* m_slot;
+        REParser const* m_parser;
+    };
+
+    /* numSlots bounds the snapshots held at once, 4 per hardware thread if 0 */
+    explicit REHotSwap(std::unique_ptr<REParser>, size_t numSlots = 0u);
+    REHotSwap(const REHotSwap&) = delete;
+    REHotSwap& operator=(const REHotSwap&) = delete;
+    ~REHotSwap();  // no snapshot may outlive the handle
+
+    Snapshot snapshot() const;
+    /* A snapshot for a single match */
+    bool matchExact(REParser::Str_t) const;
+    int32_t find(REParser::Str_t, std::string_view& match) const;
+
+    /**
+     * Make the parser the current one, for the snapshots taken from now on.
+     * Writers are serialized, and the parsers replaced which no snapshot
+     * holds any more are deleted.
+     */
+    void publish(std::unique_ptr<REParser>);
+    /* Delete the parsers replaced which no snapshot holds, returning how many are left */
+    size_t reclaim();
+    /* 1 before the first publish, and advanced by each */
+    uint64_t epoch() const { return m_epoch.load(); }
+
+private:
+    /* Under m_writerMutex */
+    size_t reclaimRetired();
+
+    const size_t m_numSlots;
+    std::unique_ptr<Slot[]> m_slots;
+    std::atomic<REParser const*> m_current;
+    std::atomic<uint64_t> m_epoch{1u};  // a slot marked 0 is free
+
+    std::mutex m_writerMutex;
+    std::unique_ptr<REParser> m_owned;  // the current parser
+    /* the parsers replaced, with the last epoch in which they were current */
+    std::vector<std::pair<std::unique_ptr<REParser>, uint64_t>> m_retired;
+};
+
+} // namespace RE
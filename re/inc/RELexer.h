@@ -0,0 +1,115 @@
+#pragma once
+
+#include "RE.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <string_view>
+#include <vector>
+
+namespace RE {
+
+class REParserImpl;
+
+/**
+ * A scanner compiled from an ordered list of rules into a single DFA, e.g.
+ * {"if", "[a-z]+", "[0-9]+", " +"}. The tokens are read by maximal munch:
+ * the next token is the longest prefix matched by any rule, and the first
+ * of the rules matching it names it, so that "if" is a keyword and "iffy"
+ * is a name. The capture groups of the rules are ignored.
+ */
+class RELexer {
+public:
+    using TokenId_t = uint32_t;
+    /* the id of a byte which starts no token */
+    static constexpr TokenId_t UNKNOWN = UINT32_MAX;
+
+    struct Token {
+        TokenId_t id = UNKNOWN;  // the index of the rule
+        std::string_view text;   // a span into the scanned string
+    };
+
+    /* Iterates over the tokens of a string, which must outlive the iterator */
+    class TokenIterator {
+        friend class RELexer;
+
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = Token;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Token*;
+        using reference = const Token&;
+
+        TokenIterator() = default;  // the end of the tokens
+
+        reference operator*() const { return m_token; }
+        pointer operator->() const { return &m_token; }
+        TokenIterator& operator++();
+        TokenIterator operator++(int) {
+            auto it = *this;
+            ++*this;
+            return it;
+        }
+        bool operator==(const TokenIterator& other) const {
+            return m_lexer == other.m_lexer and m_token.text.data() == other.m_token.text.data();
+        }
+        bool operator!=(const TokenIterator& other) const { return not (*this == other); }
+
+    private:
+        TokenIterator(RELexer const* lexer, std::string_view str) :
+            m_lexer(lexer), m_str(str)
+        {
+            ++*this;
+        }
+
+        RELexer const* m_lexer = nullptr;
+        std::string_view m_str;
+        Token m_token;
+        size_t m_next = 0u;  // where the next token starts
+    };
+
+    class TokenRange {
+        friend class RELexer;
+
+    public:
+        TokenIterator begin() const { return TokenIterator(m_lexer, m_str); }
+        TokenIterator end() const { return TokenIterator(); }
+
+    private:
+        TokenRange(RELexer const* lexer, std::string_view str) :
+            m_lexer(lexer), m_str(str) {}
+
+        RELexer const* m_lexer;
+        std::string_view m_str;
+    };
+
+    /* The flags are those of REParser and apply to all the rules */
+    RELexer(const std::vector<std::string_view>& rules, const uint32_t flags = REParser::NONE);
+    /* Compiled with the resource as REParser does */
+    RELexer(const std::vector<std::string_view>& rules, const uint32_t flags,
+            std::pmr::memory_resource* compileResource);
+    ~RELexer();
+
+    /**
+     * Read the token starting at pos, a byte starting no token making an
+     * UNKNOWN token by itself, and move pos past it. Returns false at the
+     * end of the string.
+     */
+    bool next(REParser::Str_t, size_t& pos, Token&) const;
+    /* e.g. for (const auto token : lexer.tokenize(str)) */
+    TokenRange tokenize(REParser::Str_t) const;
+    /* The bytes taken by the transition table */
+    size_t tableSize() const;
+    /* See REParser::optimizeLayout */
+    void optimizeLayout(const std::vector<std::string_view>& corpus);
+    /* See REParser::memoryUsage */
+    size_t memoryUsage() const;
+
+private:
+    std::unique_ptr<REParserImpl> m_lexer;
+};
+
+} // namespace RE
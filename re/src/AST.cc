@@ -0,0 +1,349 @@
+#include "AST.h"
+
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <utility>
+
+namespace RE::AST {
+
+namespace {
+
+NodePtr makeNode(const Node::Type type) {
+    auto node = std::make_unique<Node>();
+    node->type = type;
+    return node;
+}
+
+NodePtr makeLiteral(std::vector<uint32_t> chars) {
+    auto node = makeNode(Node::Type::literal);
+    node->chars = std::move(chars);
+    return node;
+}
+
+CharClass classOf(const Node& node) {
+    return node.type == Node::Type::literal ? CharClass(node.chars.front()) : node.charClass;
+}
+
+/* ?, * and +, which compose into one of them */
+bool isSimpleQuantifier(const Node& node) {
+    return node.type == Node::Type::repetition and node.min <= 1u and
+           (node.max == 1u or node.max == Node::UNBOUNDED);
+}
+
+/* The literal a node starts with, if any */
+Node* leadingLiteral(Node& node) {
+    if (node.type == Node::Type::literal) {
+        return &node;
+    }
+    if (node.type == Node::Type::concatenation and
+        node.children.front()->type == Node::Type::literal) {
+        return node.children.front().get();
+    }
+    return nullptr;
+}
+
+/* Call rewrite on every node after its children, which it may replace */
+template <typename F>
+void rewriteBottomUp(NodePtr& root, F&& rewrite) {
+    // the nodes on the path from the root, with their next child to visit
+    std::vector<std::pair<NodePtr*, size_t>> path{{&root, 0u}};
+    while (not path.empty()) {
+        auto& [node, next] = path.back();
+        if (next < (*node)->children.size()) {
+            auto* child = &(*node)->children[next++];
+            path.emplace_back(child, 0u);
+            continue;
+        }
+        rewrite(*node);
+        path.pop_back();
+    }
+}
+
+void simplifyConcatenation(NodePtr&);
+void simplifyAlternation(NodePtr&);
+void simplifyRepetition(NodePtr&);
+
+void simplifyConcatenation(NodePtr& node) {
+    std::vector<NodePtr> children;
+    const auto append = [&children](NodePtr child) {
+        if (child->type == Node::Type::empty) {
+            return;
+        }
+        if (child->type == Node::Type::literal and
+            not children.empty() and children.back()->type == Node::Type::literal)
+        {
+            auto& chars = children.back()->chars;
+            chars.insert(chars.end(), child->chars.begin(), child->chars.end());
+            return;
+        }
+        children.push_back(std::move(child));
+    };
+    for (auto& child : node->children) {
+        if (child->type == Node::Type::concatenation) {
+            for (auto& grandChild : child->children) {
+                append(std::move(grandChild));
+            }
+        }
+        else {
+            append(std::move(child));
+        }
+    }
+
+    if (children.empty()) {
+        node = makeEmpty();
+    }
+    else if (children.size() == 1u) {
+        node = std::move(children.front());
+    }
+    else {
+        node->children = std::move(children);
+    }
+}
+
+/**
+ * The alternatives starting with the same character are grouped, keeping
+ * the order of the groups, and the common prefix of each group is taken
+ * out of it: foo|bar|baz becomes foo|ba(r|z).
+ */
+std::vector<NodePtr> factorPrefixes(std::vector<NodePtr> alternatives) {
+    std::vector<std::vector<NodePtr>> groups;
+    std::map<uint32_t, size_t> groupOfFirstChar;
+    for (auto& alternative : alternatives) {
+        auto const* literal = leadingLiteral(*alternative);
+        if (literal == nullptr) {
+            groups.emplace_back();
+        }
+        else if (const auto [it, isNew] = groupOfFirstChar.try_emplace(literal->chars.front(), groups.size());
+                 isNew) {
+            groups.emplace_back();
+        }
+        else {
+            groups[it->second].push_back(std::move(alternative));
+            continue;
+        }
+        groups.back().push_back(std::move(alternative));
+    }
+
+    std::vector<NodePtr> factored;
+    for (auto& group : groups) {
+        if (group.size() == 1u) {
+            factored.push_back(std::move(group.front()));
+            continue;
+        }
+        auto prefix = leadingLiteral(*group.front())->chars;
+        for (const auto& alternative : group) {
+            const auto& chars = leadingLiteral(*alternative)->chars;
+            const auto mismatch = std::mismatch(prefix.begin(), prefix.end(), chars.begin(), chars.end());
+            prefix.erase(mismatch.first, prefix.end());
+        }
+
+        auto rests = makeNode(Node::Type::alternation);
+        for (auto& alternative : group) {
+            auto& chars = leadingLiteral(*alternative)->chars;
+            chars.erase(chars.begin(), chars.begin() + prefix.size());
+            if (chars.empty()) {
+                if (alternative->type == Node::Type::literal) {
+                    alternative = makeEmpty();
+                }
+                else {
+                    alternative->children.erase(alternative->children.begin());
+                    simplifyConcatenation(alternative);
+                }
+            }
+            rests->children.push_back(std::move(alternative));
+        }
+        simplifyAlternation(rests);
+
+        auto prefixed = makeNode(Node::Type::concatenation);
+        prefixed->children.push_back(makeLiteral(std::move(prefix)));
+        prefixed->children.push_back(std::move(rests));
+        simplifyConcatenation(prefixed);
+        factored.push_back(std::move(prefixed));
+    }
+    return factored;
+}
+
+void simplifyAlternation(NodePtr& node) {
+    std::vector<NodePtr> alternatives;
+    bool isOptional = false;
+    for (auto& child : node->children) {
+        if (child->type == Node::Type::alternation) {
+            std::move(child->children.begin(), child->children.end(), std::back_inserter(alternatives));
+        }
+        else if (child->type == Node::Type::empty) {
+            isOptional = true;
+        }
+        else {
+            alternatives.push_back(std::move(child));
+        }
+    }
+
+    alternatives = factorPrefixes(std::move(alternatives));
+
+    // the single characters are merged into the first of them
+    std::vector<NodePtr> children;
+    Node* charClass = nullptr;
+    for (auto& alternative : alternatives) {
+        if (not alternative->isSingleChar()) {
+            children.push_back(std::move(alternative));
+        }
+        else if (charClass == nullptr) {
+            children.push_back(std::move(alternative));
+            charClass = children.back().get();
+        }
+        else {
+            auto merged = classOf(*charClass);
+            merged.add(classOf(*alternative));
+            charClass->type = Node::Type::char_class;
+            charClass->chars.clear();
+            charClass->charClass = merged;
+        }
+    }
+
+    if (children.empty()) {
+        node = makeEmpty();
+        return;
+    }
+    if (children.size() == 1u) {
+        node = std::move(children.front());
+    }
+    else {
+        node->children = std::move(children);
+    }
+    if (isOptional) {
+        node = makeRepetition(std::move(node), 0u, 1u);
+        simplifyRepetition(node);
+    }
+}
+
+void simplifyRepetition(NodePtr& node) {
+    auto& child = node->children.front();
+    if (child->type == Node::Type::empty or node->max == 0u) {
+        node = makeEmpty();
+        return;
+    }
+    if (node->min == 1u and node->max == 1u) {
+        node = std::move(child);
+        return;
+    }
+    if (isSimpleQuantifier(*node) and isSimpleQuantifier(*child)) {
+        node->min *= child->min;
+        node->max = std::max(node->max, child->max);
+        auto grandChild = std::move(child->children.front());
+        child = std::move(grandChild);
+    }
+}
+
+} // namespace
+
+NodePtr makeEmpty() {
+    return makeNode(Node::Type::empty);
+}
+
+NodePtr makeCharClass(const CharClass& charClass) {
+    auto node = makeNode(Node::Type::char_class);
+    node->charClass = charClass;
+    return node;
+}
+
+NodePtr makeConcatenation(std::vector<NodePtr> children) {
+    auto node = makeNode(Node::Type::concatenation);
+    node->children = std::move(children);
+    return node;
+}
+
+NodePtr makeAlternation(NodePtr a, NodePtr b) {
+    if (a->type == Node::Type::alternation) {
+        a->children.push_back(std::move(b));
+        return a;
+    }
+    auto node = makeNode(Node::Type::alternation);
+    node->children.push_back(std::move(a));
+    node->children.push_back(std::move(b));
+    return node;
+}
+
+NodePtr makeRepetition(NodePtr child, const uint32_t min, const uint32_t max) {
+    auto node = makeNode(Node::Type::repetition);
+    node->children.push_back(std::move(child));
+    node->min = min;
+    node->max = max;
+    return node;
+}
+
+NodePtr makeCapture(NodePtr child, const uint32_t group) {
+    auto node = makeNode(Node::Type::capture);
+    node->children.push_back(std::move(child));
+    node->group = group;
+    return node;
+}
+
+Node::~Node() {
+    auto toDestroy = std::move(children);
+    while (not toDestroy.empty()) {
+        auto node = std::move(toDestroy.back());
+        toDestroy.pop_back();
+        // a node rewritten by simplify may have lost children
+        if (node != nullptr) {
+            std::move(node->children.begin(), node->children.end(), std::back_inserter(toDestroy));
+            node->children.clear();
+        }
+    }
+}
+
+NodePtr clone(const Node& root) {
+    NodePtr copy;
+    std::vector<std::pair<Node const*, NodePtr*>> toCopy{{&root, &copy}};
+    while (not toCopy.empty()) {
+        const auto [node, target] = toCopy.back();
+        toCopy.pop_back();
+        *target = makeNode(node->type);
+        auto& copied = **target;
+        copied.chars = node->chars;
+        copied.charClass = node->charClass;
+        copied.min = node->min;
+        copied.max = node->max;
+        copied.group = node->group;
+        // the children are allocated first, so that their slots stay in place
+        copied.children.resize(node->children.size());
+        for (size_t i = 0u; i < node->children.size(); i++) {
+            toCopy.emplace_back(node->children[i].get(), &copied.children[i]);
+        }
+    }
+    return copy;
+}
+
+void eraseCaptures(NodePtr& root) {
+    rewriteBottomUp(root, [](NodePtr& node) {
+        if (node->type == Node::Type::capture) {
+            auto child = std::move(node->children.front());
+            node = std::move(child);
+        }
+    });
+}
+
+void simplify(NodePtr& root) {
+    rewriteBottomUp(root, [](NodePtr& node) {
+        switch (node->type) {
+        case Node::Type::char_class:
+            if (node->charClass.isSingle()) {
+                node = makeLiteral({node->charClass.min()});
+            }
+            break;
+        case Node::Type::concatenation:
+            simplifyConcatenation(node);
+            break;
+        case Node::Type::alternation:
+            simplifyAlternation(node);
+            break;
+        case Node::Type::repetition:
+            simplifyRepetition(node);
+            break;
+        default:
+            break;
+        }
+    });
+}
+
+} // namespace RE::AST
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "CharClass.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace RE::AST {
+
+struct Node;
+using NodePtr = std::unique_ptr<Node>;
+
+/**
+ * The pattern as parsed. It is rewritten into a smaller equivalent tree
+ * before the NFA is built from it, since the parser cannot look ahead.
+ */
+struct Node {
+    enum class Type {
+        empty,
+        literal,
+        char_class,
+        concatenation,
+        alternation,
+        repetition,
+        capture,
+    };
+    static constexpr uint32_t UNBOUNDED = UINT32_MAX;
+
+    Type type = Type::empty;
+    std::vector<uint32_t> chars;  // of a literal
+    CharClass charClass;
+    std::vector<NodePtr> children;
+    uint32_t min = 0u;  // of a repetition
+    uint32_t max = 0u;
+    uint32_t group = 0u;  // of a capture
+
+    /* The descendants are destroyed from a stack, as the nesting of a pattern is unbounded */
+    ~Node();
+
+    bool isSingleChar() const {
+        return (type == Type::literal and chars.size() == 1u) or type == Type::char_class;
+    }
+};
+
+NodePtr makeEmpty();
+NodePtr makeCharClass(const CharClass&);
+NodePtr makeConcatenation(std::vector<NodePtr>);
+/* The alternatives of a are appended to, as the parser nests them to the left */
+NodePtr makeAlternation(NodePtr a, NodePtr b);
+NodePtr makeRepetition(NodePtr, const uint32_t min, const uint32_t max);
+NodePtr makeCapture(NodePtr, const uint32_t group);
+
+NodePtr clone(const Node&);
+
+/* Replace the capture groups by their contents, as the DFA needs no tags */
+void eraseCaptures(NodePtr&);
+
+/**
+ * Rewrite the tree bottom-up:
+ *   - flatten nested concatenations and alternations
+ *   - merge consecutive characters into literals
+ *   - factor the common prefixes out of alternations, e.g. a|ab as a(b)?
+ *   - merge the single characters and classes of alternations into a
+ *     class, e.g. x|y|z as [xyz]
+ *   - collapse nested quantifiers, e.g. (a*)+ as a*
+ * The capture groups are left in place and are not rewritten across. Like
+ * eraseCaptures and clone, it walks the tree with a stack rather than
+ * recursively.
+ */
+void simplify(NodePtr&);
+
+} // namespace RE::AST
@@ -0,0 +1,22 @@
+#include "ByteClasses.h"
+
+namespace RE {
+
+void ByteClasses::refine(const ByteSet& byteSet) {
+    // (old class, is in the set) -> new class
+    std::array<int16_t, 2 * ByteSet::NUM_BYTES> newClasses;
+    newClasses.fill(-1);
+    size_t numClasses = 0u;
+    for (size_t byte = 0u; byte < ByteSet::NUM_BYTES; byte++) {
+        auto& newClass = newClasses[2 * m_classOf[byte] + byteSet.contains(byte)];
+        if (newClass < 0) {
+            newClass = numClasses;
+            m_representatives[numClasses] = byte;
+            numClasses++;
+        }
+        m_classOf[byte] = newClass;
+    }
+    m_numClasses = numClasses;
+}
+
+} // namespace RE
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "ByteSet.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace RE {
+
+/**
+ * Partition of the 256 bytes into classes that no transition distinguishes.
+ * The DFA is built over the classes instead of the bytes, which keeps its
+ * tables small even though the alphabet covers the full 8-bit range.
+ */
+class ByteClasses {
+public:
+    ByteClasses() { m_classOf.fill(0u); }
+
+    /* Split every class by the membership of its bytes in the set */
+    void refine(const ByteSet&);
+
+    uint8_t classOf(const uint8_t byte) const { return m_classOf[byte]; }
+    size_t numClasses() const { return m_numClasses; }
+    /* The smallest byte of the class */
+    uint8_t representative(const uint8_t cls) const { return m_representatives[cls]; }
+    ByteSet bytesOf(const uint8_t cls) const {
+        ByteSet bytes;
+        for (size_t byte = 0u; byte < ByteSet::NUM_BYTES; byte++) {
+            if (m_classOf[byte] == cls) {
+                bytes.add(byte);
+            }
+        }
+        return bytes;
+    }
+
+private:
+    std::array<uint8_t, ByteSet::NUM_BYTES> m_classOf;
+    std::array<uint8_t, ByteSet::NUM_BYTES> m_representatives{};
+    size_t m_numClasses = 1u;
+};
+
+} // namespace RE
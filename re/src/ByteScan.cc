@@ -0,0 +1,104 @@
+#include "ByteScan.h"
+
+#include <cstring>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace RE::ByteScan {
+
+namespace {
+
+bool contains(const Needles& needles, const uint8_t byte) {
+    for (size_t i = 0u; i < needles.numBytes; i++) {
+        if (needles.bytes[i] == byte) {
+            return true;
+        }
+    }
+    return false;
+}
+
+#if defined(__AVX2__)
+using Vector = __m256i;
+constexpr size_t VECTOR_SIZE = 32u;
+
+Vector broadcast(const uint8_t byte) { return _mm256_set1_epi8(static_cast<char>(byte)); }
+uint32_t matchMask(const char* data, const Vector* needles, const size_t numBytes) {
+    const auto chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data));
+    auto matches = _mm256_cmpeq_epi8(chunk, needles[0]);
+    for (size_t i = 1u; i < numBytes; i++) {
+        matches = _mm256_or_si256(matches, _mm256_cmpeq_epi8(chunk, needles[i]));
+    }
+    return static_cast<uint32_t>(_mm256_movemask_epi8(matches));
+}
+#elif defined(__SSE2__)
+using Vector = __m128i;
+constexpr size_t VECTOR_SIZE = 16u;
+
+Vector broadcast(const uint8_t byte) { return _mm_set1_epi8(static_cast<char>(byte)); }
+uint32_t matchMask(const char* data, const Vector* needles, const size_t numBytes) {
+    const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+    auto matches = _mm_cmpeq_epi8(chunk, needles[0]);
+    for (size_t i = 1u; i < numBytes; i++) {
+        matches = _mm_or_si128(matches, _mm_cmpeq_epi8(chunk, needles[i]));
+    }
+    return static_cast<uint32_t>(_mm_movemask_epi8(matches));
+}
+#endif
+
+} // namespace
+
+size_t findFirst(std::string_view str, size_t pos, const Needles& needles) {
+    if (needles.numBytes == 0u) {
+        return NOT_FOUND;
+    }
+    if (needles.numBytes == 1u) {
+        const auto found = pos < str.size() ?
+            std::memchr(str.data() + pos, needles.bytes[0], str.size() - pos) : nullptr;
+        return found ? static_cast<const char*>(found) - str.data() : NOT_FOUND;
+    }
+#if defined(__AVX2__) || defined(__SSE2__)
+    Vector vectors[MAX_NUM_BYTES];
+    for (size_t i = 0u; i < needles.numBytes; i++) {
+        vectors[i] = broadcast(needles.bytes[i]);
+    }
+    for (; pos + VECTOR_SIZE <= str.size(); pos += VECTOR_SIZE) {
+        if (const auto mask = matchMask(str.data() + pos, vectors, needles.numBytes); mask != 0u) {
+            return pos + __builtin_ctz(mask);
+        }
+    }
+#endif
+    for (; pos < str.size(); pos++) {
+        if (contains(needles, str[pos])) {
+            return pos;
+        }
+    }
+    return NOT_FOUND;
+}
+
+size_t findLast(std::string_view str, const size_t min, size_t pos, const Needles& needles) {
+    if (needles.numBytes == 0u) {
+        return NOT_FOUND;
+    }
+#if defined(__AVX2__) || defined(__SSE2__)
+    Vector vectors[MAX_NUM_BYTES];
+    for (size_t i = 0u; i < needles.numBytes; i++) {
+        vectors[i] = broadcast(needles.bytes[i]);
+    }
+    for (; pos >= min + VECTOR_SIZE; pos -= VECTOR_SIZE) {
+        const auto mask = matchMask(str.data() + pos - VECTOR_SIZE, vectors, needles.numBytes);
+        if (mask != 0u) {
+            return pos - VECTOR_SIZE + (31 - __builtin_clz(mask));
+        }
+    }
+#endif
+    while (pos > min) {
+        if (contains(needles, str[--pos])) {
+            return pos;
+        }
+    }
+    return NOT_FOUND;
+}
+
+} // namespace RE::ByteScan
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace RE::ByteScan {
+
+constexpr size_t MAX_NUM_BYTES = 3u;
+constexpr size_t NOT_FOUND = std::string_view::npos;
+
+/* The bytes searched at once */
+struct Needles {
+    uint8_t numBytes = 0u;
+    uint8_t bytes[MAX_NUM_BYTES] = {};
+};
+
+/**
+ * The searches use memchr for a single byte, and otherwise compare vectors
+ * of the string against each byte with SSE2, or AVX2 if enabled at compile
+ * time. They return NOT_FOUND if none of the bytes is in the range.
+ */
+
+/* The first position in [pos, str.size()) holding one of the bytes */
+size_t findFirst(std::string_view str, size_t pos, const Needles&);
+/* The last position in [min, pos) holding one of the bytes */
+size_t findLast(std::string_view str, const size_t min, size_t pos, const Needles&);
+
+} // namespace RE::ByteScan
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace RE {
+
+/**
+ * A set of bytes labelling a single NFA transition, so that a character
+ * class like [a-z] or [^"] costs one edge instead of one state pair per byte
+ */
+class ByteSet {
+public:
+    static constexpr size_t NUM_BYTES = 256u;
+
+    ByteSet() = default;
+    explicit ByteSet(const uint8_t byte) { add(byte); }
+
+    static ByteSet range(const uint8_t lo, const uint8_t hi) {
+        ByteSet byteSet;
+        byteSet.addRange(lo, hi);
+        return byteSet;
+    }
+    static ByteSet all() { return ~ByteSet(); }
+
+    void add(const uint8_t byte) { m_bytes.set(byte); }
+    void addRange(const uint8_t lo, const uint8_t hi) {
+        for (auto byte = static_cast<size_t>(lo); byte <= hi; byte++) {
+            m_bytes.set(byte);
+        }
+    }
+    void add(const ByteSet& other) { m_bytes |= other.m_bytes; }
+    void remove(const uint8_t byte) { m_bytes.reset(byte); }
+
+    bool contains(const uint8_t byte) const { return m_bytes.test(byte); }
+    bool isEmpty() const { return m_bytes.none(); }
+    size_t count() const { return m_bytes.count(); }
+    /* The smallest byte of a non-empty set */
+    uint8_t min() const {
+        size_t byte = 0u;
+        while (not m_bytes.test(byte)) {
+            byte++;
+        }
+        return static_cast<uint8_t>(byte);
+    }
+
+    ByteSet operator~() const {
+        ByteSet byteSet;
+        byteSet.m_bytes = ~m_bytes;
+        return byteSet;
+    }
+    bool operator==(const ByteSet& other) const { return m_bytes == other.m_bytes; }
+    bool operator!=(const ByteSet& other) const { return m_bytes != other.m_bytes; }
+    size_t hash() const { return std::hash<std::bitset<NUM_BYTES>>()(m_bytes); }
+
+private:
+    std::bitset<NUM_BYTES> m_bytes;
+};
+
+} // namespace RE
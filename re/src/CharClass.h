@@ -0,0 +1,165 @@
+#pragma once
+
+#include "ByteSet.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace RE {
+
+/**
+ * A set of characters kept as sorted, disjoint ranges. Characters are bytes
+ * in the default mode and codepoints in the UTF-8 mode.
+ */
+class CharClass {
+public:
+    using Range = std::pair<uint32_t, uint32_t>;
+
+    static constexpr uint32_t MAX_BYTE = 0xffu;
+    static constexpr uint32_t MAX_CODEPOINT = 0x10ffffu;
+
+    CharClass() = default;
+    explicit CharClass(const uint32_t c) { addRange(c, c); }
+
+    static CharClass range(const uint32_t lo, const uint32_t hi) {
+        CharClass charClass;
+        charClass.addRange(lo, hi);
+        return charClass;
+    }
+    static CharClass digits() { return range('0', '9'); }
+    static CharClass word() {
+        auto charClass = range('0', '9');
+        charClass.addRange('A', 'Z');
+        charClass.addRange('a', 'z');
+        charClass.addRange('_', '_');
+        return charClass;
+    }
+    static CharClass space() {
+        auto charClass = range('\t', '\r');  // \t \n \v \f \r
+        charClass.addRange(' ', ' ');
+        return charClass;
+    }
+
+    void addRange(const uint32_t lo, const uint32_t hi) {
+        assert(lo <= hi);
+        m_ranges.emplace_back(lo, hi);
+        normalize();
+    }
+    void add(const CharClass& other) {
+        m_ranges.insert(m_ranges.end(), other.m_ranges.begin(), other.m_ranges.end());
+        normalize();
+    }
+    void remove(const uint32_t c) {
+        std::vector<Range> ranges;
+        for (const auto& [lo, hi] : m_ranges) {
+            if (c < lo or c > hi) {
+                ranges.emplace_back(lo, hi);
+                continue;
+            }
+            if (lo < c) {
+                ranges.emplace_back(lo, c - 1);
+            }
+            if (c < hi) {
+                ranges.emplace_back(c + 1, hi);
+            }
+        }
+        m_ranges = std::move(ranges);
+    }
+
+    /* The characters up to maxChar that are not in the class */
+    CharClass negated(const uint32_t maxChar) const {
+        CharClass complement;
+        uint32_t next = 0u;
+        for (const auto& [lo, hi] : m_ranges) {
+            if (lo > maxChar) {
+                break;
+            }
+            if (lo > next) {
+                complement.m_ranges.emplace_back(next, lo - 1);
+            }
+            next = hi + 1;
+        }
+        if (next <= maxChar) {
+            complement.m_ranges.emplace_back(next, maxChar);
+        }
+        return complement;
+    }
+
+    bool isEmpty() const { return m_ranges.empty(); }
+    bool isSingle() const {
+        return m_ranges.size() == 1u and m_ranges[0].first == m_ranges[0].second;
+    }
+    uint32_t min() const { return m_ranges.front().first; }
+    const std::vector<Range>& ranges() const { return m_ranges; }
+
+    /**
+     * The class closed under simple case folding: ASCII letters, and for
+     * codepoints also the Latin-1, basic Greek and Cyrillic letters
+     */
+    CharClass caseFolded(const uint32_t maxChar) const {
+        struct CaseRange {
+            uint32_t upperLo;
+            uint32_t upperHi;
+            uint32_t delta;  // lower = upper + delta
+        };
+        static constexpr CaseRange CASE_RANGES[] = {
+            {'A', 'Z', 0x20u},
+            {0xc0u, 0xd6u, 0x20u},    // À-Ö
+            {0xd8u, 0xdeu, 0x20u},    // Ø-Þ
+            {0x391u, 0x3a1u, 0x20u},  // Α-Ρ
+            {0x3a3u, 0x3abu, 0x20u},  // Σ-Ϋ
+            {0x400u, 0x40fu, 0x50u},  // Ѐ-Џ
+            {0x410u, 0x42fu, 0x20u},  // А-Я
+        };
+        auto folded = *this;
+        for (const auto& caseRange : CASE_RANGES) {
+            if (caseRange.upperHi + caseRange.delta > maxChar) {
+                continue;
+            }
+            for (const auto& [lo, hi] : m_ranges) {
+                const auto addShifted = [&folded, lo = lo, hi = hi](
+                        const uint32_t from, const uint32_t to, const int64_t shift) {
+                    if (lo <= to and from <= hi) {
+                        folded.addRange(std::max(lo, from) + shift, std::min(hi, to) + shift);
+                    }
+                };
+                addShifted(caseRange.upperLo, caseRange.upperHi, caseRange.delta);
+                addShifted(caseRange.upperLo + caseRange.delta,
+                           caseRange.upperHi + caseRange.delta,
+                           -static_cast<int64_t>(caseRange.delta));
+            }
+        }
+        return folded;
+    }
+
+    ByteSet toByteSet() const {
+        ByteSet byteSet;
+        for (const auto& [lo, hi] : m_ranges) {
+            assert(hi <= MAX_BYTE);
+            byteSet.addRange(lo, hi);
+        }
+        return byteSet;
+    }
+
+private:
+    void normalize() {
+        std::sort(m_ranges.begin(), m_ranges.end());
+        std::vector<Range> merged;
+        for (const auto& range : m_ranges) {
+            if (not merged.empty() and range.first <= merged.back().second + 1) {
+                merged.back().second = std::max(merged.back().second, range.second);
+            }
+            else {
+                merged.push_back(range);
+            }
+        }
+        m_ranges = std::move(merged);
+    }
+
+    std::vector<Range> m_ranges;
+};
+
+} // namespace RE
@@ -2,28 +2,35 @@
 #include "StateManager.h"
 
 #include <algorithm>
+#include <array>
 
 namespace RE {
 
-DFAMinimizer::DFAMinimizer(StateManager& stateManager) {
+DFAMinimizer::DFAMinimizer(StateManager& stateManager) :
+    m_allocator(stateManager.m_allocator),
+    m_byteClasses(stateManager.m_byteClasses)
+{
     addDeadState(stateManager);
     mergeFinalAndNonFinalStates(stateManager);
 }
 
+/* The final states are further split by the rule they accept when scanning */
 void DFAMinimizer::mergeFinalAndNonFinalStates(const StateManager& stateManager) {
     m_DFAToMergedDFA.resize(stateManager.m_DFAs.size(), -1);
 
     constexpr auto NON_FINALS = 0u;
-    constexpr auto FINALS = 1u;
-    makeMergedDfaState(NON_FINALS);
-    makeMergedDfaState(FINALS);
+    makeMergedDfaState(false);
     auto& nonFinals = m_mergedDfaStates.at(NON_FINALS);
-    auto& finals = m_mergedDfaStates.at(FINALS);
+    std::pmr::map<uint32_t, MergedDfaState*> finalsOfToken(m_allocator);
     for (const auto& [_, dfaState] : stateManager.m_DFAs) {
         const auto id = dfaState.m_id;
         if (dfaState.m_isFinal) {
-            finals.dfaStates.insert(&dfaState);
-            m_DFAToMergedDFA[id] = FINALS;
+            auto& finals = finalsOfToken[dfaState.m_token];
+            if (finals == nullptr) {
+                finals = makeMergedDfaState(true, dfaState.m_token);
+            }
+            finals->dfaStates.insert(&dfaState);
+            m_DFAToMergedDFA[id] = finals->id;
         }
         else {
             nonFinals.dfaStates.insert(&dfaState);
@@ -40,35 +47,37 @@ DFA DFAMinimizer::minimize() {
     do {
         hasAmbiguity = false;
         for (auto& [_, mergedDfaState] : m_mergedDfaStates) {
-            if (const char sym = searchForAmbiguousSymbol(mergedDfaState)) {  // TODO memoize ambiguous symbol
-                splitMergedDfaState(mergedDfaState, sym);
+            if (const auto cls = searchForAmbiguousSymbol(mergedDfaState); cls >= 0) {  // TODO memoize ambiguous symbol
+                splitMergedDfaState(mergedDfaState, cls);
                 hasAmbiguity = true;
                 break;
             }
         }
     } while (hasAmbiguity);
 
-    if (m_deadState) {
-        removeDeadState();
-    }
-    return constructMinimizedDFA();
+    auto minimizedDFA = constructMinimizedDFA();
+    // the ids of the merged states follow the splits, not the transitions
+    minimizedDFA.renumber(minimizedDFA.breadthFirstOrder());
+    minimizedDFA.accelerate();
+    minimizedDFA.compress();
+    return minimizedDFA;
 }
 
-DFAMinimizer::MergedDfaState* DFAMinimizer::makeMergedDfaState(const bool isFinal) {
+DFAMinimizer::MergedDfaState* DFAMinimizer::makeMergedDfaState(const bool isFinal, const uint32_t token) {
     const auto id = m_mergedDfaStateId;
-    m_mergedDfaStates.try_emplace(id, id, isFinal);  // m_mergedDfaStates[id] = MergedDfaState(id, isFinal);
+    m_mergedDfaStates.try_emplace(id, id, isFinal, token);  // m_mergedDfaStates[id] = MergedDfaState(id, isFinal, token);
     m_mergedDfaStateId++;
     return &(m_mergedDfaStates.at(id));
 }
 
-void DFAMinimizer::splitMergedDfaState(const MergedDfaState& state, const char sym) {
-    std::map<int32_t, MergedDfaState*> newTransitions;
+void DFAMinimizer::splitMergedDfaState(const MergedDfaState& state, const uint8_t sym) {
+    std::pmr::map<int32_t, MergedDfaState*> newTransitions(m_allocator);
     for (auto const* dfaState : state.dfaStates) {
         auto const* toState = dfaState->m_transitions.at(sym);
         int32_t to = m_DFAToMergedDFA[toState->m_id];
 
         if (newTransitions.find(to) == newTransitions.end()) {
-            newTransitions[to] = makeMergedDfaState(state.isFinal);
+            newTransitions[to] = makeMergedDfaState(state.isFinal, state.token);
         }
         newTransitions[to]->dfaStates.insert(dfaState);
         m_DFAToMergedDFA[dfaState->m_id] = newTransitions[to]->id;
@@ -77,90 +86,70 @@ void DFAMinimizer::splitMergedDfaState(const MergedDfaState& state, const char s
     m_mergedDfaStates.erase(state.id);
 }
 
-char DFAMinimizer::searchForAmbiguousSymbol(const MergedDfaState& mergedDfa) const {
-    std::map<char, size_t> transitions;
+/* Called for every merged state after each split, so it does not allocate */
+int32_t DFAMinimizer::searchForAmbiguousSymbol(const MergedDfaState& mergedDfa) const {
+    constexpr int32_t NONE = -1;
+    std::array<int32_t, ByteSet::NUM_BYTES> transitions;
+    transitions.fill(NONE);
     for (auto const* dfa : mergedDfa.dfaStates) {
         for (auto [sym, to] : dfa->m_transitions) {
             const auto mergedDfaStateTo = m_DFAToMergedDFA[to->m_id];
-            if (transitions.find(sym) == transitions.end()) {
+            if (transitions[sym] == NONE) {
                 transitions[sym] = mergedDfaStateTo;
             }
-            else if (transitions.at(sym) != mergedDfaStateTo) {  // has ambiguity
+            else if (transitions[sym] != mergedDfaStateTo) {  // has ambiguity
                 return sym;
             }
         }
     }
-    return 0;
+    return -1;
 }
 
+/**
+ * The states of a merged state are equivalent, so any of them gives the
+ * transitions of the row. The merged state holding the dead state becomes
+ * DFA::DEAD.
+ */
 DFA DFAMinimizer::constructMinimizedDFA() const {
-    DFA minimizedDFA;
-    for (const auto& [id, mergedDfaState] : m_mergedDfaStates) {
-        minimizedDFA.m_states.try_emplace(
-            id,
-            id, mergedDfaState.isFinal);
+    const auto deadState = m_DFAToMergedDFA[m_deadState->m_id];
+    std::pmr::map<int32_t, DFA::StateId> stateIds({{deadState, DFA::DEAD}}, m_allocator);
+    for (const auto& [id, _] : m_mergedDfaStates) {
+        stateIds.try_emplace(id, stateIds.size());
     }
 
-    for (const auto& [_, mergedDfaState] : m_mergedDfaStates) {
-        mergeTransitions(mergedDfaState, minimizedDFA);
-    }
-    const int32_t start = m_DFAToMergedDFA[0];
-    minimizedDFA.setStart(start);
-    return minimizedDFA;
-}
-
-void DFAMinimizer::mergeTransitions(const MergedDfaState& from, DFA& dfa) const {
-    auto& minimizedState = dfa.m_states.at(from.id);
-    for (auto const* dfaState : from.dfaStates) {
-        for (const auto& [sym, to] : dfaState->m_transitions) {
-            if (not minimizedState.hasTransition(sym) and to != m_deadState) {
-                auto const mergedTo = m_DFAToMergedDFA[to->m_id];
-                minimizedState.addTransition(sym, &(dfa.m_states.at(mergedTo)));
-            }
+    DFA minimizedDFA;
+    const auto numClasses = m_byteClasses.numClasses();
+    minimizedDFA.m_byteClasses = m_byteClasses;
+    minimizedDFA.m_transitions.assign(stateIds.size() * numClasses, DFA::DEAD);
+    minimizedDFA.m_finals.assign(stateIds.size(), false);
+    minimizedDFA.m_tokens.assign(stateIds.size(), NO_TOKEN);
+    for (const auto& [id, mergedDfaState] : m_mergedDfaStates) {
+        const auto from = stateIds.at(id);
+        minimizedDFA.m_finals[from] = mergedDfaState.isFinal;
+        minimizedDFA.m_tokens[from] = mergedDfaState.token;
+        for (const auto& [cls, to] : (*mergedDfaState.dfaStates.begin())->m_transitions) {
+            minimizedDFA.m_transitions[from * numClasses + cls] =
+                stateIds.at(m_DFAToMergedDFA[to->m_id]);
         }
     }
+    minimizedDFA.m_start = stateIds.at(m_DFAToMergedDFA[0]);
+    return minimizedDFA;
 }
 
 void DFAMinimizer::addDeadState(StateManager& stateManager) {
     auto& dfaStates = stateManager.m_DFAs;
-    const auto& inputSymbols = stateManager.m_inputSymbols;
-
-    const auto anyDfaStateHasNoTransition = [&dfaStates](const char sym) {
-        for (auto const& [_, dfaState] : dfaStates) {
-            if (not dfaState.hasTransition(sym)) {
-                return true;
-            }
-        }
-        return false;
-    };
-    
-    bool needDeadState = std::any_of(
-        inputSymbols.begin(),
-        inputSymbols.end(),
-        anyDfaStateHasNoTransition
-    );
-    if (not needDeadState) {
-        return;
-    }
-
     const auto& [keyValue, _] = dfaStates.try_emplace(
-        NFAStateSet(),  // Use empty set as a placeholder for key
+        NFAStateSet(m_allocator),  // Use empty set as a placeholder for key
         stateManager.m_DFAs.size(),
         false);
     m_deadState = &(keyValue->second);
     for (auto& [_, dfaState] : dfaStates) {
-        for (auto const sym : inputSymbols) {
-            if (not dfaState.hasTransition(sym)) {
-                dfaState.addTransition(sym, m_deadState);
+        for (size_t cls = 0u; cls < m_byteClasses.numClasses(); cls++) {
+            if (not dfaState.hasTransition(cls)) {
+                dfaState.addTransition(cls, m_deadState);
             }
         }
     }
 }
 
-void DFAMinimizer::removeDeadState() {
-    const auto deadState = m_DFAToMergedDFA.back();
-    assert(m_mergedDfaStates.at(deadState).dfaStates.size() == 1);
-    m_mergedDfaStates.erase(deadState);
-}
-
 } // namespace RE
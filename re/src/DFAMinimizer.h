@@ -1,9 +1,12 @@
 #pragma once
 
+#include "ByteClasses.h"
 #include "FA.h"
 
 #include <cstddef>
 #include <list>
+#include <map>
+#include <memory_resource>
 #include <set>
 #include <vector>
 
@@ -14,32 +17,38 @@ class StateManager;
 class DFAMinimizer {
 public:
     struct MergedDfaState {
-        MergedDfaState(const int32_t id, const bool isFinal)
-            : id(id), isFinal(isFinal) {}
+        using allocator_type = Allocator;
+
+        MergedDfaState(const int32_t id, const bool isFinal, const uint32_t token,
+                       const allocator_type& allocator = {})
+            : id(id), isFinal(isFinal), token(token), dfaStates(allocator) {}
         int32_t id;
         bool isFinal;
-        std::set<DFAStateFromNFA const*> dfaStates;
+        uint32_t token;
+        std::pmr::set<DFAStateFromNFA const*> dfaStates;
     };
 
 public:
+    /* Allocates from the memory resource of the states */
     DFAMinimizer(StateManager&);
     DFA minimize();
 
 private:
     void mergeFinalAndNonFinalStates(const StateManager&);
 
-    MergedDfaState* makeMergedDfaState(const bool);
-    void splitMergedDfaState(const MergedDfaState&, const char);
-    char searchForAmbiguousSymbol(const MergedDfaState&) const;
+    MergedDfaState* makeMergedDfaState(const bool, const uint32_t token = NO_TOKEN);
+    void splitMergedDfaState(const MergedDfaState&, const uint8_t);
+    /* returns -1 if all the states agree on every byte class */
+    int32_t searchForAmbiguousSymbol(const MergedDfaState&) const;
     DFA constructMinimizedDFA() const;
-    void mergeTransitions(const MergedDfaState&, DFA&) const;
 
-    std::vector<int32_t> m_DFAToMergedDFA;
-    std::map<int32_t, MergedDfaState> m_mergedDfaStates;
+    const Allocator m_allocator;
+    ByteClasses m_byteClasses;
+    std::pmr::vector<int32_t> m_DFAToMergedDFA{m_allocator};
+    std::pmr::map<int32_t, MergedDfaState> m_mergedDfaStates{m_allocator};
     int32_t m_mergedDfaStateId = 0;
 
     void addDeadState(StateManager&);  /* so that each state has an transition for each input */
-    void removeDeadState();
     DFAStateFromNFA* m_deadState = nullptr;
 };
 
@@ -0,0 +1,323 @@
+#include "DFAMinimizer.h"
+#include "DFAProduct.h"
+#include "StateManager.h"
+
+#include <algorithm>
+#include <map>
+#include <utility>
+
+namespace RE {
+
+namespace {
+
+size_t hashOf(const std::vector<DFA::StateId>& row) {
+    size_t hash = 0u;
+    for (const auto state : row) {
+        hash = (hash ^ static_cast<size_t>(state)) * 0x100000001b3ull;
+    }
+    return hash;
+}
+
+} // namespace
+
+DFA DFAProduct::combine(const DFA& a, const DFA& b, const Operation operation) {
+    return minimize(product(a, b, isFinalOf(operation), false));
+}
+
+/* The product of the DFA with itself only has the pairs of a same state */
+DFA DFAProduct::complement(const DFA& dfa) {
+    return minimize(product(dfa, dfa, [](const bool isFinal, const bool) { return not isFinal; }, false));
+}
+
+void DFAProduct::addUnion(DFA& a, const DFA& b) {
+    if (b.start() == DFA::DEAD) {
+        return;
+    }
+    if (a.m_isFrozen) {
+        a.thaw();
+    }
+    auto byteClasses = a.m_byteClasses;
+    for (size_t cls = 0u; cls < b.byteClasses().numClasses(); cls++) {
+        byteClasses.refine(b.byteClasses().bytesOf(cls));
+    }
+    const auto numClasses = byteClasses.numClasses();
+    const bool isRefined = numClasses != a.m_byteClasses.numClasses();
+    if (isRefined) {
+        std::vector<DFA::StateId> transitions;
+        transitions.reserve(a.numStates() * numClasses);
+        for (DFA::StateId state = DFA::DEAD; state < static_cast<DFA::StateId>(a.numStates()); state++) {
+            for (size_t cls = 0u; cls < numClasses; cls++) {
+                transitions.push_back(a.next(state, byteClasses.representative(cls)));
+            }
+        }
+        a.m_transitions = std::move(transitions);
+        a.m_byteClasses = byteClasses;
+        a.m_statesByRow.clear();
+    }
+
+    const auto numOld = a.numStates();
+    using Pair = std::pair<DFA::StateId, DFA::StateId>;
+    std::vector<Pair> pairs;  // of the states added, from numOld on
+    std::map<Pair, DFA::StateId> ids;
+    const auto stateOf = [&](const DFA::StateId stateA, const DFA::StateId stateB) {
+        if (stateB == DFA::DEAD) {
+            return stateA;
+        }
+        const auto [it, isNew] = ids.try_emplace(Pair{stateA, stateB}, static_cast<DFA::StateId>(numOld + pairs.size()));
+        if (isNew) {
+            pairs.emplace_back(stateA, stateB);
+        }
+        return it->second;
+    };
+    auto start = stateOf(a.m_start, b.start());
+    for (size_t i = 0u; i < pairs.size(); i++) {
+        const auto [stateA, stateB] = pairs[i];
+        const bool isFinal = a.isFinal(stateA) or b.isFinal(stateB);
+        a.m_finals.push_back(isFinal);
+        a.m_tokens.push_back(isFinal ? 0u : NO_TOKEN);
+        for (size_t cls = 0u; cls < numClasses; cls++) {
+            const auto to = stateOf(a.nextByClass(stateA, cls), b.next(stateB, byteClasses.representative(cls)));
+            a.m_transitions.push_back(to);
+        }
+    }
+
+    std::vector<DFA::StateId> pairedStates;
+    for (const auto& [stateA, _] : pairs) {
+        pairedStates.push_back(stateA);
+    }
+    const auto representatives = mergeAdded(a, numOld, pairedStates);
+
+    // the states added representing themselves are kept, numbered from numOld on
+    std::vector<DFA::StateId> keptIds(pairs.size(), DFA::DEAD);
+    auto numStates = numOld;
+    for (size_t i = 0u; i < pairs.size(); i++) {
+        if (static_cast<size_t>(representatives[i]) != numOld + i) {
+            continue;
+        }
+        keptIds[i] = static_cast<DFA::StateId>(numStates);
+        a.m_finals[numStates] = a.m_finals[numOld + i];
+        a.m_tokens[numStates] = a.m_tokens[numOld + i];
+        std::copy_n(a.m_transitions.begin() + (numOld + i) * numClasses, numClasses,
+                    a.m_transitions.begin() + numStates * numClasses);
+        numStates++;
+    }
+    a.m_finals.resize(numStates);
+    a.m_tokens.resize(numStates);
+    a.m_transitions.resize(numStates * numClasses);
+    const auto idOf = [&](const DFA::StateId state) {
+        if (static_cast<size_t>(state) < numOld) {
+            return state;
+        }
+        const auto representative = representatives[state - numOld];
+        return static_cast<size_t>(representative) < numOld ? representative : keptIds[representative - numOld];
+    };
+    // only the rows added lead to the states added
+    for (auto slot = numOld * numClasses; slot < a.m_transitions.size(); slot++) {
+        a.m_transitions[slot] = idOf(a.m_transitions[slot]);
+    }
+    a.m_start = idOf(start);
+    if (not a.m_statesByRow.empty()) {
+        for (auto state = static_cast<DFA::StateId>(numOld); state < static_cast<DFA::StateId>(numStates); state++) {
+            a.m_statesByRow.emplace(hashOf(rowOf(a, state)), state);
+        }
+    }
+
+    // the rows of the old states are unchanged, and those no longer reached are left for the next build
+    if (not isRefined and numOld >= MIN_NUM_STATES_APPENDED) {
+        a.accelerate(static_cast<DFA::StateId>(numOld));
+        if (a.compressAdded()) {
+            return;
+        }
+    }
+    a.renumber(a.breadthFirstOrder(false));
+    a.accelerate();
+    a.compress();
+}
+
+std::vector<DFA::StateId> DFAProduct::rowOf(const DFA& a, const DFA::StateId state) {
+    const auto numClasses = a.m_byteClasses.numClasses();
+    std::vector<DFA::StateId> row{a.m_finals[state]};
+    row.insert(row.end(), a.m_transitions.begin() + state * numClasses,
+               a.m_transitions.begin() + (state + 1) * numClasses);
+    return row;
+}
+
+/**
+ * A state added is first assumed to accept as the state of a it pairs,
+ * until one of its transitions or its finality disproves it, which leaves
+ * the states to which the new branch adds nothing. The others are then
+ * split by finality and by the blocks of their successors until no block
+ * splits, the states of a, minimal, each being a block of their own.
+ * Last, a block whose successors are all states of a is the state of a
+ * with the same row, if any, as a shared suffix of the new branch, looked
+ * up by the hash of its row in the index kept by a.
+ */
+std::vector<DFA::StateId> DFAProduct::mergeAdded(DFA& a, const size_t numOld,
+                                                 const std::vector<DFA::StateId>& pairedStates) {
+    const auto numClasses = a.m_byteClasses.numClasses();
+    const auto numAdded = pairedStates.size();
+    std::vector<bool> isAsPaired(numAdded);
+    for (size_t i = 0u; i < numAdded; i++) {
+        isAsPaired[i] = a.m_finals[numOld + i] == a.m_finals[pairedStates[i]];
+    }
+    const auto asPaired = [&](const DFA::StateId state) {
+        const auto i = static_cast<size_t>(state) - numOld;
+        return static_cast<size_t>(state) >= numOld and isAsPaired[i] ? pairedStates[i] : state;
+    };
+    for (bool isChanged = true; isChanged;) {
+        isChanged = false;
+        for (size_t i = 0u; i < numAdded; i++) {
+            for (size_t cls = 0u; isAsPaired[i] and cls < numClasses; cls++) {
+                if (asPaired(a.m_transitions[(numOld + i) * numClasses + cls]) !=
+                    a.m_transitions[pairedStates[i] * numClasses + cls])
+                {
+                    isAsPaired[i] = false;
+                    isChanged = true;
+                }
+            }
+        }
+    }
+
+    // blocks from numOld on for the states added, the states of a keeping their ids
+    std::vector<DFA::StateId> blocks(numAdded);
+    for (size_t i = 0u; i < numAdded; i++) {
+        blocks[i] = isAsPaired[i] ? pairedStates[i] : static_cast<DFA::StateId>(numOld + a.m_finals[numOld + i]);
+    }
+    const auto blockOf = [&](const DFA::StateId state) {
+        return static_cast<size_t>(state) < numOld ? state : blocks[state - numOld];
+    };
+    for (size_t numBlocks = 0u;;) {
+        std::map<std::vector<DFA::StateId>, DFA::StateId> blockOfSignature;
+        std::vector<DFA::StateId> split(numAdded);
+        for (size_t i = 0u; i < numAdded; i++) {
+            if (isAsPaired[i]) {
+                split[i] = blocks[i];
+                continue;
+            }
+            std::vector<DFA::StateId> signature{blocks[i]};
+            for (size_t cls = 0u; cls < numClasses; cls++) {
+                signature.push_back(blockOf(a.m_transitions[(numOld + i) * numClasses + cls]));
+            }
+            split[i] = blockOfSignature.try_emplace(std::move(signature),
+                                                    static_cast<DFA::StateId>(numOld + blockOfSignature.size())).first->second;
+        }
+        blocks = std::move(split);
+        if (blockOfSignature.size() == numBlocks) {
+            break;
+        }
+        numBlocks = blockOfSignature.size();
+    }
+
+    // a block of states added is represented by the first of them
+    std::map<DFA::StateId, DFA::StateId> firstOfBlock;
+    std::vector<DFA::StateId> representatives(numAdded);
+    for (size_t i = 0u; i < numAdded; i++) {
+        representatives[i] = isAsPaired[i] ?
+                             pairedStates[i] :
+                             firstOfBlock.try_emplace(blocks[i], static_cast<DFA::StateId>(numOld + i)).first->second;
+    }
+
+    // a state added whose successors are all states of a may be one of them, e.g. a shared suffix
+    const auto representativeOf = [&](const DFA::StateId state) {
+        return static_cast<size_t>(state) < numOld ? state : representatives[state - numOld];
+    };
+    for (bool isChanged = true; isChanged;) {
+        isChanged = false;
+        for (size_t i = 0u; i < numAdded; i++) {
+            if (static_cast<size_t>(representatives[i]) < numOld) {
+                continue;
+            }
+            auto row = rowOf(a, static_cast<DFA::StateId>(numOld + i));
+            std::transform(row.begin() + 1, row.end(), row.begin() + 1, representativeOf);
+            if (std::any_of(row.begin() + 1, row.end(), [numOld](const DFA::StateId to) {
+                    return static_cast<size_t>(to) >= numOld;
+                })) {
+                continue;
+            }
+            if (a.m_statesByRow.empty()) {
+                for (DFA::StateId state = DFA::DEAD; state < static_cast<DFA::StateId>(numOld); state++) {
+                    a.m_statesByRow.emplace(hashOf(rowOf(a, state)), state);
+                }
+            }
+            const auto [begin, end] = a.m_statesByRow.equal_range(hashOf(row));
+            const auto it = std::find_if(begin, end, [&](const auto& entry) {
+                return rowOf(a, entry.second) == row;
+            });
+            if (it != end) {
+                representatives[i] = it->second;
+                isChanged = true;
+            }
+        }
+    }
+    return representatives;
+}
+
+bool DFAProduct::isEmpty(const DFA& a, const DFA& b, const Operation operation) {
+    const auto partial = product(a, b, isFinalOf(operation), true);
+    return std::none_of(partial.m_finals.begin(), partial.m_finals.end(), [](const bool isFinal) { return isFinal; });
+}
+
+DFAProduct::IsFinal_t DFAProduct::isFinalOf(const Operation operation) {
+    switch (operation) {
+    case Operation::intersection:
+        return [](const bool a, const bool b) { return a and b; };
+    case Operation::union_:
+        return [](const bool a, const bool b) { return a or b; };
+    default:
+        return [](const bool a, const bool b) { return a and not b; };
+    }
+}
+
+/**
+ * The pairs are numbered from 1 as they are reached from the pair of the
+ * starts, and state 0 is left without transitions, as the dead states of
+ * the DFAs may make a final pair, e.g. for the complement. Pairs which
+ * cannot reach a final one are merged into the dead state by the
+ * minimization.
+ */
+DFA DFAProduct::product(const DFA& a, const DFA& b, const IsFinal_t isFinal, const bool stopAtFinal) {
+    DFA product;
+    for (size_t cls = 0u; cls < a.byteClasses().numClasses(); cls++) {
+        product.m_byteClasses.refine(a.byteClasses().bytesOf(cls));
+    }
+    for (size_t cls = 0u; cls < b.byteClasses().numClasses(); cls++) {
+        product.m_byteClasses.refine(b.byteClasses().bytesOf(cls));
+    }
+    const auto numClasses = product.m_byteClasses.numClasses();
+
+    using Pair = std::pair<DFA::StateId, DFA::StateId>;
+    std::vector<Pair> pairs{{DFA::DEAD, DFA::DEAD}, {a.start(), b.start()}};
+    std::map<Pair, DFA::StateId> ids{{pairs[1], 1}};
+    product.m_finals.assign(2u, false);
+    product.m_transitions.assign(2u * numClasses, DFA::DEAD);
+    for (size_t id = 1u; id < pairs.size(); id++) {
+        const auto [stateA, stateB] = pairs[id];
+        product.m_finals[id] = isFinal(a.isFinal(stateA), b.isFinal(stateB));
+        if (stopAtFinal and product.m_finals[id]) {
+            break;
+        }
+        for (size_t cls = 0u; cls < numClasses; cls++) {
+            const auto byte = product.m_byteClasses.representative(cls);
+            const Pair to{a.next(stateA, byte), b.next(stateB, byte)};
+            const auto [it, isNew] = ids.try_emplace(to, static_cast<DFA::StateId>(pairs.size()));
+            if (isNew) {
+                pairs.push_back(to);
+                product.m_finals.push_back(false);
+                product.m_transitions.resize(pairs.size() * numClasses, DFA::DEAD);
+            }
+            product.m_transitions[id * numClasses + cls] = it->second;
+        }
+    }
+    product.m_tokens.assign(pairs.size(), NO_TOKEN);
+    product.m_start = 1;
+    return product;
+}
+
+DFA DFAProduct::minimize(const DFA& product) {
+    StateManager stateManager;
+    const auto nfa = stateManager.makeFromDFA(product, product.m_finals, false);
+    stateManager.DFAFromNFA(nfa.startState);
+    return DFAMinimizer(stateManager).minimize();
+}
+
+} // namespace RE
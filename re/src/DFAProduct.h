@@ -0,0 +1,60 @@
+#pragma once
+
+#include "FA.h"
+
+namespace RE {
+
+/**
+ * Boolean operations on the languages of DFAs by the product construction:
+ * a state of the product is a pair of states, one of each DFA, read over
+ * the common refinement of their byte classes, and final as the operation
+ * says of the finality of the pair. The product is minimized again, and the
+ * decisions explore it without building it.
+ *
+ * The DFAs must not be frozen, see DFA::thawedCopy.
+ */
+class DFAProduct {
+public:
+    enum class Operation { intersection, union_, difference };
+
+    static DFA combine(const DFA&, const DFA&, const Operation);
+    /* Over all the byte strings, e.g. invalid UTF-8 for a UTF-8 pattern */
+    static DFA complement(const DFA&);
+
+    /**
+     * The union built into a, frozen or not, reusing its states: the pair
+     * of a state of a with the dead state of b is that state, so only the
+     * pairs where b is alive are made, and the work grows with them rather
+     * than with a. The new states are merged into the states of a they
+     * accept the same as, and among themselves, which may leave a few more
+     * states than the minimal DFA, e.g. for a new branch looping back into
+     * the states of a. The rows of the states of a are unchanged, so those
+     * of the new states are appended to the table of a large DFA, the
+     * states no longer reached being only dropped when the table is built
+     * again, see DFA::compressAdded.
+     */
+    static void addUnion(DFA& a, const DFA& b);
+
+    /* Whether the product of the DFAs accepts no string */
+    static bool isEmpty(const DFA&, const DFA&, const Operation);
+    /* Whether every string accepted by a is accepted by b */
+    static bool isSubset(const DFA& a, const DFA& b) { return isEmpty(a, b, Operation::difference); }
+
+private:
+    using IsFinal_t = bool (*)(const bool, const bool);
+
+    /* Below, building the table again costs about as much as the new states */
+    static constexpr size_t MIN_NUM_STATES_APPENDED = 1024u;
+
+    static IsFinal_t isFinalOf(const Operation);
+    /* Stops at the first final pair if asked to, leaving the product partial */
+    static DFA product(const DFA&, const DFA&, const IsFinal_t, const bool stopAtFinal);
+    static DFA minimize(const DFA&);
+    /* The representative of each state added to a, from the state numOld on */
+    static std::vector<DFA::StateId> mergeAdded(DFA& a, const size_t numOld,
+                                                const std::vector<DFA::StateId>& pairedStates);
+    /* The finality of the state then its transitions */
+    static std::vector<DFA::StateId> rowOf(const DFA&, const DFA::StateId);
+};
+
+} // namespace RE
@@ -0,0 +1,131 @@
+#include "DFATable.h"
+
+#include <utility>
+
+namespace RE {
+
+namespace {
+
+/* the offsets tried for a row among the holes before it goes past the used slots */
+constexpr size_t MAX_PROBES = 1024u;
+
+/**
+ * The first free index from any index, each used index pointing past
+ * itself as in a union-find, so that the runs of used indices are skipped
+ * rather than walked
+ */
+class FreeIndices {
+public:
+    bool isFree(const size_t index) const { return index >= m_next.size() or m_next[index] == index; }
+
+    size_t firstFrom(size_t index) {
+        auto free = index;
+        while (not isFree(free)) {
+            free = m_next[free];
+        }
+        while (index != free) {
+            index = std::exchange(m_next[index], free);
+        }
+        return free;
+    }
+
+    void use(const size_t index) {
+        for (auto i = m_next.size(); i <= index + 1u; i++) {
+            m_next.push_back(i);
+        }
+        m_next[index] = index + 1u;
+    }
+
+private:
+    std::vector<size_t> m_next;  // itself if free
+};
+
+} // namespace
+
+DFALayout::DFALayout(const std::vector<int32_t>& transitions, const size_t numClasses, const int32_t start) {
+    const auto numStates = numClasses == 0u ? 0u : transitions.size() / numClasses;
+    offsets.assign(numStates, 0u);
+    if (numStates * numClasses <= MAX_DENSE_TABLE_SIZE) {
+        for (size_t state = 0u; state < numStates; state++) {
+            offsets[state] = state * numClasses;
+        }
+        denseEnd = numSlots = numStates * numClasses;
+        return;
+    }
+
+    std::vector<std::vector<uint8_t>> liveClasses(numStates);
+    for (size_t state = 0u; state < numStates; state++) {
+        for (size_t cls = 0u; cls < numClasses; cls++) {
+            if (transitions[state * numClasses + cls] != 0) {
+                liveClasses[state].push_back(cls);
+            }
+        }
+    }
+
+    // the dead state stays at 0 with a dense row of dead transitions
+    std::vector<size_t> packed;
+    for (size_t state = 1u; state < numStates; state++) {
+        if (static_cast<int32_t>(state) == start or liveClasses[state].size() * 2u >= numClasses) {
+            offsets[state] = denseEnd += numClasses;
+        }
+        else {
+            packed.push_back(state);
+        }
+    }
+    denseEnd += numClasses;
+
+    // the fullest rows first, as they are the hardest to fit
+    std::stable_sort(packed.begin(), packed.end(), [&liveClasses](const size_t a, const size_t b) {
+        return liveClasses[a].size() > liveClasses[b].size();
+    });
+    FreeIndices freeSlots;
+    FreeIndices freeOffsets;
+    size_t endOfUsed = 0u;  // past the last used slot
+    // by the first class of a row, the slots below are used or their offset for the class is
+    std::vector<size_t> firstFits(numClasses, 0u);
+    for (const auto state : packed) {
+        const auto& classes = liveClasses[state];
+        size_t offset = freeOffsets.firstFrom(0u);
+        if (not classes.empty()) {
+            // the first class on a free slot, the row on an unused offset, then the other classes
+            const size_t first = classes.front();
+            auto& firstFit = firstFits[first];
+            offset = std::max(firstFit, first) - first;
+            bool isFirstFit = true;  // nothing skipped which another row starting with the class could take
+            for (size_t numProbes = 0u;; numProbes += not isFirstFit) {
+                if (numProbes == MAX_PROBES) {
+                    // the holes left behind rarely fit the row, unlike the free slots past the used ones
+                    offset = std::max(offset, endOfUsed - std::min(endOfUsed, first));
+                }
+                offset = freeOffsets.firstFrom(offset);
+                const auto slot = freeSlots.firstFrom(offset + first);
+                if (slot != offset + first) {
+                    offset = slot - first;
+                    continue;
+                }
+                if (isFirstFit) {
+                    firstFit = slot;
+                }
+                if (std::all_of(classes.begin() + 1, classes.end(), [&](const uint8_t cls) {
+                        return freeSlots.isFree(offset + cls);
+                    })) {
+                    break;
+                }
+                isFirstFit = false;
+                offset++;
+            }
+        }
+        freeOffsets.use(offset);
+        for (const auto cls : classes) {
+            freeSlots.use(offset + cls);
+        }
+        if (not classes.empty()) {
+            endOfUsed = std::max(endOfUsed, offset + classes.back() + 1u);
+        }
+        offsets[state] = denseEnd + offset;
+        numSlots = std::max(numSlots, offsets[state] + numClasses);
+    }
+    numSlots = std::max(numSlots, denseEnd);
+}
+
+} // namespace RE
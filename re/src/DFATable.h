@@ -0,0 +1,233 @@
+#pragma once
+
+#include "ByteScan.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace RE {
+
+/**
+ * Where the rows of the states go in a DFATable. A state is represented by
+ * the offset of its row, the dead state by the offset 0.
+ *
+ * The rows of the hot states, i.e. the start state and the states reading
+ * most of the byte classes, such as the loop of .*, are dense and come
+ * first. The other rows only keep their transitions to live states and are
+ * packed after them by row displacement: a row is placed at the first
+ * offset where its live entries fall on free slots, and a slot belongs to
+ * the row whose offset is its check. The runs of used slots and offsets
+ * are skipped rather than walked, and a row fitting none of the first holes
+ * goes past the used slots, which keeps the packing linear in the states.
+ * A table small enough for the L1 cache is left dense.
+ */
+struct DFALayout {
+    static constexpr size_t MAX_DENSE_TABLE_SIZE = 4u << 10;  // slots
+
+    DFALayout(const std::vector<int32_t>& transitions, const size_t numClasses, const int32_t start);
+
+    std::vector<size_t> offsets;  // by state
+    size_t denseEnd = 0u;         // the slots below have no check
+    size_t numSlots = 0u;
+};
+
+/**
+ * The transition table the matching runs on, built from the dense table of
+ * the minimized DFA. The offsets are stored as the narrowest unsigned type
+ * holding them, so that most DFAs take one or two bytes per slot, and a
+ * step is a single load without a multiplication.
+ *
+ * A dense table over few byte classes also gets a stride-2 table, reading
+ * two bytes per load: the state reached from the row at offset by the
+ * classes c1 then c2 is at (offset + c1) * numClasses + c2, i.e. in the
+ * dense table scaled by numClasses.
+ */
+template <typename Offset>
+class DFATable {
+public:
+    using Offset_t = Offset;
+    static constexpr Offset_t DEAD = 0u;
+    /* the squared alphabet is kept to 256 pairs of classes */
+    static constexpr size_t MAX_STRIDE_NUM_CLASSES = 16u;
+    static constexpr size_t MAX_STRIDE_TABLE_SIZE = 16u << 10;  // slots
+
+    DFATable() = default;
+    DFATable(const DFALayout& layout, const std::vector<int32_t>& transitions, const size_t numClasses,
+             const std::vector<bool>& finals, const std::vector<uint32_t>& tokens,
+             const std::vector<uint8_t>& isAccelerated, const std::vector<ByteScan::Needles>& exits) :
+        m_denseEnd(layout.denseEnd),
+        m_numClasses(numClasses),
+        m_next(layout.numSlots, DEAD),
+        m_check(layout.numSlots - layout.denseEnd, DEAD),
+        m_isFinal(layout.numSlots, false),
+        m_isAccelerated(layout.numSlots, false)
+    {
+        for (const auto offset : layout.offsets) {
+            m_offsets.push_back(static_cast<Offset_t>(offset));
+        }
+        for (size_t state = 0u; state < m_offsets.size(); state++) {
+            fillRow(state, transitions, finals, tokens, isAccelerated, exits);
+        }
+        if (layout.denseEnd == layout.numSlots and numClasses <= MAX_STRIDE_NUM_CLASSES and
+            layout.numSlots * numClasses <= MAX_STRIDE_TABLE_SIZE)
+        {
+            buildStride2(layout, transitions, finals);
+        }
+        const auto byOffset = [](const auto& a, const auto& b) { return a.first < b.first; };
+        std::sort(m_exits.begin(), m_exits.end(), byOffset);
+        std::sort(m_tokens.begin(), m_tokens.end(), byOffset);
+    }
+
+    /**
+     * Pack the rows of the states from numStates() on past the used slots,
+     * the rows already in the table being unchanged, unless the table is
+     * dense or an offset would not fit in Offset_t. Each row goes past the
+     * last offset, as the offsets must stay unique, which leaves more holes
+     * than DFALayout does: the table is to be laid out again from time to time.
+     */
+    bool append(const std::vector<int32_t>& transitions, const std::vector<bool>& finals,
+                const std::vector<uint32_t>& tokens, const std::vector<uint8_t>& isAccelerated,
+                const std::vector<ByteScan::Needles>& exits) {
+        if (m_denseEnd == m_next.size()) {
+            return false;
+        }
+        // no offset is above numSlots - m_numClasses, see DFALayout
+        auto numSlots = m_next.size();
+        auto endOfUsed = numSlots;
+        while (endOfUsed > m_denseEnd and m_check[endOfUsed - 1u - m_denseEnd] == DEAD) {
+            endOfUsed--;
+        }
+        std::vector<size_t> offsets;
+        for (auto state = m_offsets.size(); state < finals.size(); state++) {
+            size_t first = m_numClasses, last = 0u;
+            for (size_t cls = 0u; cls < m_numClasses; cls++) {
+                if (transitions[state * m_numClasses + cls] != 0) {
+                    first = std::min(first, cls);
+                    last = cls;
+                }
+            }
+            auto offset = numSlots - m_numClasses + 1u;
+            if (first < m_numClasses) {
+                offset = std::max(offset, endOfUsed - std::min(endOfUsed, first));
+                endOfUsed = offset + last + 1u;
+            }
+            offsets.push_back(offset);
+            numSlots = offset + m_numClasses;
+        }
+        if (numSlots - m_numClasses > std::numeric_limits<Offset_t>::max()) {
+            return false;
+        }
+
+        m_next.resize(numSlots, DEAD);
+        m_check.resize(numSlots - m_denseEnd, DEAD);
+        m_isFinal.resize(numSlots, false);
+        m_isAccelerated.resize(numSlots, false);
+        const auto numOld = m_offsets.size();
+        for (const auto offset : offsets) {
+            m_offsets.push_back(static_cast<Offset_t>(offset));
+        }
+        // past the offsets in the table, so the sorted vectors stay sorted
+        for (auto state = numOld; state < m_offsets.size(); state++) {
+            fillRow(state, transitions, finals, tokens, isAccelerated, exits);
+        }
+        return true;
+    }
+
+    size_t numStates() const { return m_offsets.size(); }
+    Offset_t offsetOf(const int32_t state) const { return m_offsets[state]; }
+
+    Offset_t next(const Offset_t offset, const uint8_t cls) const {
+        const size_t slot = size_t(offset) + cls;
+        if (offset < m_denseEnd) {
+            return m_next[slot];
+        }
+        // a packed row does not own the slots of its dead transitions
+        return m_check[slot - m_denseEnd] == offset ? m_next[slot] : DEAD;
+    }
+    bool hasStride2() const { return not m_next2.empty(); }
+    Offset_t next2(const Offset_t offset, const uint8_t cls1, const uint8_t cls2) const {
+        return m_next2[(size_t(offset) + cls1) * m_numClasses + cls2];
+    }
+    /* A double step from the state may skip a final state */
+    bool isBeforeFinal(const Offset_t offset) const { return m_isBeforeFinal[offset]; }
+    bool isFinal(const Offset_t offset) const { return m_isFinal[offset]; }
+    bool isAccelerated(const Offset_t offset) const { return m_isAccelerated[offset]; }
+    const ByteScan::Needles& exits(const Offset_t offset) const {
+        return std::lower_bound(m_exits.begin(), m_exits.end(), offset, [](const auto& exit, const Offset_t o) {
+            return exit.first < o;
+        })->second;
+    }
+    /* Of a final state; only the tokens of the rules after the first are kept */
+    uint32_t tokenOf(const Offset_t offset) const {
+        const auto it = std::lower_bound(m_tokens.begin(), m_tokens.end(), offset, [](const auto& token, const Offset_t o) {
+            return token.first < o;
+        });
+        return it != m_tokens.end() and it->first == offset ? it->second : 0u;
+    }
+
+    size_t numBytes() const {
+        return (m_offsets.size() + m_next.size() + m_check.size() + m_next2.size()) * sizeof(Offset_t) +
+               (m_isFinal.size() + m_isAccelerated.size() + m_isBeforeFinal.size()) / 8u +
+               m_exits.size() * sizeof(m_exits.front()) + m_tokens.size() * sizeof(m_tokens.front());
+    }
+
+private:
+    void fillRow(const size_t state, const std::vector<int32_t>& transitions, const std::vector<bool>& finals,
+                 const std::vector<uint32_t>& tokens, const std::vector<uint8_t>& isAccelerated,
+                 const std::vector<ByteScan::Needles>& exits) {
+        const auto offset = m_offsets[state];
+        m_isFinal[offset] = finals[state];
+        if (finals[state] and tokens[state] != 0u) {
+            m_tokens.emplace_back(offset, tokens[state]);
+        }
+        m_isAccelerated[offset] = isAccelerated[state];
+        if (isAccelerated[state]) {
+            m_exits.emplace_back(offset, exits[state]);
+        }
+        for (size_t cls = 0u; cls < m_numClasses; cls++) {
+            const auto to = transitions[state * m_numClasses + cls];
+            if (to == 0 and offset >= m_denseEnd) {
+                continue;
+            }
+            m_next[offset + cls] = m_offsets[to];
+            if (offset >= m_denseEnd) {
+                m_check[offset + cls - m_denseEnd] = offset;
+            }
+        }
+    }
+
+    void buildStride2(const DFALayout& layout, const std::vector<int32_t>& transitions,
+                      const std::vector<bool>& finals) {
+        m_next2.assign(layout.numSlots * m_numClasses, DEAD);
+        m_isBeforeFinal.assign(layout.numSlots, false);
+        for (size_t state = 0u; state < layout.offsets.size(); state++) {
+            const auto offset = layout.offsets[state];
+            for (size_t cls1 = 0u; cls1 < m_numClasses; cls1++) {
+                const auto middle = transitions[state * m_numClasses + cls1];
+                m_isBeforeFinal[offset] = m_isBeforeFinal[offset] or finals[middle];
+                for (size_t cls2 = 0u; cls2 < m_numClasses; cls2++) {
+                    const auto to = transitions[middle * m_numClasses + cls2];
+                    m_next2[(offset + cls1) * m_numClasses + cls2] = static_cast<Offset_t>(layout.offsets[to]);
+                }
+            }
+        }
+    }
+
+    size_t m_denseEnd = 0u;
+    size_t m_numClasses = 0u;
+    std::vector<Offset_t> m_offsets;  // by state
+    std::vector<Offset_t> m_next;     // by slot
+    std::vector<Offset_t> m_check;    // by slot from m_denseEnd
+    std::vector<bool> m_isFinal;      // by offset
+    std::vector<bool> m_isAccelerated;
+    std::vector<Offset_t> m_next2;       // by slot and byte class, if any
+    std::vector<bool> m_isBeforeFinal;  // by offset, if m_next2
+    std::vector<std::pair<Offset_t, ByteScan::Needles>> m_exits;  // sorted by offset
+    std::vector<std::pair<Offset_t, uint32_t>> m_tokens;          // sorted by offset
+};
+
+} // namespace RE
@@ -0,0 +1,327 @@
+#include "DerivativeDFA.h"
+#include "UTF8.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace RE {
+
+size_t DerivativeDFA::Hash::operator()(const Expression& expression) const {
+    auto hash = static_cast<size_t>(expression.type) * 0x9e3779b97f4a7c15ull ^ expression.bytes.hash();
+    for (const auto child : expression.children) {
+        hash = (hash ^ child) * 0x100000001b3ull;
+    }
+    return hash;
+}
+
+/**
+ * The states are the expressions reached from the one of the pattern, in
+ * breadth-first order, ∅ being the dead state whether reached or not
+ */
+DFA DerivativeDFA::make(const AST::Node& ast) {
+    intern(Expression{Expression::Type::nothing, {}, {}, false});
+    intern(Expression{Expression::Type::epsilon, {}, {}, true});
+    const auto start = expressionOf(ast);
+
+    DFA dfa;
+    dfa.m_byteClasses = m_byteClasses;
+    const auto numClasses = m_byteClasses.numClasses();
+    std::unordered_map<ExprId, DFA::StateId> stateOf{{NOTHING, DFA::DEAD}};
+    std::vector<ExprId> states{NOTHING};
+    const auto stateOfExpression = [&](const ExprId expression) {
+        const auto [it, isNew] = stateOf.try_emplace(expression, static_cast<DFA::StateId>(states.size()));
+        if (isNew) {
+            states.push_back(expression);
+        }
+        return it->second;
+    };
+    dfa.m_start = stateOfExpression(start);
+    for (size_t state = 0u; state < states.size(); state++) {
+        const auto expression = states[state];
+        dfa.m_finals.push_back(m_expressions[expression].isNullable);
+        dfa.m_tokens.push_back(dfa.m_finals.back() ? 0u : NO_TOKEN);
+        for (size_t cls = 0u; cls < numClasses; cls++) {
+            dfa.m_transitions.push_back(stateOfExpression(derivative(expression, cls)));
+        }
+    }
+    m_numStatesBuilt = dfa.numStates();
+    if (m_numStatesBuilt >= MIN_NUM_STATES_MINIMIZED) {
+        minimize(dfa);
+    }
+    dfa.accelerate();
+    dfa.compress();
+    return dfa;
+}
+
+/**
+ * Moore's algorithm: the states are split by finality, then each round
+ * splits the blocks by the blocks the transitions of their states go to,
+ * until a round splits none. The rounds are as many as the length of the
+ * shortest strings telling two states apart. Each state is then replaced
+ * by the first state of its block, the dead state's being the dead state,
+ * and the states no longer reached are dropped.
+ */
+void DerivativeDFA::minimize(DFA& dfa) {
+    const auto numClasses = dfa.m_byteClasses.numClasses();
+    const auto numStates = dfa.numStates();
+    const auto rowSize = numClasses + 1u;
+    std::vector<DFA::StateId> blockOf(numStates);
+    for (size_t state = 0u; state < numStates; state++) {
+        blockOf[state] = dfa.m_finals[state] != dfa.m_finals[DFA::DEAD];
+    }
+    // the block of each state then those its transitions go to
+    std::vector<DFA::StateId> rows(numStates * rowSize);
+    const auto rowOf = [&rows, rowSize](const size_t state) { return rows.begin() + state * rowSize; };
+    const auto hash = [&rowOf, rowSize](const size_t state) {
+        size_t hash = 0u;
+        std::for_each(rowOf(state), rowOf(state) + rowSize, [&hash](const DFA::StateId block) {
+            hash = (hash ^ static_cast<size_t>(block)) * 0x100000001b3ull;
+        });
+        return hash;
+    };
+    const auto isEqual = [&rowOf, rowSize](const size_t a, const size_t b) {
+        return std::equal(rowOf(a), rowOf(a) + rowSize, rowOf(b));
+    };
+    std::unordered_map<size_t, DFA::StateId, decltype(hash), decltype(isEqual)> blocks(numStates, hash, isEqual);
+    std::vector<DFA::StateId> firstStates;  // by block
+    for (size_t numBlocks = 0u;;) {
+        for (size_t state = 0u; state < numStates; state++) {
+            auto row = rowOf(state);
+            row[0] = blockOf[state];
+            for (size_t cls = 0u; cls < numClasses; cls++) {
+                row[cls + 1u] = blockOf[dfa.m_transitions[state * numClasses + cls]];
+            }
+        }
+        blocks.clear();
+        firstStates.clear();
+        for (size_t state = 0u; state < numStates; state++) {
+            const auto [it, isNew] = blocks.try_emplace(state, static_cast<DFA::StateId>(firstStates.size()));
+            if (isNew) {
+                firstStates.push_back(static_cast<DFA::StateId>(state));
+            }
+            blockOf[state] = it->second;
+        }
+        if (firstStates.size() == numBlocks) {
+            break;
+        }
+        numBlocks = firstStates.size();
+    }
+
+    for (auto& to : dfa.m_transitions) {
+        to = firstStates[blockOf[to]];
+    }
+    dfa.m_start = firstStates[blockOf[dfa.m_start]];
+    dfa.renumber(dfa.breadthFirstOrder(false));
+}
+
+DerivativeDFA::ExprId DerivativeDFA::intern(Expression expression) {
+    const auto [it, isNew] = m_ids.try_emplace(expression, static_cast<ExprId>(m_expressions.size()));
+    if (isNew) {
+        m_expressions.push_back(std::move(expression));
+    }
+    return it->second;
+}
+
+DerivativeDFA::ExprId DerivativeDFA::makeBytes(const ByteSet& bytes) {
+    if (bytes.isEmpty()) {
+        return NOTHING;
+    }
+    m_byteClasses.refine(bytes);
+    return intern(Expression{Expression::Type::bytes, bytes, {}, false});
+}
+
+/* Right-nested: (ab)c is a(bc) */
+DerivativeDFA::ExprId DerivativeDFA::makeConcatenation(const ExprId a, const ExprId b) {
+    if (a == NOTHING or b == NOTHING) {
+        return NOTHING;
+    }
+    if (a == EPSILON) {
+        return b;
+    }
+    if (b == EPSILON) {
+        return a;
+    }
+    if (m_expressions[a].type == Expression::Type::concatenation) {
+        const auto [first, rest] = std::make_pair(m_expressions[a].children[0], m_expressions[a].children[1]);
+        return makeConcatenation(first, makeConcatenation(rest, b));
+    }
+    const auto isNullable = m_expressions[a].isNullable and m_expressions[b].isNullable;
+    return intern(Expression{Expression::Type::concatenation, {}, {a, b}, isNullable});
+}
+
+/* ε is dropped next to another nullable alternative, e.g. ε|a* is a* */
+DerivativeDFA::ExprId DerivativeDFA::makeAlternation(std::vector<ExprId> alternatives) {
+    std::vector<ExprId> children;
+    ByteSet bytes;
+    bool hasEpsilon = false;
+    bool isNullable = false;
+    for (size_t i = 0u; i < alternatives.size(); i++) {
+        const auto& expression = m_expressions[alternatives[i]];
+        switch (expression.type) {
+        case Expression::Type::nothing:
+            break;
+        case Expression::Type::epsilon:
+            hasEpsilon = true;
+            break;
+        case Expression::Type::bytes:
+            bytes.add(expression.bytes);
+            break;
+        case Expression::Type::alternation:
+            alternatives.insert(alternatives.end(), expression.children.begin(), expression.children.end());
+            break;
+        default:
+            children.push_back(alternatives[i]);
+            isNullable = isNullable or expression.isNullable;
+        }
+    }
+    if (not bytes.isEmpty()) {
+        children.push_back(makeBytes(bytes));
+    }
+    if (hasEpsilon and not isNullable) {
+        children.push_back(EPSILON);
+        isNullable = true;
+    }
+    std::sort(children.begin(), children.end());
+    children.erase(std::unique(children.begin(), children.end()), children.end());
+    if (children.empty()) {
+        return NOTHING;
+    }
+    if (children.size() == 1u) {
+        return children.front();
+    }
+    return intern(Expression{Expression::Type::alternation, {}, std::move(children), isNullable});
+}
+
+DerivativeDFA::ExprId DerivativeDFA::makeStar(const ExprId a) {
+    if (a == NOTHING or a == EPSILON) {
+        return EPSILON;
+    }
+    if (m_expressions[a].type == Expression::Type::star) {
+        return a;
+    }
+    return intern(Expression{Expression::Type::star, {}, {a}, true});
+}
+
+/* r{2,4} is rr(r(r)?)? and r{2,} is rrr* */
+DerivativeDFA::ExprId DerivativeDFA::expressionOf(const AST::Node& node) {
+    switch (node.type) {
+    case AST::Node::Type::empty:
+        return EPSILON;
+    case AST::Node::Type::literal: {
+        std::vector<uint8_t> bytes;
+        for (const auto c : node.chars) {
+            if (m_isUTF8) {
+                uint8_t encoded[UTF8::MAX_SEQUENCE_LENGTH];
+                bytes.insert(bytes.end(), encoded, encoded + UTF8::encode(c, encoded));
+            }
+            else {
+                bytes.push_back(static_cast<uint8_t>(c));
+            }
+        }
+        auto expression = EPSILON;
+        for (auto it = bytes.rbegin(); it != bytes.rend(); ++it) {
+            expression = makeConcatenation(makeBytes(ByteSet(*it)), expression);
+        }
+        return expression;
+    }
+    case AST::Node::Type::char_class:
+        return expressionOf(node.charClass);
+    case AST::Node::Type::concatenation: {
+        auto expression = EPSILON;
+        for (auto it = node.children.rbegin(); it != node.children.rend(); ++it) {
+            expression = makeConcatenation(expressionOf(**it), expression);
+        }
+        return expression;
+    }
+    case AST::Node::Type::alternation: {
+        std::vector<ExprId> alternatives;
+        for (const auto& child : node.children) {
+            alternatives.push_back(expressionOf(*child));
+        }
+        return makeAlternation(std::move(alternatives));
+    }
+    case AST::Node::Type::repetition: {
+        const auto child = expressionOf(*node.children.front());
+        auto optional = node.max == AST::Node::UNBOUNDED ? makeStar(child) : EPSILON;
+        for (auto count = node.min; node.max != AST::Node::UNBOUNDED and count < node.max; count++) {
+            optional = makeAlternation({EPSILON, makeConcatenation(child, optional)});
+        }
+        auto expression = optional;
+        for (auto count = 0u; count < node.min; count++) {
+            expression = makeConcatenation(child, expression);
+        }
+        return expression;
+    }
+    case AST::Node::Type::capture:
+        return expressionOf(*node.children.front());
+    }
+    assert(false and "Unexpected AST node");
+    return NOTHING;
+}
+
+/* In the UTF-8 mode, the alternation of the byte sequences of the class */
+DerivativeDFA::ExprId DerivativeDFA::expressionOf(const CharClass& charClass) {
+    if (not m_isUTF8) {
+        return makeBytes(charClass.toByteSet());
+    }
+    std::vector<ExprId> alternatives;
+    for (const auto& sequence : UTF8::sequencesOf(charClass)) {
+        auto expression = EPSILON;
+        for (auto it = sequence.rbegin(); it != sequence.rend(); ++it) {
+            expression = makeConcatenation(makeBytes(*it), expression);
+        }
+        alternatives.push_back(expression);
+    }
+    return makeAlternation(std::move(alternatives));
+}
+
+/**
+ * The bytes of a class all have the same derivatives, as the classes
+ * refine every byte set of the pattern:
+ *   d(∅) = d(ε) = ∅
+ *   d([S]) = ε if the class is in S, else ∅
+ *   d(rs) = d(r)s | d(s) if r is nullable
+ *   d(r|s) = d(r) | d(s)
+ *   d(r*) = d(r)r*
+ */
+DerivativeDFA::ExprId DerivativeDFA::derivative(const ExprId id, const uint8_t cls) {
+    const auto key = (uint64_t(id) << 8u) | cls;
+    if (const auto it = m_derivatives.find(key); it != m_derivatives.end()) {
+        return it->second;
+    }
+    // no reference into m_expressions is kept, as the constructors grow it
+    const auto type = m_expressions[id].type;
+    const auto children = m_expressions[id].children;
+    ExprId result = NOTHING;
+    switch (type) {
+    case Expression::Type::nothing:
+    case Expression::Type::epsilon:
+        break;
+    case Expression::Type::bytes:
+        result = m_expressions[id].bytes.contains(m_byteClasses.representative(cls)) ? EPSILON : NOTHING;
+        break;
+    case Expression::Type::concatenation: {
+        const auto [first, rest] = std::make_pair(children[0], children[1]);
+        const auto firstDerivative = makeConcatenation(derivative(first, cls), rest);
+        result = m_expressions[first].isNullable ?
+                 makeAlternation({firstDerivative, derivative(rest, cls)}) :
+                 firstDerivative;
+        break;
+    }
+    case Expression::Type::alternation: {
+        std::vector<ExprId> derivatives;
+        for (const auto child : children) {
+            derivatives.push_back(derivative(child, cls));
+        }
+        result = makeAlternation(std::move(derivatives));
+        break;
+    }
+    case Expression::Type::star:
+        result = makeConcatenation(derivative(children.front(), cls), id);
+        break;
+    }
+    m_derivatives.emplace(key, result);
+    return result;
+}
+
+} // namespace RE
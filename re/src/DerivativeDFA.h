@@ -0,0 +1,85 @@
+#pragma once
+
+#include "AST.h"
+#include "ByteClasses.h"
+#include "ByteSet.h"
+#include "FA.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace RE {
+
+/**
+ * Builds the DFA of a simplified AST directly, by Brzozowski derivatives
+ * over bytes: a state is a regular expression, the state it goes to by a
+ * byte class is its derivative by the class, and it is final if it matches
+ * the empty string.
+ *
+ * The expressions are hash-consed and normalized by their constructors:
+ * concatenation is associative with ε as unit and ∅ as zero, alternation
+ * is a set with its byte sets merged, and (r*)* is r*. Equal expressions
+ * are then the same state and the states are finitely many, but different
+ * expressions may match the same, so the DFA is not minimal and can be
+ * many times larger, e.g. with nested counted repetitions. Above a few
+ * states it is minimized by partition refinement on the table, which
+ * unlike DFAMinimizer is linear in the states by round.
+ */
+class DerivativeDFA {
+public:
+    explicit DerivativeDFA(const bool isUTF8) : m_isUTF8(isUTF8) {}
+
+    DFA make(const AST::Node&);
+    /* The expressions built so far, the states among them */
+    size_t numExpressions() const { return m_expressions.size(); }
+    /* The states of the DFA made, before it is minimized */
+    size_t numStatesBuilt() const { return m_numStatesBuilt; }
+
+private:
+    using ExprId = uint32_t;
+    static constexpr ExprId NOTHING = 0u;  // ∅, the dead state
+    static constexpr ExprId EPSILON = 1u;
+    /* Below, the DFA is small to match with whether minimal or not */
+    static constexpr size_t MIN_NUM_STATES_MINIMIZED = 64u;
+
+    struct Expression {
+        enum class Type { nothing, epsilon, bytes, concatenation, alternation, star };
+
+        Type type = Type::nothing;
+        ByteSet bytes;
+        std::vector<ExprId> children;  // two for a concatenation, sorted for an alternation
+        bool isNullable = false;
+
+        bool operator==(const Expression& other) const {
+            return type == other.type and bytes == other.bytes and children == other.children;
+        }
+    };
+    struct Hash {
+        size_t operator()(const Expression&) const;
+    };
+
+    ExprId intern(Expression);
+    ExprId makeBytes(const ByteSet&);
+    ExprId makeConcatenation(const ExprId, const ExprId);
+    ExprId makeAlternation(std::vector<ExprId>);
+    ExprId makeStar(const ExprId);
+
+    ExprId expressionOf(const AST::Node&);
+    ExprId expressionOf(const CharClass&);
+    ExprId derivative(const ExprId, const uint8_t cls);
+
+    static void minimize(DFA&);
+
+    const bool m_isUTF8;
+    std::vector<Expression> m_expressions;
+    std::unordered_map<Expression, ExprId, Hash> m_ids;
+    /* by expression and byte class, computed once */
+    std::unordered_map<uint64_t, ExprId> m_derivatives;
+    /* refined by every byte set of the pattern, before any derivative */
+    ByteClasses m_byteClasses;
+    size_t m_numStatesBuilt = 0u;
+};
+
+} // namespace RE
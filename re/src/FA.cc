@@ -3,43 +3,528 @@
 
 #include <RE.h>
 
+#include <algorithm>
+#include <type_traits>
+
 namespace RE {
 
+namespace {
+
+template <typename T>
+void release(std::vector<T>& vector) {
+    std::vector<T>().swap(vector);  // clear() would keep the capacity
+}
+
+template <typename T>
+size_t capacityInBytes(const std::vector<T>& vector) {
+    return vector.capacity() * sizeof(T);
+}
+
+} // namespace
+
 // NFA
-void NFAState::addTransition(const char sym, NFAState const* to) {
-    m_transitions[sym].insert(to);
+void NFAState::addTransition(const ByteSet& byteSet, NFAState const* to) {
+    m_transitions.emplace_back(byteSet, to);
 }
 
-bool NFAState::hasTransition(const char sym) const {
-    return m_transitions.find(sym) != m_transitions.end();
+void NFAState::addEpsTransition(NFAState const* to) {
+    m_epsTransitions.insert(to);
 }
 
 // DFA
-bool DFAState::accept(REParser::Str_t str) const {
-    DFAState const* state = this;
-    for (const auto c : str) {
-        if (not state->hasTransition(c)) {
-            return false;
+void DFAState::addTransition(const uint8_t cls, DFAState const* to) {
+    assert(m_transitions.find(cls) == m_transitions.end());
+    m_transitions[cls] = to;
+}
+
+bool DFAState::hasTransition(const uint8_t cls) const {
+    return m_transitions.find(cls) != m_transitions.end();
+}
+
+bool DFAStateFromNFA::hasState(NFAState const* nfaState) const {
+    return m_NFAStateSet.find(nfaState) != m_NFAStateSet.end();
+}
+
+void DFA::accelerate(const StateId first) {
+    m_isAccelerated.resize(first);
+    m_isAccelerated.resize(numStates(), false);
+    m_exits.resize(first);
+    m_exits.resize(numStates(), ByteScan::Needles());
+    std::vector<ByteSet> bytesOf;
+    for (size_t cls = 0u; cls < m_byteClasses.numClasses(); cls++) {
+        bytesOf.push_back(m_byteClasses.bytesOf(cls));
+    }
+    for (auto state = first; state < static_cast<StateId>(numStates()); state++) {
+        ByteSet exits;
+        for (size_t cls = 0u; cls < m_byteClasses.numClasses(); cls++) {
+            if (nextByClass(state, cls) != state) {
+                exits.add(bytesOf[cls]);
+            }
+        }
+        if (exits.count() > ByteScan::MAX_NUM_BYTES) {
+            continue;
+        }
+        m_isAccelerated[state] = true;
+        for (size_t byte = 0u; byte < ByteSet::NUM_BYTES; byte++) {
+            if (exits.contains(byte)) {
+                auto& needles = m_exits[state];
+                needles.bytes[needles.numBytes++] = byte;
+            }
+        }
+    }
+}
+
+/**
+ * The offsets are stored as the narrowest type holding the largest one, so
+ * the matching loops are instantiated for each type.
+ */
+void DFA::compress() {
+    const DFALayout layout(m_transitions, m_byteClasses.numClasses(), m_start);
+    const auto maxOffset = layout.offsets.empty() ?
+                           0u : *std::max_element(layout.offsets.begin(), layout.offsets.end());
+    const auto makeTable = [&](auto offset) {
+        return DFATable<decltype(offset)>(layout, m_transitions, m_byteClasses.numClasses(),
+                                          m_finals, m_tokens, m_isAccelerated, m_exits);
+    };
+    if (maxOffset <= UINT8_MAX) {
+        m_table = makeTable(uint8_t());
+    }
+    else if (maxOffset <= UINT16_MAX) {
+        m_table = makeTable(uint16_t());
+    }
+    else {
+        m_table = makeTable(uint32_t());
+    }
+
+    m_sheng.reset();
+    if (numStates() <= ShengDFA::MAX_NUM_STATES and ShengDFA::isSupported() and
+        std::none_of(m_isAccelerated.begin(), m_isAccelerated.end(), [](const uint8_t is) { return is; }))
+    {
+        m_sheng = std::make_unique<ShengDFA>(m_transitions, m_byteClasses, m_finals, m_tokens);
+    }
+    m_builtTableSize = tableSize();
+}
+
+/* Building the table again once it has doubled keeps the cost of the builds in proportion to the rows appended */
+bool DFA::compressAdded() {
+    if (m_sheng or tableSize() > 2u * m_builtTableSize) {
+        return false;
+    }
+    return std::visit([this](auto& table) {
+        return table.append(m_transitions, m_finals, m_tokens, m_isAccelerated, m_exits);
+    }, m_table);
+}
+
+void DFA::optimizeLayout(const std::vector<std::string_view>& corpus) {
+    if (m_isFrozen) {
+        thaw();
+    }
+    renumber(profiledOrder(profile(corpus)));
+    accelerate();
+    compress();
+}
+
+DFA::Profile DFA::profile(const std::vector<std::string_view>& corpus) const {
+    const auto numClasses = m_byteClasses.numClasses();
+    Profile profile{std::vector<uint64_t>(numStates(), 0u), std::vector<uint64_t>(m_transitions.size(), 0u)};
+    for (const auto str : corpus) {
+        auto state = m_start;
+        profile.visits[state]++;
+        for (const auto byte : str) {
+            const auto cls = m_byteClasses.classOf(byte);
+            if (nextByClass(state, cls) == DEAD) {
+                state = m_start;  // as a search starting again at the byte
+            }
+            if (const auto to = nextByClass(state, cls); to != DEAD) {
+                profile.transitions[state * numClasses + cls]++;
+                state = to;
+            }
+            profile.visits[state]++;
+        }
+    }
+    return profile;
+}
+
+std::vector<DFA::StateId> DFA::breadthFirstOrder(const bool withUnreachable) const {
+    std::vector<bool> isPlaced(numStates(), false);
+    std::vector<StateId> order{DEAD};
+    isPlaced[DEAD] = true;
+    if (not isPlaced[m_start]) {
+        isPlaced[m_start] = true;
+        order.push_back(m_start);
+    }
+    for (size_t i = 1u; i < order.size(); i++) {
+        for (size_t cls = 0u; cls < m_byteClasses.numClasses(); cls++) {
+            if (const auto to = nextByClass(order[i], cls); not isPlaced[to]) {
+                isPlaced[to] = true;
+                order.push_back(to);
+            }
+        }
+    }
+    for (StateId state = DEAD + 1; withUnreachable and state < static_cast<StateId>(numStates()); state++) {
+        if (not isPlaced[state]) {
+            order.push_back(state);
+        }
+    }
+    return order;
+}
+
+/**
+ * Placing a successor right after its state puts the two rows in the same
+ * or adjacent cache lines when the rows are short, as the dense ones come
+ * first in the table by id.
+ */
+std::vector<DFA::StateId> DFA::profiledOrder(const Profile& profile) const {
+    const auto numClasses = m_byteClasses.numClasses();
+    std::vector<StateId> visited;
+    for (StateId state = DEAD + 1; state < static_cast<StateId>(numStates()); state++) {
+        if (profile.visits[state] > 0u) {
+            visited.push_back(state);
+        }
+    }
+    std::stable_sort(visited.begin(), visited.end(), [&profile](const StateId a, const StateId b) {
+        return profile.visits[a] > profile.visits[b];
+    });
+
+    std::vector<bool> isPlaced(numStates(), false);
+    std::vector<StateId> order{DEAD};
+    isPlaced[DEAD] = true;
+    for (auto state : visited) {
+        while (not isPlaced[state]) {
+            isPlaced[state] = true;
+            order.push_back(state);
+            // several byte classes may lead to the same successor
+            std::map<StateId, uint64_t> taken;
+            for (size_t cls = 0u; cls < numClasses; cls++) {
+                taken[nextByClass(state, cls)] += profile.transitions[state * numClasses + cls];
+            }
+            auto next = DEAD;
+            uint64_t maxTaken = 0u;
+            for (const auto [to, count] : taken) {
+                if (not isPlaced[to] and count > maxTaken) {
+                    next = to;
+                    maxTaken = count;
+                }
+            }
+            state = next;
+        }
+    }
+    for (const auto state : breadthFirstOrder()) {
+        if (not isPlaced[state]) {
+            order.push_back(state);
+        }
+    }
+    return order;
+}
+
+void DFA::renumber(const std::vector<StateId>& order) {
+    const auto numClasses = m_byteClasses.numClasses();
+    std::vector<StateId> newIds(numStates(), DEAD);
+    for (size_t id = 0u; id < order.size(); id++) {
+        newIds[order[id]] = static_cast<StateId>(id);
+    }
+    std::vector<StateId> transitions(order.size() * numClasses);
+    std::vector<bool> finals(order.size());
+    std::vector<uint32_t> tokens(order.size());
+    for (size_t id = 0u; id < order.size(); id++) {
+        const auto old = static_cast<size_t>(order[id]);
+        finals[id] = m_finals[old];
+        tokens[id] = m_tokens[old];
+        for (size_t cls = 0u; cls < numClasses; cls++) {
+            transitions[id * numClasses + cls] = newIds[m_transitions[old * numClasses + cls]];
+        }
+    }
+    m_transitions = std::move(transitions);
+    m_finals = std::move(finals);
+    m_tokens = std::move(tokens);
+    m_start = newIds[m_start];
+    m_statesByRow.clear();
+}
+
+void DFA::thaw() {
+    std::visit([this](const auto& table) {
+        const auto numClasses = m_byteClasses.numClasses();
+        std::map<typename std::decay_t<decltype(table)>::Offset_t, StateId> stateOfOffset;
+        for (size_t state = 0u; state < table.numStates(); state++) {
+            stateOfOffset[table.offsetOf(state)] = static_cast<StateId>(state);
+        }
+        m_transitions.assign(table.numStates() * numClasses, DEAD);
+        m_finals.assign(table.numStates(), false);
+        m_tokens.assign(table.numStates(), NO_TOKEN);
+        for (size_t state = 0u; state < table.numStates(); state++) {
+            const auto offset = table.offsetOf(state);
+            m_finals[state] = table.isFinal(offset);
+            if (m_finals[state]) {
+                m_tokens[state] = table.tokenOf(offset);
+            }
+            for (size_t cls = 0u; cls < numClasses; cls++) {
+                m_transitions[state * numClasses + cls] = stateOfOffset.at(table.next(offset, cls));
+            }
+        }
+    }, m_table);
+    accelerate();
+    m_isFrozen = false;
+}
+
+void DFA::freeze() {
+    release(m_transitions);
+    release(m_finals);
+    release(m_tokens);
+    release(m_isAccelerated);
+    release(m_exits);
+    m_statesByRow = {};
+    m_isFrozen = true;
+}
+
+DFA DFA::thawedCopy() const {
+    DFA copy;
+    copy.m_byteClasses = m_byteClasses;
+    copy.m_start = m_start;
+    copy.m_table = m_table;
+    if (m_isFrozen) {
+        copy.thaw();
+    }
+    else {
+        copy.m_transitions = m_transitions;
+        copy.m_finals = m_finals;
+        copy.m_tokens = m_tokens;
+        copy.m_isAccelerated = m_isAccelerated;
+        copy.m_exits = m_exits;
+    }
+    return copy;
+}
+
+size_t DFA::memoryUsage() const {
+    return sizeof(*this) + std::visit([](const auto& table) { return table.numBytes(); }, m_table) +
+           (m_sheng ? sizeof(ShengDFA) : 0u) +
+           capacityInBytes(m_transitions) + m_finals.capacity() / 8u + capacityInBytes(m_tokens) +
+           capacityInBytes(m_isAccelerated) + capacityInBytes(m_exits) +
+           m_statesByRow.size() * (sizeof(std::pair<size_t, StateId>) + sizeof(void*)) +
+           m_statesByRow.bucket_count() * sizeof(void*);
+}
+
+size_t DFA::tableSize() const {
+    return std::visit([](const auto& table) { return table.numBytes(); }, m_table) +
+           sizeof(m_byteClasses);
+}
+
+bool DFA::accept(REParser::Str_t str) const {
+    if (m_sheng) {
+        return m_sheng->accept(str, m_start);
+    }
+    return std::visit([this, str](const auto& table) { return accept(table, str); }, m_table);
+}
+
+size_t DFA::longestMatch(REParser::Str_t str, size_t pos, StateId state) const {
+    if (m_sheng) {
+        ShengDFA::State_t lastFinal = DEAD;
+        return m_sheng->longestMatch(str, pos, state, lastFinal);
+    }
+    return std::visit([this, str, pos, state](const auto& table) {
+        typename std::decay_t<decltype(table)>::Offset_t lastFinal = 0u;
+        return longestMatch(table, str, pos, table.offsetOf(state), lastFinal);
+    }, m_table);
+}
+
+size_t DFA::longestToken(REParser::Str_t str, size_t pos, uint32_t& token) const {
+    if (m_sheng) {
+        ShengDFA::State_t lastFinal = DEAD;
+        const auto end = m_sheng->longestMatch(str, pos, m_start, lastFinal);
+        token = end == NO_MATCH ? NO_TOKEN : m_sheng->token(lastFinal);
+        return end;
+    }
+    return std::visit([this, str, pos, &token](const auto& table) {
+        typename std::decay_t<decltype(table)>::Offset_t lastFinal = 0u;
+        const auto end = longestMatch(table, str, pos, table.offsetOf(m_start), lastFinal);
+        token = end == NO_MATCH ? NO_TOKEN : table.tokenOf(lastFinal);
+        return end;
+    }, m_table);
+}
+
+size_t DFA::longestMatchBackwards(REParser::Str_t str, size_t pos, const size_t min) const {
+    if (m_sheng) {
+        return m_sheng->longestMatchBackwards(str, pos, min, m_start);
+    }
+    return std::visit([this, str, pos, min](const auto& table) {
+        return longestMatchBackwards(table, str, pos, min);
+    }, m_table);
+}
+
+/**
+ * The run from pos alone decides mostly, and is read first, with Sheng if
+ * any. Else the runs from pos on read at least as far as it did.
+ */
+size_t DFA::leftmostLongest(REParser::Str_t str, size_t pos, size_t& start) const {
+    const auto end = longestMatch(str, pos, m_start);
+    if (end != NO_MATCH) {
+        start = pos;
+        return end;
+    }
+    return std::visit([this, str, pos, &start](const auto& table) {
+        return leftmostLongest(table, str, pos, start);
+    }, m_table);
+}
+
+/**
+ * With a stride-2 table the bytes are read by pairs, the last one of an
+ * odd count alone
+ */
+template <typename Table>
+bool DFA::accept(const Table& table, REParser::Str_t str) const {
+    const auto hasStride2 = table.hasStride2();
+    auto state = table.offsetOf(m_start);
+    for (size_t pos = 0u; pos < str.size(); ) {
+        if (table.isAccelerated(state)) {
+            pos = ByteScan::findFirst(str, pos, table.exits(state));
+            if (pos == ByteScan::NOT_FOUND) {
+                break;
+            }
+        }
+        if (hasStride2 and pos + 1u < str.size()) {
+            state = table.next2(state, m_byteClasses.classOf(str[pos]), m_byteClasses.classOf(str[pos + 1u]));
+            pos += 2u;
         }
         else {
-            state = state->m_transitions.at(c);
+            state = table.next(state, m_byteClasses.classOf(str[pos++]));
+        }
+        if (state == Table::DEAD) {
+            return false;
         }
     }
-    return state->m_isFinal;
+    return table.isFinal(state);
 }
 
-void DFAState::addTransition(const char sym, DFAState const* to) {
-    assert(sym != EPS);
-    assert(m_transitions.find(sym) == m_transitions.end());
-    m_transitions[sym] = to;
+/**
+ * The positions skipped in an accelerated state are all final or all not.
+ * A double step is only taken from a state not one byte away from a final
+ * state, so that no final position is stepped over.
+ */
+template <typename Table>
+size_t DFA::longestMatch(const Table& table, REParser::Str_t str, size_t pos,
+                         typename Table::Offset_t state, typename Table::Offset_t& lastFinal) const {
+    const auto hasStride2 = table.hasStride2();
+    size_t end = NO_MATCH;
+    if (table.isFinal(state)) {
+        end = pos;
+        lastFinal = state;
+    }
+    while (pos < str.size()) {
+        if (table.isAccelerated(state)) {
+            pos = ByteScan::findFirst(str, pos, table.exits(state));
+            if (pos == ByteScan::NOT_FOUND) {
+                pos = str.size();
+            }
+            if (table.isFinal(state)) {
+                end = pos;
+                lastFinal = state;
+            }
+            if (pos == str.size()) {
+                break;
+            }
+        }
+        if (hasStride2 and pos + 1u < str.size() and not table.isBeforeFinal(state)) {
+            state = table.next2(state, m_byteClasses.classOf(str[pos]), m_byteClasses.classOf(str[pos + 1u]));
+            pos += 2u;
+        }
+        else {
+            state = table.next(state, m_byteClasses.classOf(str[pos++]));
+        }
+        if (state == Table::DEAD) {
+            break;
+        }
+        if (table.isFinal(state)) {
+            end = pos;
+            lastFinal = state;
+        }
+    }
+    return end;
 }
 
-bool DFAState::hasTransition(const char sym) const {
-    return m_transitions.find(sym) != m_transitions.end();
+template <typename Table>
+size_t DFA::longestMatchBackwards(const Table& table, REParser::Str_t str, size_t pos, const size_t min) const {
+    auto state = table.offsetOf(m_start);
+    size_t start = table.isFinal(state) ? pos : NO_MATCH;
+    while (pos > min) {
+        if (table.isAccelerated(state)) {
+            const auto exit = ByteScan::findLast(str, min, pos, table.exits(state));
+            pos = exit == ByteScan::NOT_FOUND ? min : exit + 1;
+            if (table.isFinal(state)) {
+                start = pos;
+            }
+            if (pos == min) {
+                break;
+            }
+        }
+        state = table.next(state, m_byteClasses.classOf(str[--pos]));
+        if (state == Table::DEAD) {
+            break;
+        }
+        if (table.isFinal(state)) {
+            start = pos;
+        }
+    }
+    return start;
 }
 
-bool DFAStateFromNFA::hasState(NFAState const* nfaState) const {
-    return m_NFAStateSet.find(nfaState) != m_NFAStateSet.end();
+/**
+ * The runs of the DFA from each position are stepped together, ordered by
+ * their start: a run entering the state of an earlier one can only match
+ * where the earlier one does, and is dropped, so that a byte costs a step
+ * per state at most rather than a run per start. Once a run matches, the
+ * runs started after it are dropped and no more are started, and the last
+ * run left is read to its end by longestMatch.
+ */
+template <typename Table>
+size_t DFA::leftmostLongest(const Table& table, REParser::Str_t str, size_t pos, size_t& start) const {
+    using Offset_t = typename Table::Offset_t;
+    using Runs = std::vector<std::pair<Offset_t, size_t>>;  // the state and the start of each run
+    const auto isIn = [](const Runs& runs, const Offset_t state) {
+        return std::any_of(runs.begin(), runs.end(), [state](const auto& run) { return run.first == state; });
+    };
+    const auto startState = table.offsetOf(m_start);
+    Runs runs, stepped;
+    size_t end = NO_MATCH;
+    for (;; pos++) {
+        if (end == NO_MATCH and not isIn(runs, startState)) {
+            runs.emplace_back(startState, pos);
+        }
+        for (size_t i = 0u; i < runs.size(); i++) {
+            if (table.isFinal(runs[i].first)) {
+                start = runs[i].second;
+                end = pos;
+                runs.resize(i + 1u);
+                break;
+            }
+        }
+        if (end != NO_MATCH and runs.size() == 1u) {
+            Offset_t lastFinal = 0u;
+            const auto longest = longestMatch(table, str, pos, runs.front().first, lastFinal);
+            if (longest != NO_MATCH) {
+                start = runs.front().second;
+                end = longest;
+            }
+            return end;
+        }
+        if (pos == str.size()) {
+            break;
+        }
+        const auto cls = m_byteClasses.classOf(str[pos]);
+        stepped.clear();
+        for (const auto& [state, runStart] : runs) {
+            const auto to = table.next(state, cls);
+            if (to != Table::DEAD and not isIn(stepped, to)) {
+                stepped.emplace_back(to, runStart);
+            }
+        }
+        std::swap(runs, stepped);
+        if (runs.empty()) {
+            break;
+        }
+    }
+    if (end == NO_MATCH) {
+        start = pos + 1u;
+    }
+    return end;
 }
 
 } // namespace RE
@@ -1,13 +1,24 @@
 #pragma once
 
+#include "ByteClasses.h"
+#include "ByteScan.h"
+#include "ByteSet.h"
+#include "DFATable.h"
 #include "REDef.h"
+#include "ShengDFA.h"
 
 #include <RE.h>
 
 #include <cassert>
+#include <cstdint>
+#include <memory>
+#include <utility>
 #include <vector>
 #include <set>
 #include <map>
+#include <string_view>
+#include <unordered_map>
+#include <variant>
 
 namespace RE {
 
@@ -16,22 +27,29 @@ class NFAState {
     friend class REParser;
     friend class StateManager;
     friend class DFAStateFromNFA;
+    friend class TaggedNFA;
 
 public:
-    NFAState(const size_t id, const bool isFinal) :
-        m_id(id), m_isFinal(isFinal)
+    using allocator_type = Allocator;
+
+    NFAState(const size_t id, const bool isFinal, const allocator_type& allocator = {}) :
+        m_id(id), m_isFinal(isFinal), m_epsTransitions(allocator), m_transitions(allocator)
     {}
 
 private:
     NFAState(const NFAState&) = delete;
     NFAState& operator=(const NFAState&) = delete;
 
-    void addTransition(const char, NFAState const*);
-    bool hasTransition(const char) const;
+    void addTransition(const ByteSet&, NFAState const*);
+    void addEpsTransition(NFAState const*);
 
     const size_t m_id;
     bool m_isFinal;
-    std::map<char, NFAStateSet> m_transitions;
+    int32_t m_tag = NO_TAG;  // recorded when the state is entered
+    uint32_t m_token = 0u;  // of a final state
+    /* epsilon is kept apart from the bytes so that every byte can be matched */
+    NFAStateSet m_epsTransitions;
+    std::pmr::vector<std::pair<ByteSet, NFAState const*>> m_transitions;
 };
 
 
@@ -43,27 +61,32 @@ struct NFA {
 };
 
 
+/**
+ * DFA state built by the subset construction. The transitions are keyed by
+ * byte classes.
+ */
 class DFAState {
     friend class DFAMinimizer;
 
 public:
-    DFAState(const size_t id, const bool isFinal = false)
-        : m_id(id), m_isFinal(isFinal) {}
+    using allocator_type = Allocator;
 
-    bool accept(REParser::Str_t) const;
+    DFAState(const size_t id, const bool isFinal, const uint32_t token, const allocator_type& allocator = {})
+        : m_id(id), m_isFinal(isFinal), m_token(token), m_transitions(allocator) {}
 
 private:
     DFAState(const DFAState&) = delete;
     DFAState& operator=(const DFAState&) = delete;
 
 protected:
-    void addTransition(const char, DFAState const*);
-    bool hasTransition(const char) const;
+    void addTransition(const uint8_t, DFAState const*);
+    bool hasTransition(const uint8_t) const;
 
 protected:
     size_t m_id;  // TODO: eliminate the need to use id
     bool m_isFinal = false;
-    std::map<char, DFAState const*> m_transitions;
+    uint32_t m_token = NO_TOKEN;
+    std::pmr::map<uint8_t, DFAState const*> m_transitions;
 };
 
 class DFAStateFromNFA : public DFAState {
@@ -73,10 +96,11 @@ class DFAStateFromNFA : public DFAState {
     friend class DFAMinimizer;
 
 public:
-    DFAStateFromNFA(const size_t id, const bool isFinal = false)
-        : DFAState(id, isFinal) {}
-    DFAStateFromNFA(const size_t id, const bool isFinal, const NFAStateSet& nfas)
-        : DFAState(id, isFinal), m_NFAStateSet(nfas) {}
+    DFAStateFromNFA(const size_t id, const bool isFinal, const allocator_type& allocator = {})
+        : DFAState(id, isFinal, NO_TOKEN, allocator), m_NFAStateSet(allocator) {}
+    DFAStateFromNFA(const size_t id, const bool isFinal, const uint32_t token, const NFAStateSet& nfas,
+                    const allocator_type& allocator = {})
+        : DFAState(id, isFinal, token, allocator), m_NFAStateSet(nfas, allocator) {}
 
    private:
     bool hasState(NFAState const*) const;
@@ -86,20 +110,141 @@ private:
 };
 
 
-class DFA {    
+/**
+ * The minimized DFA as a dense transition table with a row per state and a
+ * column per byte class. State 0 is the dead state. The matching runs on a
+ * compressed copy of the table, see DFATable.
+ *
+ * The dense table is only needed to build and analyse the DFA; once frozen,
+ * the DFA keeps the compressed table alone, and the accessors by state but
+ * start() may no longer be called.
+ */
+class DFA {
     friend class DFAMinimizer;
+    friend class DFAProduct;
+    friend class DerivativeDFA;
+    friend class LiteralDFA;
 
 public:
-    bool accept(REParser::Str_t str) const { return m_start->accept(str); }
+    using StateId = int32_t;
+    static constexpr StateId DEAD = 0;
+    static constexpr size_t NO_MATCH = std::string_view::npos;
 
-private:
-    void setStart(const int32_t start) {
-        m_start = &(m_states.at(start));
+    bool accept(REParser::Str_t) const;
+    /* The end of the longest match read from the state at pos */
+    size_t longestMatch(REParser::Str_t, size_t pos, StateId) const;
+    /**
+     * For a reversed DFA: the start of the longest match read backwards from
+     * pos, not going below min
+     */
+    size_t longestMatchBackwards(REParser::Str_t, size_t pos, const size_t min) const;
+    /**
+     * The end of the leftmost-longest match starting from pos on and its
+     * start, runs being started at each position as long as one is alive;
+     * else NO_MATCH, start being the first position not tried
+     */
+    size_t leftmostLongest(REParser::Str_t, size_t pos, size_t& start) const;
+    /* The end of the longest token read from pos and the rule it matches */
+    size_t longestToken(REParser::Str_t, size_t pos, uint32_t& token) const;
+
+    StateId start() const { return m_start; }
+    StateId next(const StateId state, const uint8_t byte) const {
+        return m_transitions[state * m_byteClasses.numClasses() + m_byteClasses.classOf(byte)];
+    }
+    StateId nextByClass(const StateId state, const uint8_t cls) const {
+        return m_transitions[state * m_byteClasses.numClasses() + cls];
     }
+    bool isFinal(const StateId state) const { return m_finals[state]; }
+    uint32_t token(const StateId state) const { return m_tokens[state]; }
+    size_t numStates() const { return m_finals.size(); }
+    const ByteClasses& byteClasses() const { return m_byteClasses; }
+
+    bool isAccelerated(const StateId state) const { return m_isAccelerated[state]; }
+
+    /* The bytes taken by the table the matching runs on */
+    size_t tableSize() const;
+    /* All the bytes taken by the DFA, the dense table included if not frozen */
+    size_t memoryUsage() const;
+    /* Free the dense table, which the matching does not use */
+    void freeze();
+    /* A copy with the dense table, e.g. to combine a frozen DFA, which matches on the table alone */
+    DFA thawedCopy() const;
+
+    /**
+     * Renumber the states by how the DFA runs over a training corpus, so
+     * that the rows of the hot states and of their usual successors are
+     * next to each other in the table. The states never visited keep the
+     * breadth-first order the minimizer gives them.
+     */
+    void optimizeLayout(const std::vector<std::string_view>& corpus);
 
 private:
-    std::map<int32_t, DFAState> m_states;  // actual storage
-    DFAState const* m_start;
+    /* Counted by running the DFA over each string, restarting when it dies */
+    struct Profile {
+        std::vector<uint64_t> visits;       // by state
+        std::vector<uint64_t> transitions;  // by state and byte class
+    };
+
+    Profile profile(const std::vector<std::string_view>& corpus) const;
+    /* The states from the start, the dead state first and the unreachable ones last, if asked for */
+    std::vector<StateId> breadthFirstOrder(const bool withUnreachable = true) const;
+    /* Chains of hot states, each followed by its most taken unplaced successor */
+    std::vector<StateId> profiledOrder(const Profile&) const;
+    /**
+     * order[id] is the old id of the state numbered id, order[DEAD] being
+     * DEAD; the states left out, which must not be reached, are dropped
+     */
+    void renumber(const std::vector<StateId>& order);
+    /* Rebuild the dense table of a frozen DFA from the compressed one */
+    void thaw();
+    /**
+     * Mark the states looping on themselves for all the bytes but at most
+     * ByteScan::MAX_NUM_BYTES, e.g. the one of .* in .*ERROR, whose exit
+     * bytes are then searched for instead of stepping through the loop;
+     * the states before first keep their marks
+     */
+    void accelerate(const StateId first = DEAD + 1);
+    /* Build the table the matching runs on, once the DFA is complete */
+    void compress();
+    /**
+     * Append to the table the rows of the states added since it was built,
+     * the other rows being unchanged; false if it cannot take them or has
+     * grown to twice its size when built, and is to be built again
+     */
+    bool compressAdded();
+
+    template <typename Table>
+    bool accept(const Table&, REParser::Str_t) const;
+    template <typename Table>
+    size_t longestMatch(const Table&, REParser::Str_t, size_t pos, typename Table::Offset_t state,
+                        typename Table::Offset_t& lastFinal) const;
+    template <typename Table>
+    size_t longestMatchBackwards(const Table&, REParser::Str_t, size_t pos, const size_t min) const;
+    template <typename Table>
+    size_t leftmostLongest(const Table&, REParser::Str_t, size_t pos, size_t& start) const;
+
+    ByteClasses m_byteClasses;
+    std::vector<StateId> m_transitions;
+    std::vector<bool> m_finals;
+    std::vector<uint32_t> m_tokens;  // by state, NO_TOKEN for the non-final ones
+    StateId m_start = DEAD;
+    std::vector<uint8_t> m_isAccelerated;
+    std::vector<ByteScan::Needles> m_exits;
+    std::variant<DFATable<uint8_t>, DFATable<uint16_t>, DFATable<uint32_t>> m_table;
+    /**
+     * The engine the matching runs on instead of the table for a DFA of at
+     * most ShengDFA::MAX_NUM_STATES states, unless one is accelerated, the
+     * byte scan then being faster
+     */
+    std::unique_ptr<ShengDFA> m_sheng;
+    size_t m_builtTableSize = 0u;  // by compress, the rows appended since not counted
+    /**
+     * The states by the hash of their row, for DFAProduct::addUnion to find
+     * a state by its row without hashing every row again; built when first
+     * needed, and emptied when the states are renumbered
+     */
+    std::unordered_multimap<size_t, StateId> m_statesByRow;
+    bool m_isFrozen = false;
 };
 
 } // namespace RE
@@ -0,0 +1,393 @@
+#include "GlushkovNFA.h"
+#include "UTF8.h"
+
+#include <REExceptions.h>
+
+#include <algorithm>
+
+namespace RE {
+
+namespace {
+
+constexpr size_t WORD_BITS = 64u;
+constexpr size_t CHUNK_BITS = 8u;
+constexpr size_t CHUNKS_PER_WORD = WORD_BITS / CHUNK_BITS;
+
+/* The states of the pattern, counted until they exceed the bound */
+size_t countPositions(const AST::Node& node, const size_t bound) {
+    switch (node.type) {
+    case AST::Node::Type::literal:
+        return node.chars.size();
+    case AST::Node::Type::char_class:
+        return 1u;
+    case AST::Node::Type::repetition: {
+        const auto numCopies = node.max == AST::Node::UNBOUNDED ? std::max(node.min, 1u) : node.max;
+        const auto numChildPositions = countPositions(*node.children.front(), bound);
+        return std::min<size_t>(numCopies, bound + 1u) * numChildPositions;
+    }
+    default:
+        break;
+    }
+    size_t numPositions = 0u;
+    for (const auto& child : node.children) {
+        numPositions += countPositions(*child, bound);
+        if (numPositions > bound) {
+            break;
+        }
+    }
+    return numPositions;
+}
+
+template <typename Visit>
+void forEachState(const std::vector<GlushkovNFA::Word>& set, const Visit& visit) {
+    for (size_t word = 0u; word < set.size(); word++) {
+        for (auto bits = set[word]; bits != 0u; bits &= bits - 1u) {
+            visit(static_cast<uint32_t>(word * WORD_BITS + __builtin_ctzll(bits)));
+        }
+    }
+}
+
+void orInto(std::vector<GlushkovNFA::Word>& to, const std::vector<GlushkovNFA::Word>& from) {
+    for (size_t word = 0u; word < to.size(); word++) {
+        to[word] |= from[word];
+    }
+}
+
+} // namespace
+
+GlushkovNFA::Automaton::Automaton(const std::vector<Set>& followOf, Set finals_) :
+    finals(std::move(finals_)),
+    numWords(finals.size())
+{
+    const auto numChunks = numWords * CHUNKS_PER_WORD;
+    follow.assign(numChunks * 256u * numWords, 0u);
+    for (size_t chunk = 0u; chunk < numChunks; chunk++) {
+        auto* const rows = &follow[chunk * 256u * numWords];
+        // the row of a byte is the row of the byte without its lowest bit and that state's
+        for (size_t byte = 1u; byte < 256u; byte++) {
+            const auto state = chunk * CHUNK_BITS + __builtin_ctz(byte);
+            const auto* const rest = &rows[(byte & (byte - 1u)) * numWords];
+            for (size_t word = 0u; word < numWords; word++) {
+                rows[byte * numWords + word] = rest[word] | (state < followOf.size() ? followOf[state][word] : 0u);
+            }
+        }
+    }
+}
+
+void GlushkovNFA::Automaton::next(Word const* from, Word* to) const {
+    std::fill(to, to + numWords, 0u);
+    for (size_t word = 0u; word < numWords; word++) {
+        for (auto bits = from[word]; bits != 0u;) {
+            const auto shift = __builtin_ctzll(bits) & ~(CHUNK_BITS - 1u);
+            const auto chunk = word * CHUNKS_PER_WORD + shift / CHUNK_BITS;
+            const auto* const row = &follow[(chunk * 256u + ((bits >> shift) & 0xffu)) * numWords];
+            for (size_t w = 0u; w < numWords; w++) {
+                to[w] |= row[w];
+            }
+            bits &= ~(Word(0xffu) << shift);
+        }
+    }
+}
+
+/* From the start, a level holds the states reached by deleting characters of the pattern */
+GlushkovNFA::Levels::Levels(const Automaton& automaton, const uint32_t maxEdits) :
+    m_automaton(automaton),
+    m_numWords(automaton.numWords),
+    m_numLevels(maxEdits + 1u),
+    m_words((m_numLevels + NUM_SCRATCH_SETS) * automaton.numWords, 0u)
+{
+    m_words[0] = 1u;
+    for (size_t level = 1u; level < m_numLevels; level++) {
+        auto* const current = &m_words[level * m_numWords];
+        const auto* const below = current - m_numWords;
+        m_automaton.next(below, current);
+        for (size_t word = 0u; word < m_numWords; word++) {
+            current[word] |= below[word];
+        }
+    }
+}
+
+/**
+ * Level j after the character is reached from level j by the character,
+ * or from level j - 1 before it by inserting the character (staying), by
+ * substituting it (any transition), or from level j - 1 after it by
+ * deleting a character of the pattern (any transition). The transitions
+ * distribute over the union, so that a level costs two steps.
+ */
+void GlushkovNFA::Levels::step(Word const* mask, const bool isSearch) {
+    auto* const belowBefore = &m_words[m_numLevels * m_numWords];
+    auto* const belowBoth = belowBefore + m_numWords;
+    auto* const next = belowBoth + m_numWords;
+    for (size_t level = 0u; level < m_numLevels; level++) {
+        auto* const current = &m_words[level * m_numWords];
+        m_automaton.next(current, next);
+        for (size_t word = 0u; word < m_numWords; word++) {
+            next[word] &= mask[word];
+        }
+        if (level > 0u) {
+            const auto* const below = current - m_numWords;
+            for (size_t word = 0u; word < m_numWords; word++) {
+                next[word] |= belowBefore[word];
+                belowBoth[word] = belowBefore[word] | below[word];
+            }
+            auto* const reached = belowBefore;  // no longer needed
+            m_automaton.next(belowBoth, reached);
+            for (size_t word = 0u; word < m_numWords; word++) {
+                next[word] |= reached[word];
+            }
+        }
+        else if (isSearch) {
+            next[0] |= 1u;
+        }
+        std::copy(current, current + m_numWords, belowBefore);
+        std::copy(next, next + m_numWords, current);
+    }
+}
+
+int32_t GlushkovNFA::Levels::edits() const {
+    const auto& finals = m_automaton.finals;
+    for (size_t level = 0u; level < m_numLevels; level++) {
+        for (size_t word = 0u; word < m_numWords; word++) {
+            if (m_words[level * m_numWords + word] & finals[word]) {
+                return static_cast<int32_t>(level);
+            }
+        }
+    }
+    return -1;
+}
+
+bool GlushkovNFA::Levels::isEmpty() const {
+    const auto end = m_words.begin() + m_numLevels * m_numWords;
+    return std::all_of(m_words.begin(), end, [](const Word word) { return word == 0u; });
+}
+
+GlushkovNFA::GlushkovNFA(const AST::Node& ast, const bool isUTF8) :
+    m_isUTF8(isUTF8),
+    m_classes(1u)
+{
+    const auto numPositions = countPositions(ast, MAX_POSITIONS);
+    if (numPositions > MAX_POSITIONS) {
+        throw TooManyPositionsException(MAX_POSITIONS);
+    }
+    const auto numWords = numPositions / WORD_BITS + 1u;
+    m_followOf.assign(1u, Set(numWords, 0u));
+    const auto root = build(ast);
+    m_followOf[0] = root.first;
+
+    auto finals = root.last;
+    finals[0] |= root.isNullable;
+    // read backwards, the states are entered from their followers, and the first ones are final
+    std::vector<Set> precedeOf(m_followOf.size(), Set(numWords, 0u));
+    for (uint32_t state = 1u; state < m_followOf.size(); state++) {
+        forEachState(m_followOf[state], [&](const uint32_t next) {
+            precedeOf[next][state / WORD_BITS] |= Word(1u) << state % WORD_BITS;
+        });
+    }
+    precedeOf[0] = root.last;
+    auto reverseFinals = root.first;
+    reverseFinals[0] |= root.isNullable;
+    m_forward = Automaton(m_followOf, std::move(finals));
+    m_reverse = Automaton(precedeOf, std::move(reverseFinals));
+
+    const auto numMasks = isUTF8 ? 0x80u : 0x100u;
+    m_masks.assign(numMasks * numWords, 0u);
+    for (uint32_t state = 1u; state < m_classes.size(); state++) {
+        for (const auto& [lo, hi] : m_classes[state].ranges()) {
+            for (auto c = lo; c <= hi and c < numMasks; c++) {
+                m_masks[c * numWords + state / WORD_BITS] |= Word(1u) << state % WORD_BITS;
+            }
+        }
+    }
+    m_followOf.clear();
+    m_followOf.shrink_to_fit();
+}
+
+uint32_t GlushkovNFA::addPosition(const CharClass& charClass) {
+    m_classes.push_back(charClass);
+    m_followOf.emplace_back(m_followOf.front().size(), 0u);
+    return static_cast<uint32_t>(m_classes.size() - 1u);
+}
+
+GlushkovNFA::Fragment GlushkovNFA::concatenate(Fragment a, const Fragment& b) {
+    forEachState(a.last, [&](const uint32_t state) { orInto(m_followOf[state], b.first); });
+    if (a.isNullable) {
+        orInto(a.first, b.first);
+    }
+    if (not b.isNullable) {
+        a.last = b.last;
+    }
+    else {
+        orInto(a.last, b.last);
+    }
+    a.isNullable = a.isNullable and b.isNullable;
+    return a;
+}
+
+GlushkovNFA::Fragment GlushkovNFA::build(const AST::Node& node) {
+    const auto numWords = m_followOf.front().size();
+    Fragment fragment{Set(numWords, 0u), Set(numWords, 0u), true};
+    const auto single = [&](const CharClass& charClass) {
+        const auto state = addPosition(charClass);
+        Fragment position{Set(numWords, 0u), Set(numWords, 0u), false};
+        position.first[state / WORD_BITS] |= Word(1u) << state % WORD_BITS;
+        position.last = position.first;
+        return position;
+    };
+    switch (node.type) {
+    case AST::Node::Type::empty:
+        break;
+    case AST::Node::Type::literal:
+        for (const auto c : node.chars) {
+            fragment = concatenate(std::move(fragment), single(CharClass(c)));
+        }
+        break;
+    case AST::Node::Type::char_class:
+        fragment = single(node.charClass);
+        break;
+    case AST::Node::Type::concatenation:
+        for (const auto& child : node.children) {
+            fragment = concatenate(std::move(fragment), build(*child));
+        }
+        break;
+    case AST::Node::Type::alternation:
+        fragment.isNullable = false;
+        for (const auto& child : node.children) {
+            const auto alternative = build(*child);
+            orInto(fragment.first, alternative.first);
+            orInto(fragment.last, alternative.last);
+            fragment.isNullable = fragment.isNullable or alternative.isNullable;
+        }
+        break;
+    case AST::Node::Type::repetition:
+        fragment = buildRepetition(node);
+        break;
+    case AST::Node::Type::capture:
+        fragment = build(*node.children.front());
+        break;
+    }
+    return fragment;
+}
+
+/* x{2,} is built as x x+ and x{1,3} as x x? x?, each copy having its own states */
+GlushkovNFA::Fragment GlushkovNFA::buildRepetition(const AST::Node& node) {
+    const auto numWords = m_followOf.front().size();
+    Fragment fragment{Set(numWords, 0u), Set(numWords, 0u), true};
+    const auto& child = *node.children.front();
+    for (uint32_t copy = 1u; copy < node.min; copy++) {
+        fragment = concatenate(std::move(fragment), build(child));
+    }
+    if (node.max == AST::Node::UNBOUNDED) {
+        auto loop = build(child);
+        forEachState(loop.last, [&](const uint32_t state) { orInto(m_followOf[state], loop.first); });
+        loop.isNullable = loop.isNullable or node.min == 0u;
+        return concatenate(std::move(fragment), loop);
+    }
+    if (node.min > 0u) {
+        fragment = concatenate(std::move(fragment), build(child));
+    }
+    for (auto copy = std::max(node.min, 1u); copy <= node.max and node.max > 0u; copy++) {
+        if (copy == node.min) {
+            continue;
+        }
+        auto optional = build(child);
+        optional.isNullable = true;
+        fragment = concatenate(std::move(fragment), optional);
+    }
+    return fragment;
+}
+
+GlushkovNFA::Word const* GlushkovNFA::maskOf(const int32_t c, Set& scratch) const {
+    if (not m_isUTF8 or (c >= 0 and c < 0x80)) {
+        return &m_masks[c * numWords()];
+    }
+    scratch.assign(numWords(), 0u);
+    if (c == UTF8::INVALID) {
+        return scratch.data();
+    }
+    for (uint32_t state = 1u; state < m_classes.size(); state++) {
+        const auto& ranges = m_classes[state].ranges();
+        const auto it = std::upper_bound(ranges.begin(), ranges.end(), CharClass::Range(c, CharClass::MAX_CODEPOINT));
+        if (it != ranges.begin() and std::prev(it)->second >= static_cast<uint32_t>(c)) {
+            scratch[state / WORD_BITS] |= Word(1u) << state % WORD_BITS;
+        }
+    }
+    return scratch.data();
+}
+
+/* A malformed sequence is a single byte matching nothing */
+GlushkovNFA::Word const* GlushkovNFA::maskAt(std::string_view str, size_t& pos, Set& scratch) const {
+    if (not m_isUTF8) {
+        return maskOf(static_cast<uint8_t>(str[pos++]), scratch);
+    }
+    const auto c = UTF8::decode(str, pos);
+    if (c == UTF8::INVALID) {
+        pos++;
+    }
+    return maskOf(c, scratch);
+}
+
+GlushkovNFA::Word const* GlushkovNFA::maskBefore(std::string_view str, size_t& pos, Set& scratch) const {
+    if (not m_isUTF8) {
+        return maskOf(static_cast<uint8_t>(str[--pos]), scratch);
+    }
+    const auto end = pos;
+    auto start = end - 1u;
+    while (start > 0u and end - start < UTF8::MAX_SEQUENCE_LENGTH and (static_cast<uint8_t>(str[start]) & 0xc0u) == 0x80u) {
+        start--;
+    }
+    auto next = start;
+    const auto c = UTF8::decode(str, next);
+    if (c == UTF8::INVALID or next != end) {
+        pos = end - 1u;
+        return maskOf(UTF8::INVALID, scratch);
+    }
+    pos = start;
+    return maskOf(c, scratch);
+}
+
+int32_t GlushkovNFA::distance(std::string_view str, const uint32_t maxEdits) const {
+    Levels levels(m_forward, maxEdits);
+    Set scratch;  // for the codepoints past ASCII
+    for (size_t pos = 0u; pos < str.size();) {
+        levels.step(maskAt(str, pos, scratch), false);
+        if (levels.isEmpty()) {
+            return -1;
+        }
+    }
+    return levels.edits();
+}
+
+int32_t GlushkovNFA::find(std::string_view str, const uint32_t maxEdits, std::string_view& match) const {
+    Levels levels(m_forward, maxEdits);
+    Set scratch;  // for the codepoints past ASCII
+    auto edits = levels.edits();
+    size_t end = 0u;
+    for (size_t pos = 0u; pos < str.size();) {
+        levels.step(maskAt(str, pos, scratch), true);
+        const auto editsHere = levels.edits();
+        if (editsHere >= 0 and (edits < 0 or editsHere <= edits)) {
+            edits = editsHere;
+            end = pos;
+        }
+        else if (edits >= 0) {
+            break;
+        }
+    }
+    if (edits < 0) {
+        return -1;
+    }
+
+    // the start is found by the reversed pattern, anchored at the end
+    Levels reverseLevels(m_reverse, static_cast<uint32_t>(edits));
+    auto start = end;
+    for (size_t pos = end; pos > 0u and not reverseLevels.isEmpty();) {
+        reverseLevels.step(maskBefore(str, pos, scratch), false);
+        if (reverseLevels.edits() >= 0) {
+            start = pos;
+        }
+    }
+    match = str.substr(start, end - start);
+    return static_cast<int32_t>(start);
+}
+
+} // namespace RE
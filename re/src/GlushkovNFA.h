@@ -0,0 +1,104 @@
+#pragma once
+
+#include "AST.h"
+#include "CharClass.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace RE {
+
+/**
+ * The position automaton of a simplified AST, without ε-transitions: a
+ * state is a character of the pattern, or the initial state 0, and it is
+ * entered by the class of its character. Sets of states are bit vectors,
+ * and the states following a set are the union of their follow sets,
+ * looked up a byte of the set at a time (Navarro and Raffinot), so that
+ * a step costs a few loads per 64 states rather than one per state.
+ *
+ * Approximate matching runs Wu and Manber's levels on it: the states
+ * reached from the input with at most j edits, for each j up to the
+ * maximum, each level being computed from the one below. An edit is the
+ * insertion, deletion or substitution of a character, i.e. of a byte, or
+ * of a codepoint in the UTF-8 mode, and a step costs O(maxEdits) set
+ * operations whatever the pattern.
+ */
+class GlushkovNFA {
+public:
+    using Word = uint64_t;
+    /* the characters of the pattern once its counted repetitions are unrolled */
+    static constexpr size_t MAX_POSITIONS = 512u;
+
+    GlushkovNFA(const AST::Node&, const bool isUTF8);
+
+    size_t numPositions() const { return m_classes.size() - 1u; }
+    /* The fewest edits making the whole string match, or -1 if more than maxEdits */
+    int32_t distance(std::string_view, const uint32_t maxEdits) const;
+    /**
+     * The start of the substring matched with the fewest edits which ends
+     * first, extended to the right while its edits do not grow and then to
+     * the left as far as these edits allow, or -1 if none is within
+     * maxEdits
+     */
+    int32_t find(std::string_view, const uint32_t maxEdits, std::string_view& match) const;
+
+private:
+    using Set = std::vector<Word>;  // of states, numWords() long
+
+    struct Fragment {
+        Set first;
+        Set last;
+        bool isNullable = false;
+    };
+
+    /* The states following the sets, by byte of the set, for the pattern or its reverse */
+    struct Automaton {
+        std::vector<Word> follow;  // by chunk of 8 states, then by byte, then by word
+        Set finals;
+        size_t numWords = 0u;
+
+        Automaton() = default;
+        Automaton(const std::vector<Set>& followOf, Set finals);
+        void next(Word const* from, Word* to) const;
+    };
+
+    /* The states reached with at most j edits, for j up to maxEdits */
+    class Levels {
+    public:
+        Levels(const Automaton&, const uint32_t maxEdits);
+        /* Searching, the automaton is restarted before every character */
+        void step(Word const* mask, const bool isSearch);
+        int32_t edits() const;  // the fewest at a final state, or -1
+        bool isEmpty() const;
+
+    private:
+        static constexpr size_t NUM_SCRATCH_SETS = 3u;
+
+        const Automaton& m_automaton;
+        const size_t m_numWords;
+        const size_t m_numLevels;
+        std::vector<Word> m_words;  // the sets by level, then the scratch sets
+    };
+
+    size_t numWords() const { return m_forward.numWords; }
+    Fragment build(const AST::Node&);
+    Fragment buildRepetition(const AST::Node&);
+    Fragment concatenate(Fragment, const Fragment&);
+    uint32_t addPosition(const CharClass&);
+    /* The states entered by the character at pos, which moves past it either way */
+    Word const* maskAt(std::string_view, size_t& pos, Set& scratch) const;
+    Word const* maskBefore(std::string_view, size_t& pos, Set& scratch) const;
+    Word const* maskOf(const int32_t c, Set& scratch) const;
+
+    const bool m_isUTF8;
+    std::vector<CharClass> m_classes;  // by state, none for the initial one
+    std::vector<Set> m_followOf;       // while building
+    Automaton m_forward;
+    Automaton m_reverse;
+    /* by byte, or by ASCII character in the UTF-8 mode */
+    std::vector<Word> m_masks;
+};
+
+} // namespace RE
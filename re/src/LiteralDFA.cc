@@ -0,0 +1,172 @@
+#include "LiteralDFA.h"
+#include "UTF8.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace RE {
+
+namespace {
+
+/* The bytes of a literal, of a class of a single char or of a sequence of them */
+bool appendWord(const AST::Node& node, const bool isUTF8, std::string& word) {
+    std::vector<uint32_t> chars;
+    switch (node.type) {
+    case AST::Node::Type::empty:
+        return true;
+    case AST::Node::Type::literal:
+        chars = node.chars;
+        break;
+    case AST::Node::Type::char_class:
+        if (not node.charClass.isSingle()) {
+            return false;
+        }
+        chars.push_back(node.charClass.min());
+        break;
+    case AST::Node::Type::concatenation:
+        return std::all_of(node.children.begin(), node.children.end(), [&](const AST::NodePtr& child) {
+            return appendWord(*child, isUTF8, word);
+        });
+    default:
+        return false;
+    }
+    for (const auto c : chars) {
+        if (isUTF8) {
+            uint8_t encoded[UTF8::MAX_SEQUENCE_LENGTH];
+            word.append(reinterpret_cast<const char*>(encoded), UTF8::encode(c, encoded));
+        }
+        else {
+            word.push_back(static_cast<char>(c));
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+/**
+ * The parser nests the alternatives to the left, so the alternations are
+ * walked with a stack rather than recursively, however many words. The
+ * groups of a single alternation, e.g. (a|b) once its capture is erased,
+ * are seen through.
+ */
+std::optional<std::vector<std::string>> LiteralDFA::wordsOf(const AST::Node& ast, const bool isUTF8) {
+    std::vector<std::string> words;
+    bool isAlternation = false;
+    std::vector<AST::Node const*> toVisit{&ast};
+    while (not toVisit.empty()) {
+        const auto& node = *toVisit.back();
+        toVisit.pop_back();
+        if (node.type == AST::Node::Type::alternation) {
+            isAlternation = true;
+            for (auto it = node.children.rbegin(); it != node.children.rend(); ++it) {
+                toVisit.push_back(it->get());
+            }
+            continue;
+        }
+        if (node.type == AST::Node::Type::concatenation and node.children.size() == 1u) {
+            toVisit.push_back(node.children.front().get());
+            continue;
+        }
+        std::string word;
+        if (not appendWord(node, isUTF8, word)) {
+            return std::nullopt;
+        }
+        words.push_back(std::move(word));
+    }
+    if (not isAlternation) {
+        return std::nullopt;  // a single literal is no dictionary
+    }
+    return words;
+}
+
+size_t LiteralDFA::Hash::operator()(const Node& node) const {
+    size_t hash = node.isFinal;
+    for (const auto& [byte, to] : node.edges) {
+        hash = (hash * 0x100000001b3ull) ^ (size_t(to) << 8u | byte);
+    }
+    return hash;
+}
+
+LiteralDFA::LiteralDFA(std::vector<std::string> words) {
+    std::sort(words.begin(), words.end());
+    words.erase(std::unique(words.begin(), words.end()), words.end());
+
+    std::unordered_map<Node, NodeId, Hash> registered;
+    std::vector<NodeId> path{makeNode()};  // the states of the previous word
+    std::string_view previous;
+    const auto minimizeFrom = [&](const size_t depth) {
+        for (auto i = path.size() - 1u; i > depth; i--) {
+            const auto [it, isNew] = registered.try_emplace(m_nodes[path[i]], path[i]);
+            if (not isNew) {
+                // the replaced node is left unreachable, and dropped by make
+                m_nodes[path[i - 1u]].edges.back().second = it->second;
+            }
+        }
+        path.resize(depth + 1u);
+    };
+    for (const auto& word : words) {
+        const auto prefix = std::mismatch(previous.begin(), previous.end(), word.begin(), word.end()).first -
+                            previous.begin();
+        minimizeFrom(prefix);
+        for (auto i = static_cast<size_t>(prefix); i < word.size(); i++) {
+            const auto node = makeNode();
+            m_nodes[path.back()].edges.emplace_back(static_cast<uint8_t>(word[i]), node);
+            path.push_back(node);
+        }
+        m_nodes[path.back()].isFinal = true;
+        previous = word;
+    }
+    minimizeFrom(0u);
+}
+
+LiteralDFA::NodeId LiteralDFA::makeNode() {
+    m_nodes.emplace_back();
+    return static_cast<NodeId>(m_nodes.size() - 1u);
+}
+
+/**
+ * The states are the nodes reached from the root, numbered breadth-first
+ * by byte. Each byte on an edge being a class of its own, the classes are
+ * in the order of their bytes, so the states are already numbered as
+ * breadthFirstOrder would, and the table is compressed as it is.
+ */
+DFA LiteralDFA::make() const {
+    DFA dfa;
+    ByteSet bytes;
+    for (const auto& node : m_nodes) {
+        for (const auto& [byte, _] : node.edges) {
+            bytes.add(byte);
+        }
+    }
+    for (size_t byte = 0u; byte < ByteSet::NUM_BYTES; byte++) {
+        if (bytes.contains(byte)) {
+            dfa.m_byteClasses.refine(ByteSet(byte));
+        }
+    }
+    const auto numClasses = dfa.m_byteClasses.numClasses();
+    std::vector<DFA::StateId> stateOf(m_nodes.size(), DFA::DEAD);
+    std::vector<NodeId> nodes{0u, 0u};  // by state, the dead state having no node
+    stateOf[0u] = dfa.m_start = 1;
+    dfa.m_transitions.assign(2u * numClasses, DFA::DEAD);
+    dfa.m_finals.assign(1u, false);
+    dfa.m_tokens.assign(1u, NO_TOKEN);
+    for (size_t state = 1u; state < nodes.size(); state++) {
+        const auto& node = m_nodes[nodes[state]];
+        dfa.m_finals.push_back(node.isFinal);
+        dfa.m_tokens.push_back(node.isFinal ? 0u : NO_TOKEN);
+        for (const auto& [byte, to] : node.edges) {
+            if (stateOf[to] == DFA::DEAD) {
+                stateOf[to] = static_cast<DFA::StateId>(nodes.size());
+                nodes.push_back(to);
+                dfa.m_transitions.resize(nodes.size() * numClasses, DFA::DEAD);
+            }
+            dfa.m_transitions[state * numClasses + dfa.m_byteClasses.classOf(byte)] = stateOf[to];
+        }
+    }
+    dfa.accelerate();
+    dfa.compress();
+    return dfa;
+}
+
+} // namespace RE
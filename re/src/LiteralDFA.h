@@ -0,0 +1,50 @@
+#pragma once
+
+#include "AST.h"
+#include "FA.h"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace RE {
+
+/**
+ * Builds the minimal DFA of an alternation of literals, e.g. a dictionary
+ * of keywords, as a minimal acyclic word graph (DAWG), without the NFA,
+ * the subset construction and the minimizer, which would rediscover the
+ * prefixes and the suffixes shared by the words.
+ *
+ * The words are added in sorted order (Daciuk et al.'s incremental
+ * construction): the states of the previous word past its common prefix
+ * with the next one can no longer change, so they are replaced by an
+ * equivalent state already registered, or registered themselves. Time and
+ * memory are linear in the size of the dictionary.
+ */
+class LiteralDFA {
+public:
+    /* The words of an AST which is an alternation of literals, captures erased */
+    static std::optional<std::vector<std::string>> wordsOf(const AST::Node&, const bool isUTF8);
+
+    explicit LiteralDFA(std::vector<std::string> words);
+    DFA make() const;
+
+private:
+    using NodeId = uint32_t;
+    struct Node {
+        std::vector<std::pair<uint8_t, NodeId>> edges;  // by increasing byte
+        bool isFinal = false;
+
+        bool operator==(const Node& other) const { return isFinal == other.isFinal and edges == other.edges; }
+    };
+    struct Hash {
+        size_t operator()(const Node&) const;
+    };
+
+    NodeId makeNode();
+
+    std::vector<Node> m_nodes;  // the root first
+};
+
+} // namespace RE
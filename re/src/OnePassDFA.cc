@@ -0,0 +1,138 @@
+#include "OnePassDFA.h"
+
+#include <map>
+
+namespace RE {
+
+OnePassDFA::OnePassDFA(const TaggedNFA& nfa) :
+    m_numGroups(nfa.m_numGroups)
+{
+    // Each state of the one-pass DFA is the NFA state reached after a symbol
+    std::vector<int32_t> nfaStates{0};
+    m_stateOfNFAState[0] = 0;
+    for (size_t i = 0; i < nfaStates.size() and m_isOnePass; i++) {
+        if (nfaStates.size() > MAX_NUM_STATES) {
+            m_isOnePass = false;
+        }
+        else {
+            m_isOnePass = addState(nfa, nfaStates[i], nfaStates);
+        }
+    }
+    m_stateOfNFAState.clear();
+    if (not m_isOnePass) {
+        m_transitions.clear();
+        m_finals.clear();
+        m_tags.clear();
+    }
+    // grown state by state
+    m_transitions.shrink_to_fit();
+    m_finals.shrink_to_fit();
+    m_tags.shrink_to_fit();
+}
+
+/**
+ * Walk the epsilon closure of the NFA state. The pattern is not one-pass if
+ * a state of the closure is reached by paths with different tags, or if a
+ * symbol leads to different NFA states.
+ */
+bool OnePassDFA::addState(const TaggedNFA& nfa, const int32_t nfaState,
+                          std::vector<int32_t>& nfaStates) {
+    const auto from = m_finals.size();
+    m_finals.emplace_back();
+    m_transitions.resize(m_transitions.size() + NUM_SYMBOLS);
+
+    const auto stateOf = [this, &nfaStates](const int32_t to) {
+        const auto [it, isNew] = m_stateOfNFAState.try_emplace(to, nfaStates.size());
+        if (isNew) {
+            nfaStates.push_back(to);
+        }
+        return it->second;
+    };
+
+    std::map<int32_t, std::vector<int32_t>> visited;
+    std::vector<std::pair<int32_t, std::vector<int32_t>>> toVisit{{nfaState, {}}};
+    while (not toVisit.empty()) {
+        auto [current, tags] = std::move(toVisit.back());
+        toVisit.pop_back();
+
+        const auto& state = nfa.m_states[current];
+        if (state.tag != NO_TAG) {
+            tags.push_back(state.tag);
+        }
+        if (const auto it = visited.find(current); it != visited.end()) {
+            if (it->second != tags) {
+                return false;
+            }
+            continue;
+        }
+        visited[current] = tags;
+
+        if (state.isFinal) {
+            auto& finalState = m_finals[from];
+            if (finalState.isFinal and not hasSameTags(finalState.tags, tags)) {
+                return false;
+            }
+            finalState = {true, addTags(tags)};
+        }
+        for (const auto& [byteSet, to] : state.transitions) {
+            const auto toState = stateOf(to);
+            const auto toTags = addTags(tags);
+            for (size_t byte = 0u; byte < NUM_SYMBOLS; byte++) {
+                if (not byteSet.contains(byte)) {
+                    continue;
+                }
+                auto& transition = m_transitions[from * NUM_SYMBOLS + byte];
+                if (transition.to >= 0 and
+                    (transition.to != toState or not hasSameTags(transition.tags, tags))) {
+                    return false;
+                }
+                transition = {toState, toTags};
+            }
+        }
+        for (const auto to : state.epsTransitions) {
+            toVisit.emplace_back(to, tags);
+        }
+    }
+    return true;
+}
+
+OnePassDFA::Tags OnePassDFA::addTags(const std::vector<int32_t>& tags) {
+    const Tags ret{static_cast<uint32_t>(m_tags.size()),
+                   static_cast<uint32_t>(m_tags.size() + tags.size())};
+    m_tags.insert(m_tags.end(), tags.begin(), tags.end());
+    return ret;
+}
+
+bool OnePassDFA::hasSameTags(const Tags tags, const std::vector<int32_t>& other) const {
+    return std::vector<int32_t>(m_tags.begin() + tags.begin,
+                                m_tags.begin() + tags.end) == other;
+}
+
+void OnePassDFA::applyTags(const Tags tags, const int32_t pos, int32_t* groupTags) const {
+    for (auto i = tags.begin; i < tags.end; i++) {
+        groupTags[m_tags[i]] = pos;
+    }
+}
+
+bool OnePassDFA::match(std::string_view str, REParser::Groups_t& groups) const {
+    std::vector<int32_t> groupTags(2 * (m_numGroups + 1), -1);
+    size_t state = 0u;
+    for (size_t pos = 0; pos < str.size(); pos++) {
+        const auto& transition =
+            m_transitions[state * NUM_SYMBOLS + static_cast<uint8_t>(str[pos])];
+        if (transition.to < 0) {
+            return false;
+        }
+        applyTags(transition.tags, pos, groupTags.data());
+        state = transition.to;
+    }
+    const auto& finalState = m_finals[state];
+    if (not finalState.isFinal) {
+        return false;
+    }
+    applyTags(finalState.tags, str.size(), groupTags.data());
+    TaggedNFA::fillGroups(str, groupTags.data(), m_numGroups, groups);
+    return true;
+}
+
+} // namespace RE
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "TaggedNFA.h"
+
+#include <RE.h>
+
+#include <cstdint>
+#include <map>
+#include <string_view>
+#include <vector>
+
+namespace RE {
+
+/**
+ * A DFA with tagged transitions for one-pass patterns, i.e. those where at
+ * each position the next input symbol decides which path of the NFA is
+ * taken, e.g. (\d+)-(\d+). Each transition records the tags met in the
+ * epsilon closure before consuming the symbol, so the submatches are
+ * extracted in a single scan.
+ */
+class OnePassDFA {
+public:
+    OnePassDFA(const TaggedNFA&);
+
+    bool isOnePass() const { return m_isOnePass; }
+    bool match(std::string_view, REParser::Groups_t&) const;
+    size_t memoryUsage() const {
+        return sizeof(*this) + m_transitions.capacity() * sizeof(Transition) +
+               m_finals.capacity() * sizeof(Final) + m_tags.capacity() * sizeof(int32_t);
+    }
+
+private:
+    static constexpr size_t NUM_SYMBOLS = 256u;
+    static constexpr size_t MAX_NUM_STATES = 512u;
+
+    struct Tags {
+        uint32_t begin = 0u;
+        uint32_t end = 0u;
+    };
+
+    struct Transition {
+        int32_t to = -1;
+        Tags tags;
+    };
+
+    struct Final {
+        bool isFinal = false;
+        Tags tags;
+    };
+
+    bool addState(const TaggedNFA&, const int32_t, std::vector<int32_t>&);
+    Tags addTags(const std::vector<int32_t>&);
+    bool hasSameTags(const Tags, const std::vector<int32_t>&) const;
+    void applyTags(const Tags, const int32_t, int32_t*) const;
+
+    bool m_isOnePass = true;
+    uint32_t m_numGroups;
+    std::vector<Transition> m_transitions;  // NUM_SYMBOLS per state
+    std::vector<Final> m_finals;
+    std::vector<int32_t> m_tags;  // storage of tags of transitions
+    std::map<int32_t, int32_t> m_stateOfNFAState;  // only used while building
+};
+
+} // namespace RE
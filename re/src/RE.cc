@@ -4,14 +4,97 @@
 
 namespace RE {
 
-REParser::REParser(REParser::RE_t re) : m_parser(new REParserImpl(re)) {}
+REParser::REParser(REParser::RE_t re, const uint32_t flags) :
+    m_parser(new REParserImpl(re, flags)) {}
 
+REParser::REParser(REParser::RE_t re, const uint32_t flags, std::pmr::memory_resource* compileResource) :
+    m_parser(new REParserImpl(re, flags, compileResource)) {}
+
+REParser::REParser(std::unique_ptr<REParserImpl> parser) :
+    m_parser(std::move(parser)) {}
+
+REParser::REParser(REParser&&) noexcept = default;
+REParser& REParser::operator=(REParser&&) noexcept = default;
 REParser::~REParser() = default;
 
+REParser REParser::intersectionOf(const REParser& a, const REParser& b) {
+    return REParser(REParserImpl::combine(*a.m_parser, *b.m_parser, DFAProduct::Operation::intersection));
+}
+
+REParser REParser::unionOf(const REParser& a, const REParser& b) {
+    return REParser(REParserImpl::combine(*a.m_parser, *b.m_parser, DFAProduct::Operation::union_));
+}
+
+REParser REParser::differenceOf(const REParser& a, const REParser& b) {
+    return REParser(REParserImpl::combine(*a.m_parser, *b.m_parser, DFAProduct::Operation::difference));
+}
+
+REParser REParser::complementOf(const REParser& parser) {
+    return REParser(REParserImpl::complement(*parser.m_parser));
+}
+
+bool REParser::isEmpty() const {
+    return m_parser->isEmpty();
+}
+
+bool REParser::isSubsetOf(const REParser& other) const {
+    return m_parser->isSubsetOf(*other.m_parser);
+}
+
 bool REParser::matchExact(REParser::Str_t str) const {
     return m_parser->matchExact(str);
 }
 
-int32_t REParser::find(REParser::Str_t) const { return -1; }
+bool REParser::matchExact(REParser::Str_t str, REParser::Groups_t& groups) const {
+    return m_parser->matchExact(str, groups);
+}
+
+size_t REParser::numGroups() const {
+    return m_parser->numGroups();
+}
+
+int32_t REParser::find(REParser::Str_t str) const {
+    std::string_view match;
+    return m_parser->find(str, match);
+}
+
+int32_t REParser::find(REParser::Str_t str, std::string_view& match) const {
+    return m_parser->find(str, match);
+}
+
+REParser::MatchRange REParser::findAll(REParser::Str_t str) const {
+    return MatchRange(m_parser.get(), str);
+}
+
+void REParser::addAlternative(REParser::RE_t alternative) {
+    m_parser->addAlternative(alternative);
+}
+
+size_t REParser::tableSize() const {
+    return m_parser->tableSize();
+}
+
+void REParser::optimizeLayout(const std::vector<std::string_view>& corpus) {
+    m_parser->optimizeLayout(corpus);
+}
+
+size_t REParser::memoryUsage() const {
+    return sizeof(*this) + m_parser->memoryUsage();
+}
+
+/**
+ * The search resumes at the end of the previous match, or one byte further
+ * after an empty match so that it makes progress
+ */
+REParser::MatchIterator& REParser::MatchIterator::operator++() {
+    size_t start, end;
+    if (m_next > m_str.size() or not m_parser->find(m_str, m_next, start, end)) {
+        *this = MatchIterator();
+        return *this;
+    }
+    m_match = m_str.substr(start, end - start);
+    m_next = end == start ? end + 1 : end;
+    return *this;
+}
 
 } // namespace RE
@@ -0,0 +1,42 @@
+#include "GlushkovNFA.h"
+#include "RECompiler.h"
+
+#include <REApproxMatcher.h>
+
+namespace RE {
+
+REApproxMatcher::REApproxMatcher(REParser::RE_t re, const uint32_t maxEdits, const uint32_t flags) :
+    m_maxEdits(maxEdits)
+{
+    auto ast = RECompiler(flags).parse(re);
+    AST::eraseCaptures(ast);
+    AST::simplify(ast);
+    m_nfa = std::make_unique<GlushkovNFA>(*ast, flags & REParser::UTF8);
+}
+
+REApproxMatcher::REApproxMatcher(REApproxMatcher&&) noexcept = default;
+REApproxMatcher& REApproxMatcher::operator=(REApproxMatcher&&) noexcept = default;
+REApproxMatcher::~REApproxMatcher() = default;
+
+bool REApproxMatcher::matchExact(REParser::Str_t str) const {
+    return m_nfa->distance(str, m_maxEdits) >= 0;
+}
+
+int32_t REApproxMatcher::distance(REParser::Str_t str) const {
+    return m_nfa->distance(str, m_maxEdits);
+}
+
+int32_t REApproxMatcher::find(REParser::Str_t str) const {
+    std::string_view match;
+    return m_nfa->find(str, m_maxEdits, match);
+}
+
+int32_t REApproxMatcher::find(REParser::Str_t str, std::string_view& match) const {
+    return m_nfa->find(str, m_maxEdits, match);
+}
+
+size_t REApproxMatcher::numPositions() const {
+    return m_nfa->numPositions();
+}
+
+} // namespace RE
@@ -0,0 +1,125 @@
+#include <REBulkCompile.h>
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace RE {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double microsecondsSince(const Clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+/**
+ * A deque of pattern indices per worker. The owner takes from the front
+ * and the thieves from the back, so that they rarely contend for the same
+ * end. No task is added once the workers start, so a worker finding every
+ * deque empty is done.
+ */
+class WorkQueues {
+public:
+    WorkQueues(const size_t numTasks, const size_t numWorkers) :
+        m_queues(numWorkers)
+    {
+        // contiguous shares, as neighbouring patterns tend to cost alike
+        for (size_t task = 0u; task < numTasks; task++) {
+            m_queues[task * numWorkers / numTasks].tasks.push_back(task);
+        }
+    }
+
+    bool pop(const size_t worker, size_t& task) {
+        if (popFront(m_queues[worker], task)) {
+            return true;
+        }
+        for (size_t i = 1u; i < m_queues.size(); i++) {
+            if (popBack(m_queues[(worker + i) % m_queues.size()], task)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<size_t> tasks;
+    };
+
+    static bool popFront(Queue& queue, size_t& task) {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) {
+            return false;
+        }
+        task = queue.tasks.front();
+        queue.tasks.pop_front();
+        return true;
+    }
+
+    static bool popBack(Queue& queue, size_t& task) {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) {
+            return false;
+        }
+        task = queue.tasks.back();
+        queue.tasks.pop_back();
+        return true;
+    }
+
+    std::vector<Queue> m_queues;
+};
+
+} // namespace
+
+BulkCompilation compileAll(const std::vector<std::string_view>& patterns, const uint32_t flags,
+                           size_t numThreads) {
+    const auto start = Clock::now();
+    if (numThreads == 0u) {
+        // hardware_concurrency may be unknown, i.e. 0
+        numThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    BulkCompilation compilation;
+    compilation.patterns.resize(patterns.size());
+    compilation.numThreads = std::max<size_t>(std::min(numThreads, patterns.size()), 1u);
+
+    WorkQueues queues(patterns.size(), compilation.numThreads);
+    const auto parserFlags = flags & ~REParser::PARALLEL_DETERMINIZATION;
+    // each pattern is written by a single worker, so the results need no lock
+    const auto work = [&](const size_t worker) {
+        size_t i;
+        while (queues.pop(worker, i)) {
+            auto& compiled = compilation.patterns[i];
+            const auto patternStart = Clock::now();
+            try {
+                compiled.parser = std::make_unique<REParser>(patterns[i], parserFlags);
+            }
+            catch (...) {
+                compiled.error = std::current_exception();
+            }
+            compiled.microseconds = microsecondsSince(patternStart);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t worker = 1u; worker < compilation.numThreads; worker++) {
+        workers.emplace_back(work, worker);
+    }
+    work(0u);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    for (const auto& compiled : compilation.patterns) {
+        compilation.numErrors += compiled.error != nullptr;
+        compilation.summedMicroseconds += compiled.microseconds;
+    }
+    compilation.wallMicroseconds = microsecondsSince(start);
+    return compilation;
+}
+
+} // namespace RE
@@ -0,0 +1,17 @@
+#include "RECompiler.h"
+
+#include <RECompileProfile.h>
+
+namespace RE {
+
+CompileProfile profileCompile(REParser::RE_t re, const uint32_t flags,
+                              const std::function<void(CompileProfile::Phase)>& onPhaseEnd) {
+    CompileProfile profile;
+    RECompiler compiler(flags);
+    compiler.startProfile(profile, onPhaseEnd);
+    auto ast = compiler.parse(re);
+    compiler.makeDFA(ast);
+    return profile;
+}
+
+} // namespace RE
@@ -0,0 +1,516 @@
+#include "DFAMinimizer.h"
+#include "DerivativeDFA.h"
+#include "LiteralDFA.h"
+#include "RECompiler.h"
+#include "REParsingStack.h"
+
+#include <REExceptions.h>
+
+#include <algorithm>
+#include <thread>
+
+namespace RE {
+
+AST::NodePtr RECompiler::parse(std::string_view re) {
+    startParsing(re);
+    return ASTFromRe();
+}
+
+DFA RECompiler::makeDFA(AST::NodePtr& ast) {
+    AST::eraseCaptures(ast);
+    auto words = LiteralDFA::wordsOf(*ast, isUTF8());
+    if (not words) {
+        AST::simplify(ast);
+    }
+    endPhase(CompileProfile::PARSE);
+    // built directly, minimal as made from literals, minimized as made from derivatives
+    if (words or m_flags & REParser::DERIVATIVES) {
+        endPhase(CompileProfile::NFA);
+        DerivativeDFA derivatives(isUTF8());
+        auto dfa = words ? LiteralDFA(std::move(*words)).make() : derivatives.make(*ast);
+        if (m_profile != nullptr) {
+            m_profile->numDFAStates = words ? dfa.numStates() : derivatives.numStatesBuilt();
+            m_profile->numMinimizedStates = dfa.numStates();
+        }
+        endPhase(CompileProfile::SUBSETS);
+        endPhase(CompileProfile::MINIMIZATION);
+        return dfa;
+    }
+    NFAState* nfa = NFAFromAST(*ast);
+    if (m_profile != nullptr) {
+        m_profile->numNFAStates = m_stateManager.m_NFAs.size();
+    }
+    endPhase(CompileProfile::NFA);
+    m_stateManager.DFAFromNFA(nfa, numThreads());
+    if (m_profile != nullptr) {
+        m_profile->numDFAStates = m_stateManager.m_DFAs.size();
+    }
+    endPhase(CompileProfile::SUBSETS);
+    auto dfa = DFAMinimizer(m_stateManager).minimize();
+    if (m_profile != nullptr) {
+        m_profile->numMinimizedStates = dfa.numStates();
+    }
+    endPhase(CompileProfile::MINIMIZATION);
+    return dfa;
+}
+
+DFA RECompiler::makeScannerDFA(const std::vector<std::string_view>& rules) {
+    std::vector<NFA> nfas;
+    for (const auto rule : rules) {
+        auto ast = parse(rule);
+        AST::eraseCaptures(ast);
+        AST::simplify(ast);
+        nfas.push_back(makeNFA(*ast));
+    }
+    m_stateManager.DFAFromNFA(m_stateManager.makeScanner(nfas), numThreads());
+    return DFAMinimizer(m_stateManager).minimize();
+}
+
+std::unique_ptr<TaggedNFA> RECompiler::makeTaggedNFA(AST::NodePtr& ast) {
+    AST::simplify(ast);
+    return std::make_unique<TaggedNFA>(NFAFromAST(*ast), m_numGroups);
+}
+
+void RECompiler::startProfile(CompileProfile& profile,
+                              const std::function<void(CompileProfile::Phase)>& onPhaseEnd) {
+    m_profile = &profile;
+    m_onPhaseEnd = onPhaseEnd;
+    m_phaseStart = std::chrono::steady_clock::now();
+}
+
+/* The time of the callback is left out of the next phase */
+void RECompiler::endPhase(const CompileProfile::Phase phase) {
+    if (m_profile == nullptr) {
+        return;
+    }
+    const std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - m_phaseStart;
+    m_profile->microseconds[phase] += elapsed.count();
+    if (m_onPhaseEnd) {
+        m_onPhaseEnd(phase);
+    }
+    m_phaseStart = std::chrono::steady_clock::now();
+}
+
+void RECompiler::startParsing(std::string_view re) {
+    m_re = re;
+    m_pos = 0u;
+    m_sym = re.empty() ? '\0' : re[0];
+    m_isLastStateRepetition = false;
+    m_numGroups = 0u;
+    m_stack.clear();
+}
+
+size_t RECompiler::numThreads() const {
+    // hardware_concurrency may be unknown, i.e. 0
+    return m_flags & REParser::PARALLEL_DETERMINIZATION ?
+           std::max(std::thread::hardware_concurrency(), 2u) : 1u;
+}
+
+AST::NodePtr RECompiler::ASTFromRe() {
+    for (char lastSym = 0;
+         m_pos < m_re.size();
+         m_isLastStateRepetition = checkIsLastStateRepetition(lastSym), advance(), lastSym = m_sym)
+    {
+        switch (m_sym) {
+        case BAR:
+            parseBar();
+            break;
+        case LEFT_PAREN:
+            parseLeftParen();
+            break;
+        case RIGHT_PAREN:
+            parseRightParen();
+            break;
+        case LEFT_BRACE:
+            parseLeftBrace();
+            break;
+        case RIGHT_BRACE:
+            throw UnbalancedBraceException(m_pos);
+        case LEFT_BRACKET:
+            parseLeftBracket();
+            break;
+        case RIGHT_BRACKET:
+            throw UnbalancedBracketException(m_pos);
+        case DOT:
+            parseDot();
+            break;
+        case KLEENE_STAR:
+        case PLUS:
+        case QUESTION:
+            parseRepetition();
+            break;
+        case ESCAPE:
+            parseEscape();
+            break;
+        default:
+            parseSym();
+        }
+    }
+    return makeLastGroup(REParsingStack::GroupStartType::re_start);
+}
+
+NFAState* RECompiler::NFAFromAST(const AST::Node& ast) {
+    NFA nfa = makeNFA(ast);
+    return nfa.isEmpty() ?
+           m_stateManager.makeNFAState(true) :
+           nfa.startState;
+}
+
+NFA RECompiler::makeNFA(const AST::Node& node) {
+    switch (node.type) {
+    case AST::Node::Type::empty:
+        return NFA();
+    case AST::Node::Type::literal: {
+        std::string bytes;
+        for (const auto c : node.chars) {
+            if (isUTF8()) {
+                uint8_t encoded[UTF8::MAX_SEQUENCE_LENGTH];
+                bytes.append(reinterpret_cast<const char*>(encoded), UTF8::encode(c, encoded));
+            }
+            else {
+                bytes.push_back(static_cast<char>(c));
+            }
+        }
+        return m_stateManager.makeLiteral(bytes);
+    }
+    case AST::Node::Type::char_class:
+        return makeCharClassNFA(node.charClass);
+    case AST::Node::Type::concatenation: {
+        NFA nfa;
+        for (const auto& child : node.children) {
+            NFA childNfa = makeNFA(*child);
+            nfa = m_stateManager.makeConcatenation(nfa, childNfa);
+        }
+        return nfa;
+    }
+    case AST::Node::Type::alternation: {
+        // the simplification leaves no empty alternative
+        std::vector<NFA> nfas;
+        for (const auto& child : node.children) {
+            nfas.push_back(makeNFA(*child));
+        }
+        return m_stateManager.makeAlternation(nfas);
+    }
+    case AST::Node::Type::repetition:
+        return makeRepetition(node);
+    case AST::Node::Type::capture: {
+        NFA nfa = makeNFA(*node.children.front());
+        return m_stateManager.makeCapture(nfa, node.group);
+    }
+    }
+    assert(false and "Unexpected AST node");
+    return NFA();
+}
+
+/**
+ * a{2,} is built as aa+ and a{1,3} as aa?a?, with a fresh copy of the NFA
+ * of a for each occurrence
+ */
+NFA RECompiler::makeRepetition(const AST::Node& node) {
+    const auto& child = *node.children.front();
+    // only the sequences share their start and end states with their parts
+    const auto makeCopy = [this, &child] {
+        NFA copy = makeNFA(child);
+        return child.type == AST::Node::Type::concatenation or
+               child.type == AST::Node::Type::repetition ?
+               m_stateManager.makeIsolated(copy) :
+               copy;
+    };
+    NFA nfa;
+    for (auto count = 0u; count < node.min; count++) {
+        NFA copy = makeCopy();
+        if (count + 1 == node.min and node.max == AST::Node::UNBOUNDED) {
+            copy = m_stateManager.makePlus(copy);
+        }
+        nfa = m_stateManager.makeConcatenation(nfa, copy);
+    }
+    if (node.max == AST::Node::UNBOUNDED) {
+        if (node.min == 0u) {
+            NFA copy = makeCopy();
+            copy = m_stateManager.makeKleeneClousure(copy);
+            nfa = m_stateManager.makeConcatenation(nfa, copy);
+        }
+        return nfa;
+    }
+    for (auto count = node.min; count < node.max; count++) {
+        NFA copy = makeCopy();
+        copy = m_stateManager.makeQuestion(copy);
+        nfa = m_stateManager.makeConcatenation(nfa, copy);
+    }
+    return nfa;
+}
+
+void RECompiler::advance() noexcept {
+    m_pos++;
+    m_sym = m_pos < m_re.size() ? m_re[m_pos] : '\0';
+}
+
+bool RECompiler::checkIsLastStateRepetition(const char lastSym) const noexcept {
+    switch (lastSym) {
+        case KLEENE_STAR:
+        case PLUS:
+        case QUESTION:
+        case LEFT_BRACE:
+            return true;
+        default:
+            return false;
+    }
+}
+
+AST::NodePtr RECompiler::makeLastGroup(const REParsingStack::GroupStartType type) {
+    while (true) {
+        const auto lastGroupStartType = m_stack.getLastGroupStart().type;
+        const auto lastGroupStartPosInRe = m_stack.getLastGroupStart().posInRe;
+        auto nodes = m_stack.popTillLastGroupStart(type);
+        switch (lastGroupStartType) {
+        case REParsingStack::GroupStartType::parenthesis:
+            switch (type) {
+                case REParsingStack::GroupStartType::re_start:
+                    throw MissingParenthsisException(lastGroupStartPosInRe);
+                case REParsingStack::GroupStartType::bar:
+                case REParsingStack::GroupStartType::parenthesis:
+                    return AST::makeConcatenation(std::move(nodes));
+            }
+            assert(false and "Unexpected group start");
+            return nullptr;
+        case REParsingStack::GroupStartType::re_start:
+            switch (type) {
+                case REParsingStack::GroupStartType::parenthesis:
+                    throw UnbalancedParenthesisException(m_pos);
+                case REParsingStack::GroupStartType::bar:
+                case REParsingStack::GroupStartType::re_start:
+                    return AST::makeConcatenation(std::move(nodes));
+            }
+            assert(false and "Unexpected group start");
+            return nullptr;
+        case REParsingStack::GroupStartType::bar: {
+            auto nodeAfterBar = AST::makeConcatenation(std::move(nodes));
+            auto nodeBeforeBar = m_stack.popOne();
+            m_stack.push(
+                AST::makeAlternation(std::move(nodeBeforeBar), std::move(nodeAfterBar)));
+            break;
+        }
+        }
+    }
+}
+
+void RECompiler::parseLeftBrace() {
+    const auto braceStart = m_pos;
+    auto lastNode = checkRepetitionAndPopLastNode();
+    const auto numRepetitions = parseNumRepetitions(braceStart);
+    m_stack.push(AST::makeRepetition(std::move(lastNode), numRepetitions, numRepetitions));
+}
+
+uint32_t RECompiler::parseNumRepetitions(const uint32_t braceStart) {
+    auto numRepetitions = 0u;
+    for (advance();  // start from the next symbol after '{'
+         m_sym != RIGHT_BRACE;
+         advance())
+    {
+        if (m_pos == m_re.size()) {
+            throw MissingBraceException(braceStart);
+        }
+        if (m_sym < '0' or m_sym > '9') {
+            throw NondigitInBracesException(m_sym, m_pos);
+        }
+        numRepetitions = numRepetitions * 10 + (m_sym - '0');
+        if (numRepetitions > MAX_BRACES_REPETITION) {
+            throw TooLargeRepetitionNumberException();
+        }
+    }
+    if (braceStart + 1 == m_pos) {
+        throw EmptyBracesException(braceStart);
+    }
+    return numRepetitions;
+}
+
+void RECompiler::parseRepetition() {
+    auto lastNode = checkRepetitionAndPopLastNode();
+    switch (m_sym) {
+        case KLEENE_STAR:
+            m_stack.push(AST::makeRepetition(std::move(lastNode), 0u, AST::Node::UNBOUNDED));
+            break;
+        case PLUS:
+            m_stack.push(AST::makeRepetition(std::move(lastNode), 1u, AST::Node::UNBOUNDED));
+            break;
+        case QUESTION:
+            m_stack.push(AST::makeRepetition(std::move(lastNode), 0u, 1u));
+            break;
+        default:
+            assert(false and "Unexpected repeat symbol");
+    }
+}
+
+AST::NodePtr RECompiler::checkRepetitionAndPopLastNode() {
+    if (m_stack.getLastGroupStart().posInRe == static_cast<int32_t>(m_pos) - 1) {
+        throw NothingToRepeatException(m_pos);
+    }
+    if (m_isLastStateRepetition) {
+        throw MultipleRepeatException(m_pos);
+    }
+    return m_stack.popOne();
+}
+
+/**
+ * Parse the escape sequence starting at '\', leaving m_pos at its last symbol
+ */
+CharClass RECompiler::parseEscapeSequence() {
+    advance();  // check the next symbol after '\'
+    if (m_pos == m_re.size()) {
+        throw EscapeException("Escape reaches the end of the input");
+    }
+    switch (m_sym) {
+        case BAR:
+        case LEFT_PAREN:
+        case RIGHT_PAREN:
+        case LEFT_BRACE:
+        case RIGHT_BRACE:
+        case LEFT_BRACKET:
+        case RIGHT_BRACKET:
+        case KLEENE_STAR:
+        case PLUS:
+        case QUESTION:
+        case DOT:
+        case CARET:
+        case DASH:
+        case ESCAPE:
+            return CharClass(m_sym);
+        case ESCAPE_n:
+            return CharClass('\n');
+        case ESCAPE_t:
+            return CharClass('\t');
+        case ESCAPE_r:
+            return CharClass('\r');
+        case ESCAPE_f:
+            return CharClass('\f');
+        case ESCAPE_v:
+            return CharClass('\v');
+        case ESCAPE_x:
+            return CharClass(parseHexEscape(2u));
+        case ESCAPE_u:
+            if (not isUTF8()) {
+                throw EscapeException(m_sym, m_pos);
+            }
+            return CharClass(parseHexEscape(4u));
+        case ESCAPE_d:
+            return CharClass::digits();
+        case ESCAPE_D:
+            return CharClass::digits().negated(maxChar());
+        case ESCAPE_w:
+            return CharClass::word();
+        case ESCAPE_W:
+            return CharClass::word().negated(maxChar());
+        case ESCAPE_s:
+            return CharClass::space();
+        case ESCAPE_S:
+            return CharClass::space().negated(maxChar());
+        default:
+            throw EscapeException(m_sym, m_pos);
+    }
+}
+
+/**
+ * \xHH and \uHHHH with exactly the given number of hexadecimal digits.
+ * In the UTF-8 mode they denote codepoints.
+ */
+uint32_t RECompiler::parseHexEscape(const uint32_t numDigits) {
+    const auto hexDigit = [this]() {
+        advance();
+        if (m_sym >= '0' and m_sym <= '9') {
+            return m_sym - '0';
+        }
+        if (m_sym >= 'a' and m_sym <= 'f') {
+            return m_sym - 'a' + 10;
+        }
+        if (m_sym >= 'A' and m_sym <= 'F') {
+            return m_sym - 'A' + 10;
+        }
+        if (m_pos == m_re.size()) {
+            throw EscapeException("Escape reaches the end of the input");
+        }
+        throw EscapeException(m_sym, m_pos);
+    };
+    auto value = 0u;
+    for (auto i = 0u; i < numDigits; i++) {
+        value = value * 16 + hexDigit();
+    }
+    if (value >= UTF8::SURROGATE_START and value <= UTF8::SURROGATE_END) {
+        throw EscapeException("Surrogate codepoint at position " + std::to_string(m_pos));
+    }
+    return value;
+}
+
+void RECompiler::parseSym() {
+    m_stack.push(makeCharClass(CharClass(parseChar())));
+}
+
+/**
+ * A byte, or in the UTF-8 mode a codepoint, leaving m_pos at its last byte
+ */
+uint32_t RECompiler::parseChar() {
+    if (not isUTF8()) {
+        return static_cast<uint8_t>(m_sym);
+    }
+    size_t next = m_pos;
+    const auto codepoint = UTF8::decode(m_re, next);
+    if (codepoint == UTF8::INVALID) {
+        throw InvalidUTF8Exception(m_pos);
+    }
+    while (m_pos + 1 < next) {
+        advance();
+    }
+    return codepoint;
+}
+
+/**
+ * [abc], [a-z], [^"] and escapes within brackets. A ']' right after the
+ * open bracket (or after '^') and a '-' at either end are taken literally.
+ */
+void RECompiler::parseLeftBracket() {
+    const auto bracketStart = m_pos;
+    advance();
+    const bool isNegated = m_pos < m_re.size() and m_sym == CARET;
+    if (isNegated) {
+        advance();
+    }
+    const auto itemsStart = m_pos;
+    CharClass charClass;
+    while (m_pos < m_re.size() and (m_sym != RIGHT_BRACKET or m_pos == itemsStart)) {
+        charClass.add(parseBracketItem());
+        advance();
+    }
+    if (m_pos == m_re.size()) {
+        throw MissingBracketException(bracketStart);
+    }
+    // fold before negating, so that [^a] excludes 'A' as well
+    const auto folded = foldCase(charClass);
+    m_stack.push(makeCharClass(isNegated ? folded.negated(maxChar()) : folded));
+}
+
+CharClass RECompiler::parseBracketItem() {
+    const auto itemStart = m_pos;
+    const auto parseEndpoint = [this]() {
+        if (m_sym != ESCAPE) {
+            return CharClass(parseChar());
+        }
+        return parseEscapeSequence();
+    };
+    const auto lo = parseEndpoint();
+    const bool isRange = m_pos + 2 < m_re.size() and
+                         m_re[m_pos + 1] == DASH and m_re[m_pos + 2] != RIGHT_BRACKET;
+    if (not isRange) {
+        return lo;
+    }
+    advance();  // '-'
+    advance();
+    const auto hi = parseEndpoint();
+    if (not lo.isSingle() or not hi.isSingle()) {
+        throw InvalidRangeException(itemStart);
+    }
+    if (lo.min() > hi.min()) {
+        throw InvalidRangeException(itemStart);
+    }
+    return CharClass::range(lo.min(), hi.min());
+}
+
+} // namespace RE
@@ -0,0 +1,148 @@
+#pragma once
+
+#include "AST.h"
+#include "CharClass.h"
+#include "FA.h"
+#include "REParsingStack.h"
+#include "StateManager.h"
+#include "TaggedNFA.h"
+
+#include <RE.h>
+#include <RECompileProfile.h>
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <string_view>
+#include <vector>
+
+namespace RE {
+
+/**
+ * Parses the patterns and builds the automata REParserImpl matches with.
+ * The NFA and DFA states of the construction and the parsing stack live
+ * here, so they are all freed with the compiler once the automata are
+ * built; the automata it returns own their memory. The states, the stack
+ * and the temporaries of the constructions are allocated from the memory
+ * resource, which the automata returned do not refer to.
+ */
+class RECompiler {
+public:
+    explicit RECompiler(const uint32_t flags,
+                        std::pmr::memory_resource* resource = std::pmr::get_default_resource()) :
+        m_flags(flags),
+        m_stateManager(resource),
+        m_stack(Allocator(resource))
+    {}
+
+    /* The AST of the pattern, whose groups numGroups() then counts */
+    AST::NodePtr parse(std::string_view re);
+    uint32_t numGroups() const { return m_numGroups; }
+    /**
+     * The minimal DFA of the AST, which is simplified and its captures
+     * erased, built directly for a dictionary of literals, see LiteralDFA,
+     * or by derivatives if asked to
+     */
+    DFA makeDFA(AST::NodePtr&);
+    /* The scanner of the rules, see RELexer */
+    DFA makeScannerDFA(const std::vector<std::string_view>& rules);
+    /* Keeps the captures of the AST, which is simplified */
+    std::unique_ptr<TaggedNFA> makeTaggedNFA(AST::NodePtr&);
+    /* Time the phases of the next parse and makeDFA into the profile */
+    void startProfile(CompileProfile&, const std::function<void(CompileProfile::Phase)>& onPhaseEnd);
+
+private:
+    AST::NodePtr ASTFromRe();
+    void startParsing(std::string_view re);
+    /* Of the simplified AST */
+    NFAState* NFAFromAST(const AST::Node&);
+    void endPhase(const CompileProfile::Phase);
+    NFA makeNFA(const AST::Node&);
+    NFA makeRepetition(const AST::Node&);
+
+private:
+    void advance() noexcept;
+    bool checkIsLastStateRepetition(const char) const noexcept;
+
+    std::string_view m_re;
+    uint32_t m_pos = 0u;
+    char m_sym = '\0';
+    bool m_isLastStateRepetition = false;
+    uint32_t m_numGroups = 0u;
+    const uint32_t m_flags;
+    CompileProfile* m_profile = nullptr;
+    std::function<void(CompileProfile::Phase)> m_onPhaseEnd;
+    std::chrono::steady_clock::time_point m_phaseStart;
+
+    bool isUTF8() const { return m_flags & REParser::UTF8; }
+    bool isCaseInsensitive() const { return m_flags & REParser::CASE_INSENSITIVE; }
+    size_t numThreads() const;
+    uint32_t maxChar() const {
+        return isUTF8() ? CharClass::MAX_CODEPOINT : CharClass::MAX_BYTE;
+    }
+
+private:
+    /**
+     * Pop the parsing stack and push the NFA representing a group until:
+     * switch (type)
+     *   GroupStartType::parenthesis:  the last open parenthsis
+     *   GroupStartType::re_start:     the bottom of the stack
+     *   GroupStartType::bar:          the last open parenthsis or the bottom of the stack
+     */
+    AST::NodePtr makeLastGroup(const REParsingStack::GroupStartType);
+
+    void parseBar() {
+        m_stack.push(makeLastGroup(REParsingStack::GroupStartType::bar));
+        m_stack.pushBar(m_pos);
+    }
+    void parseLeftParen() {
+        m_stack.pushOpenParen(m_pos, ++m_numGroups);
+    }
+    void parseRightParen() {
+        const auto group = m_stack.getLastOpenGroup();
+        auto node = makeLastGroup(REParsingStack::GroupStartType::parenthesis);
+        m_stack.push(AST::makeCapture(std::move(node), group));
+    }
+    void parseLeftBrace();
+    uint32_t parseNumRepetitions(const uint32_t);
+    void parseRepetition();
+    AST::NodePtr checkRepetitionAndPopLastNode();
+    void parseEscape() {
+        m_stack.push(makeCharClass(parseEscapeSequence()));
+    }
+    CharClass parseEscapeSequence();
+    uint32_t parseHexEscape(const uint32_t);
+    void parseLeftBracket();
+    CharClass parseBracketItem();
+    void parseDot() {
+        auto anyButNewline = CharClass::range(0u, maxChar());
+        anyButNewline.remove('\n');
+        m_stack.push(makeCharClass(anyButNewline));
+    }
+    void parseSym();
+    uint32_t parseChar();
+
+    /**
+     * Case folding is applied to the class labelling the transition, so a
+     * case-insensitive pattern has exactly the states of the case-sensitive
+     * one, and the byte classes put both cases of a letter together.
+     */
+    CharClass foldCase(const CharClass& charClass) const {
+        return isCaseInsensitive() ? charClass.caseFolded(maxChar()) : charClass;
+    }
+    AST::NodePtr makeCharClass(const CharClass& charClass) const {
+        return AST::makeCharClass(foldCase(charClass));
+    }
+    NFA makeCharClassNFA(const CharClass& charClass) {
+        return isUTF8() ?
+               m_stateManager.makeUTF8Sequences(UTF8::sequencesOf(charClass)) :
+               m_stateManager.makeByteSet(charClass.toByteSet());
+    }
+
+private:
+    StateManager m_stateManager;
+    REParsingStack m_stack;
+};
+
+} // namespace RE
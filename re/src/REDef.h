@@ -1,5 +1,8 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
 #include <set>
 
 namespace RE {
@@ -7,25 +10,57 @@ namespace RE {
 class NFAState;
 
 enum ReservedSymbol {
-    EPS = '\0',
     LEFT_PAREN = '(',
     RIGHT_PAREN = ')',
     LEFT_BRACE = '{',
     RIGHT_BRACE = '}',
+    LEFT_BRACKET = '[',
+    RIGHT_BRACKET = ']',
     BAR = '|',
     KLEENE_STAR = '*',
     PLUS = '+',
     QUESTION = '?',
+    DOT = '.',
+    CARET = '^',
+    DASH = '-',
     ESCAPE = '\\',
     ESCAPE_d = 'd',
     ESCAPE_D = 'D',
+    ESCAPE_w = 'w',
+    ESCAPE_W = 'W',
+    ESCAPE_s = 's',
+    ESCAPE_S = 'S',
     ESCAPE_n = 'n',
     ESCAPE_t = 't',
     ESCAPE_r = 'r',
+    ESCAPE_f = 'f',
+    ESCAPE_v = 'v',
+    ESCAPE_x = 'x',
+    ESCAPE_u = 'u',
 };
 
-using NFAStateSet = std::set<NFAState const*>;
+/**
+ * The structures built and freed while compiling a pattern allocate from
+ * the memory resource of the compilation, see RECompiler
+ */
+using Allocator = std::pmr::polymorphic_allocator<std::byte>;
+
+using NFAStateSet = std::pmr::set<NFAState const*>;
 
 constexpr auto MAX_BRACES_REPETITION = 1024u;
 
+/**
+ * Tags mark the positions of capture group boundaries.
+ * Group k opens with tag 2k and closes with tag 2k+1.
+ */
+constexpr int32_t NO_TAG = -1;
+constexpr int32_t openTag(const uint32_t group) { return 2 * group; }
+constexpr int32_t closeTag(const uint32_t group) { return 2 * group + 1; }
+
+/**
+ * When scanning, the final states tell the rule they accept, the first
+ * rule winning if a state accepts several
+ */
+constexpr uint32_t NO_TOKEN = UINT32_MAX;
+
 } // namespace RE
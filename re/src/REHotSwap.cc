@@ -0,0 +1,105 @@
+#include <REHotSwap.h>
+
+#include <algorithm>
+#include <limits>
+#include <thread>
+
+namespace RE {
+
+/* On a cache line of its own, so that marking it does not slow down the other readers */
+struct alignas(64) REHotSwap::Slot {
+    std::atomic<uint64_t> epoch{0u};
+};
+
+namespace {
+
+/* The slot from which a thread looks for a free one, so that each thread usually finds its own */
+size_t slotHint() {
+    static std::atomic<size_t> nextHint{0u};
+    thread_local const size_t hint = nextHint.fetch_add(1u, std::memory_order_relaxed);
+    return hint;
+}
+
+} // namespace
+
+REHotSwap::Snapshot::Snapshot(Snapshot&& other) noexcept :
+    m_slot(std::exchange(other.m_slot, nullptr)), m_parser(other.m_parser)
+{}
+
+REHotSwap::Snapshot::~Snapshot() {
+    if (m_slot != nullptr) {
+        m_slot->epoch.store(0u, std::memory_order_release);
+    }
+}
+
+REHotSwap::REHotSwap(std::unique_ptr<REParser> parser, const size_t numSlots) :
+    m_numSlots(numSlots != 0u ? numSlots : 4u * std::max(std::thread::hardware_concurrency(), 1u)),
+    m_slots(std::make_unique<Slot[]>(m_numSlots)),
+    m_current(parser.get()),
+    m_owned(std::move(parser))
+{}
+
+REHotSwap::~REHotSwap() = default;
+
+/**
+ * The slot is marked with an epoch read before the parser is loaded, so a
+ * parser is only replaced after the epoch it was loaded in, or in a later
+ * one if the epoch advanced in between, which only delays its deletion.
+ * The mark and the load are sequentially consistent, as are the swap and
+ * the scan of the slots by publish: either the scan sees the mark, or the
+ * load comes after the swap and sees the new parser.
+ */
+REHotSwap::Snapshot REHotSwap::snapshot() const {
+    for (auto i = slotHint();; i++) {
+        auto& slot = m_slots[i % m_numSlots];
+        if (slot.epoch.load(std::memory_order_relaxed) == 0u) {
+            uint64_t free = 0u;
+            if (slot.epoch.compare_exchange_strong(free, m_epoch.load())) {
+                return Snapshot(&slot, m_current.load());
+            }
+        }
+        if ((i + 1u) % m_numSlots == slotHint() % m_numSlots) {
+            std::this_thread::yield();  // every slot is held
+        }
+    }
+}
+
+bool REHotSwap::matchExact(REParser::Str_t str) const {
+    return snapshot()->matchExact(str);
+}
+
+int32_t REHotSwap::find(REParser::Str_t str, std::string_view& match) const {
+    return snapshot()->find(str, match);
+}
+
+void REHotSwap::publish(std::unique_ptr<REParser> parser) {
+    const std::lock_guard<std::mutex> lock(m_writerMutex);
+    m_current.store(parser.get());
+    m_retired.emplace_back(std::exchange(m_owned, std::move(parser)), m_epoch.fetch_add(1u));
+    reclaimRetired();
+}
+
+size_t REHotSwap::reclaim() {
+    const std::lock_guard<std::mutex> lock(m_writerMutex);
+    return reclaimRetired();
+}
+
+/* A parser replaced in an epoch before the oldest marked on a slot cannot be held */
+size_t REHotSwap::reclaimRetired() {
+    if (m_retired.empty()) {
+        return 0u;
+    }
+    auto oldest = std::numeric_limits<uint64_t>::max();
+    for (size_t i = 0u; i < m_numSlots; i++) {
+        const auto epoch = m_slots[i].epoch.load();
+        if (epoch != 0u) {
+            oldest = std::min(oldest, epoch);
+        }
+    }
+    m_retired.erase(std::remove_if(m_retired.begin(), m_retired.end(), [oldest](const auto& retired) {
+        return retired.second < oldest;
+    }), m_retired.end());
+    return m_retired.size();
+}
+
+} // namespace RE
@@ -0,0 +1,43 @@
+#include "REParserImpl.h"
+
+#include <RELexer.h>
+
+namespace RE {
+
+RELexer::RELexer(const std::vector<std::string_view>& rules, const uint32_t flags) :
+    m_lexer(new REParserImpl(rules, flags)) {}
+
+RELexer::RELexer(const std::vector<std::string_view>& rules, const uint32_t flags,
+                 std::pmr::memory_resource* compileResource) :
+    m_lexer(new REParserImpl(rules, flags, compileResource)) {}
+
+RELexer::~RELexer() = default;
+
+bool RELexer::next(REParser::Str_t str, size_t& pos, Token& token) const {
+    return m_lexer->nextToken(str, pos, token);
+}
+
+RELexer::TokenRange RELexer::tokenize(REParser::Str_t str) const {
+    return TokenRange(this, str);
+}
+
+size_t RELexer::tableSize() const {
+    return m_lexer->tableSize();
+}
+
+void RELexer::optimizeLayout(const std::vector<std::string_view>& corpus) {
+    m_lexer->optimizeLayout(corpus);
+}
+
+size_t RELexer::memoryUsage() const {
+    return sizeof(*this) + m_lexer->memoryUsage();
+}
+
+RELexer::TokenIterator& RELexer::TokenIterator::operator++() {
+    if (not m_lexer->next(m_str, m_next, m_token)) {
+        *this = TokenIterator();
+    }
+    return *this;
+}
+
+} // namespace RE
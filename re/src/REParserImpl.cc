@@ -1,212 +1,136 @@
-#include "DFAMinimizer.h"
+#include "RECompiler.h"
 #include "REParserImpl.h"
-#include "REParsingStack.h"
 
 #include <REExceptions.h>
 
 namespace RE {
 
-REParserImpl::REParserImpl(REParser::RE_t re) :
-    m_re(re),
-    m_pos(0),
-    m_sym(re[0]),
-    m_isLastStateRepetition(false)
+/**
+ * The DFA needs no tags, so it is built without the capture groups, which
+ * lets the simplification reach inside them. The compiler and all the
+ * states of the construction are freed once the matchers are built.
+ */
+REParserImpl::REParserImpl(REParser::RE_t re, const uint32_t flags, std::pmr::memory_resource* compileResource) :
+    m_flags(flags)
 {
-    NFAState* nfa = NFAFromRe(re);
-    DFAStateFromNFA* dfa = m_stateManager.DFAFromNFA(nfa);
-    m_dfa = DFAMinimizer(m_stateManager).minimize();
-}
-
-NFAState* REParserImpl::NFAFromRe(REParser::RE_t re) {
-    for (char lastSym = 0;
-         m_pos < m_re.size();
-         m_isLastStateRepetition = checkIsLastStateRepetition(lastSym), advance(), lastSym = m_sym)
-    {
-        switch (m_sym) {
-        case EPS:
-            assert(false and "Unexpected end of regex");
-        case BAR:
-            parseBar();
-            break;
-        case LEFT_PAREN:
-            parseLeftParen();
-            break;
-        case RIGHT_PAREN:
-            parseRightParen();
-            break;
-        case LEFT_BRACE:
-            parseLeftBrace();
-            break;
-        case RIGHT_BRACE:
-            throw UnbalancedBraceException(m_pos);
-        case KLEENE_STAR:
-        case PLUS:
-        case QUESTION:
-            parseRepetition();
-            break;
-        case ESCAPE:
-            parseEscape();
-            break;
-        default:
-            parseSym();
+    RECompiler compiler(flags, compileResource);
+    auto ast = compiler.parse(re);
+    m_numGroups = compiler.numGroups();
+    auto untaggedAST = m_numGroups > 0 ? AST::clone(*ast) : std::move(ast);
+    m_dfa = compiler.makeDFA(untaggedAST);
+    m_searchPlan = std::make_unique<SearchPlan>(m_dfa);
+    if (m_numGroups > 0) {
+        m_taggedNFA = compiler.makeTaggedNFA(ast);
+        m_onePassDFA = std::make_unique<OnePassDFA>(*m_taggedNFA);
+        // only one of them is ever used by matchExact
+        if (m_onePassDFA->isOnePass()) {
+            m_taggedNFA.reset();
+        }
+        else {
+            m_onePassDFA.reset();
         }
     }
-    NFA nfa = makeLastGroup(REParsingStack::GroupStartType::re_start);
-    return nfa.isEmpty() ?
-           m_stateManager.makeNFAState(true) :
-           nfa.startState;
+    m_dfa.freeze();
 }
 
-void REParserImpl::advance() noexcept {
-    m_pos++;
-    m_sym = m_re[m_pos];
+REParserImpl::REParserImpl(const std::vector<std::string_view>& rules, const uint32_t flags,
+                           std::pmr::memory_resource* compileResource) :
+    m_flags(flags)
+{
+    m_dfa = RECompiler(flags, compileResource).makeScannerDFA(rules);
+    m_dfa.freeze();
 }
 
-bool REParserImpl::checkIsLastStateRepetition(const char lastSym) const noexcept {
-    switch (lastSym) {
-        case KLEENE_STAR:
-        case PLUS:
-        case QUESTION:
-        case LEFT_BRACE:
-            return true;
-        default:
-            return false;
-    }
+REParserImpl::REParserImpl(DFA dfa, const uint32_t flags) :
+    m_flags(flags),
+    m_dfa(std::move(dfa))
+{
+    m_searchPlan = std::make_unique<SearchPlan>(m_dfa);
+    m_dfa.freeze();
 }
 
-NFA REParserImpl::makeLastGroup(const REParsingStack::GroupStartType type) {
-    while (true) {
-        const auto lastGroupStartType = m_stack.getLastGroupStart().type;
-        const auto lastGroupStartPosInRe = m_stack.getLastGroupStart().posInRe;
-        auto nfas = m_stack.popTillLastGroupStart(type);
-        switch (lastGroupStartType) {
-        case REParsingStack::GroupStartType::parenthesis:
-            switch (type) {
-                case REParsingStack::GroupStartType::re_start:
-                    throw MissingParenthsisException(lastGroupStartPosInRe);
-                case REParsingStack::GroupStartType::bar:
-                case REParsingStack::GroupStartType::parenthesis:
-                    return m_stateManager.concatenateNFAs(nfas);
-            }
-        case REParsingStack::GroupStartType::re_start:
-            switch (type) {
-                case REParsingStack::GroupStartType::parenthesis:
-                    throw UnbalancedParenthesisException(m_pos);
-                case REParsingStack::GroupStartType::bar:
-                case REParsingStack::GroupStartType::re_start:
-                    return m_stateManager.concatenateNFAs(nfas);
-            }
-        case REParsingStack::GroupStartType::bar: {
-            NFA nfaAfterBar = m_stateManager.concatenateNFAs(nfas);
-            NFA nfaBeforeBar = m_stack.popOne();
-            m_stack.push(
-                m_stateManager.makeAlternation(nfaBeforeBar, nfaAfterBar));
-            break;
-        }
-        }
-    }
+std::unique_ptr<REParserImpl> REParserImpl::combine(const REParserImpl& a, const REParserImpl& b,
+                                                    const DFAProduct::Operation operation) {
+    return std::make_unique<REParserImpl>(
+        DFAProduct::combine(a.m_dfa.thawedCopy(), b.m_dfa.thawedCopy(), operation), a.m_flags);
 }
 
-void REParserImpl::parseLeftBrace() {
-    const auto braceStart = m_pos;
-    NFA lastNfa = checkRepetitionAndPopLastNfa();
-    const auto numRepetitions = parseNumRepetitions(braceStart);
-    switch (numRepetitions) {
-        case 0: break;
-        case 1:
-            m_stack.push(lastNfa);
-            break;
-        default: {
-            for (auto count = 0; count < numRepetitions; count++) {
-                m_stack.push(m_stateManager.makeCopy(lastNfa));
-            }
-        }
+std::unique_ptr<REParserImpl> REParserImpl::complement(const REParserImpl& parser) {
+    return std::make_unique<REParserImpl>(DFAProduct::complement(parser.m_dfa.thawedCopy()), parser.m_flags);
+}
+
+/* The search plan refers to states of the DFA, so it is made again */
+void REParserImpl::optimizeLayout(const std::vector<std::string_view>& corpus) {
+    m_dfa.optimizeLayout(corpus);
+    if (m_searchPlan) {
+        m_searchPlan = std::make_unique<SearchPlan>(m_dfa);
     }
+    m_dfa.freeze();
 }
 
-uint32_t REParserImpl::parseNumRepetitions(const uint32_t braceStart) {
-    auto numRepetitions = 0u;
-    for (advance();  // start from the next symbol after '{'
-         m_sym != RIGHT_BRACE;
-         advance())
-    {
-        if (m_pos == m_re.size()) {
-            throw MissingBraceException(braceStart);
-        }
-        if (m_sym < '0' or m_sym > '9') {
-            throw NondigitInBracesException(m_sym, m_pos);
-        }
-        numRepetitions = numRepetitions * 10 + (m_sym - '0');
-        if (numRepetitions > MAX_BRACES_REPETITION) {
-            throw TooLargeRepetitionNumberException();
-        }
+/**
+ * The captures of the alternative are erased by makeDFA. The DFA is not
+ * frozen again, so that the next alternative is added to its dense table
+ * rather than to one rebuilt from the compressed table.
+ */
+void REParserImpl::addAlternative(REParser::RE_t re) {
+    if (m_numGroups > 0u) {
+        throw AlternativeToGroupsException();
     }
-    if (braceStart + 1 == m_pos) {
-        throw EmptyBracesException(braceStart);
+    RECompiler compiler(m_flags);
+    auto ast = compiler.parse(re);
+    DFAProduct::addUnion(m_dfa, compiler.makeDFA(ast));
+    if (m_searchPlan) {
+        m_searchPlan = std::make_unique<SearchPlan>(m_dfa);
     }
-    return numRepetitions;
 }
 
-void REParserImpl::parseRepetition() {
-    NFA lastNfa = checkRepetitionAndPopLastNfa();
-    switch (m_sym) {
-        case KLEENE_STAR:
-            m_stack.push(m_stateManager.makeKleeneClousure(lastNfa));
-            break;
-        case PLUS:
-            m_stack.push(m_stateManager.makePlus(lastNfa));
-            break;
-        case QUESTION:
-            m_stack.push(m_stateManager.makeQuestion(lastNfa));
-            break;
-        default:
-            assert(false and "Unexpected repeat symbol");
+bool REParserImpl::matchExact(const std::string_view& str, REParser::Groups_t& groups) const {
+    if (m_onePassDFA and m_onePassDFA->isOnePass()) {
+        return m_onePassDFA->match(str, groups);
     }
+    if (not m_dfa.accept(str)) {
+        return false;
+    }
+    if (m_taggedNFA) {
+        return m_taggedNFA->match(str, groups);
+    }
+    groups.assign(1u, str);
+    return true;
 }
 
-NFA REParserImpl::checkRepetitionAndPopLastNfa() {
-    if (m_stack.getLastGroupStart().posInRe == m_pos - 1) {
-        throw NothingToRepeatException(m_pos);
-    }
-    if (m_isLastStateRepetition) {
-        throw MultipleRepeatException(m_pos);
+int32_t REParserImpl::find(const std::string_view& str, std::string_view& match) const {
+    size_t start, end;
+    if (not find(str, 0u, start, end)) {
+        return -1;
     }
-    return m_stack.popOne();
+    match = str.substr(start, end - start);
+    return start;
 }
 
-void REParserImpl::parseEscape() {
-    advance();  // check the next symbol after '\'
-    if (m_pos == m_re.size()) {
-        throw EscapeException("Escape reaches the end of the input");
+/**
+ * Maximal munch: the longest token wins, then the first rule matching it.
+ * The empty string is no token, so that the scan always moves forward.
+ */
+bool REParserImpl::nextToken(const std::string_view& str, size_t& pos, RELexer::Token& token) const {
+    if (pos >= str.size()) {
+        return false;
     }
-    switch (m_sym) {
-        case BAR:
-        case LEFT_PAREN:
-        case RIGHT_PAREN:
-        case LEFT_BRACE:
-        case RIGHT_BRACE:
-        case KLEENE_STAR:
-        case PLUS:
-        case QUESTION:
-        case ESCAPE:
-            m_stack.push(m_stateManager.makeSymbol(m_sym));
-            break;
-        case ESCAPE_n:
-            m_stack.push(m_stateManager.makeSymbol('\n'));
-            break;
-        case ESCAPE_t:
-            m_stack.push(m_stateManager.makeSymbol('\t'));
-            break;
-        case ESCAPE_r:
-            m_stack.push(m_stateManager.makeSymbol('\r'));
-            break;
-        case ESCAPE_d:
-        case ESCAPE_D:
-            m_stack.push(m_stateManager.makeDigit());
-            break;
-        default:
-            throw EscapeException(m_sym, m_pos);
+    auto end = m_dfa.longestToken(str, pos, token.id);
+    if (end == DFA::NO_MATCH or end == pos) {
+        end = pos + 1u;
+        token.id = RELexer::UNKNOWN;
     }
+    token.text = str.substr(pos, end - pos);
+    pos = end;
+    return true;
+}
+
+size_t REParserImpl::memoryUsage() const {
+    return sizeof(*this) + m_dfa.memoryUsage() - sizeof(m_dfa) +
+           (m_taggedNFA ? m_taggedNFA->memoryUsage() : 0u) +
+           (m_onePassDFA ? m_onePassDFA->memoryUsage() : 0u) +
+           (m_searchPlan ? m_searchPlan->memoryUsage() : 0u);
 }
 
 } // namespace RE
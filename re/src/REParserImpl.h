@@ -1,66 +1,71 @@
 #pragma once
 
+#include "DFAProduct.h"
 #include "FA.h"
-#include "REParsingStack.h"
-#include "StateManager.h"
+#include "OnePassDFA.h"
+#include "SearchPlan.h"
+#include "TaggedNFA.h"
 
 #include <RE.h>
+#include <RELexer.h>
 
+#include <memory>
+#include <memory_resource>
 #include <string_view>
+#include <vector>
 
 namespace RE {
 
+/**
+ * The matchers of a compiled pattern, built by an RECompiler which is
+ * gone by the time the constructor returns
+ */
 class REParserImpl {
 public:
-    REParserImpl(REParser::RE_t re);
+    REParserImpl(REParser::RE_t re, const uint32_t flags,
+                 std::pmr::memory_resource* compileResource = std::pmr::get_default_resource());
+    /* The scanner of the rules, see RELexer */
+    REParserImpl(const std::vector<std::string_view>& rules, const uint32_t flags,
+                 std::pmr::memory_resource* compileResource = std::pmr::get_default_resource());
+    /* The matchers of a minimized DFA, e.g. a combination of patterns */
+    REParserImpl(DFA dfa, const uint32_t flags);
+
+    static std::unique_ptr<REParserImpl> combine(const REParserImpl&, const REParserImpl&,
+                                                 const DFAProduct::Operation);
+    static std::unique_ptr<REParserImpl> complement(const REParserImpl&);
+    /* The minimized DFA of an empty language is the dead state alone */
+    bool isEmpty() const { return m_dfa.start() == DFA::DEAD; }
+    bool isSubsetOf(const REParserImpl& other) const {
+        return DFAProduct::isSubset(m_dfa.thawedCopy(), other.m_dfa.thawedCopy());
+    }
     bool matchExact(const std::string_view& str) const {
         return m_dfa.accept(str);
     }
-
-private:
-    NFAState* NFAFromRe(REParser::RE_t);
-
-private:
-    void advance() noexcept;
-    bool checkIsLastStateRepetition(const char) const noexcept;
-
-    REParser::RE_t m_re;
-    uint32_t m_pos;
-    char m_sym;
-    bool m_isLastStateRepetition;
-
-private:
-    /**
-     * Pop the parsing stack and push the NFA representing a group until:
-     * switch (type)
-     *   GroupStartType::parenthesis:  the last open parenthsis
-     *   GroupStartType::re_start:     the bottom of the stack
-     *   GroupStartType::bar:          the last open parenthsis or the bottom of the stack
-     */
-    NFA makeLastGroup(const REParsingStack::GroupStartType);
-
-    void parseBar() {
-        m_stack.push(makeLastGroup(REParsingStack::GroupStartType::bar));
-        m_stack.pushBar(m_pos);
+    bool matchExact(const std::string_view&, REParser::Groups_t&) const;
+    size_t numGroups() const { return m_numGroups; }
+    size_t tableSize() const {
+        return m_dfa.tableSize() + (m_searchPlan ? m_searchPlan->tableSize() : 0u);
     }
-    void parseLeftParen() {
-        m_stack.pushOpenParen(m_pos);
+    int32_t find(const std::string_view&, std::string_view&) const;
+    bool find(const std::string_view& str, const size_t from, size_t& start, size_t& end) const {
+        return m_searchPlan->find(str, from, start, end);
     }
-    void parseRightParen() {
-        m_stack.push(
-            makeLastGroup(REParsingStack::GroupStartType::parenthesis));
-    }
-    void parseLeftBrace();
-    uint32_t parseNumRepetitions(const uint32_t);
-    void parseRepetition();
-    NFA checkRepetitionAndPopLastNfa();
-    void parseEscape();
-    void parseSym() { m_stack.push(m_stateManager.makeSymbol(m_sym)); }
+    bool nextToken(const std::string_view&, size_t& pos, RELexer::Token&) const;
+    void optimizeLayout(const std::vector<std::string_view>& corpus);
+    void addAlternative(REParser::RE_t);
+    size_t memoryUsage() const;
 
 private:
-    StateManager m_stateManager;
-    REParsingStack m_stack;
+    uint32_t m_flags = REParser::NONE;  // the alternatives added are compiled with
+    uint32_t m_numGroups = 0u;
     DFA m_dfa;
+    /**
+     * Only built for patterns with capture groups, and not for scanners;
+     * one of the two is kept, the one-pass DFA if the pattern is one-pass
+     */
+    std::unique_ptr<TaggedNFA> m_taggedNFA;
+    std::unique_ptr<OnePassDFA> m_onePassDFA;
+    std::unique_ptr<SearchPlan> m_searchPlan;
 };
 
 } // namespace RE
@@ -2,24 +2,35 @@
 
 #include <REExceptions.h>
 
+#include <iterator>
+
 namespace RE {
 
-NFA REParsingStack::popOne() {
-    const auto ret = m_stack.back();
+uint32_t REParsingStack::getLastOpenGroup() const {
+    for (auto it = m_groupStarts.rbegin(); it != m_groupStarts.rend(); ++it) {
+        if (it->type == GroupStartType::parenthesis) {
+            return it->group;
+        }
+    }
+    return 0u;
+}
+
+AST::NodePtr REParsingStack::popOne() {
+    auto ret = std::move(m_stack.back());
     m_stack.pop_back();
     return ret;
 }
 
-REParsingStack::Stack_t REParsingStack::popTillLastGroupStart(
+std::vector<AST::NodePtr> REParsingStack::popTillLastGroupStart(
     const GroupStartType type) {
     // Pop last group start
     const auto lastGroupStartPosInStack = getLastGroupStart().posInStack;
     if (hasHigherOrEqualPredecence(type, getLastGroupStart().type)) {
         m_groupStarts.pop_back();
     }
-    // Pop nfas till last group start
-    const auto ret =
-        Stack_t(m_stack.begin() + lastGroupStartPosInStack, m_stack.end());
+    // Pop nodes till last group start
+    auto ret = std::vector<AST::NodePtr>(std::make_move_iterator(m_stack.begin() + lastGroupStartPosInStack),
+                       std::make_move_iterator(m_stack.end()));
     m_stack.resize(lastGroupStartPosInStack);
 
     return ret;
@@ -1,15 +1,25 @@
 #pragma once
 
-#include "FA.h"
+#include "AST.h"
+#include "REDef.h"
 
+#include <memory_resource>
 #include <vector>
 
 namespace RE {
 
 class REParsingStack {
-    friend class REParserImpl;
+    friend class RECompiler;
 
-    using Stack_t = std::vector<NFA>;
+    using Stack_t = std::pmr::vector<AST::NodePtr>;
+
+public:
+    explicit REParsingStack(const Allocator& allocator = {}) :
+        m_stack(allocator),
+        m_groupStarts(allocator)
+    {
+        clear();
+    }
 
 private:
     enum class GroupStartType {
@@ -29,6 +39,7 @@ private:
         const size_t posInStack;
         const int32_t posInRe;
         GroupStartType type;
+        uint32_t group = 0u;  // capture group index of an open parenthesis
     };
 
     const GroupStart& getLastGroupStart() const {
@@ -36,22 +47,34 @@ private:
     }
 
     bool isEmpty() const { return m_stack.empty(); }
-    void push(const NFA& nfa) { m_stack.push_back(nfa); }
+    /* Back to the start of a pattern */
+    void clear() {
+        m_stack.clear();
+        m_groupStarts.clear();
+        m_groupStarts.push_back({0u, -1, GroupStartType::re_start});
+    }
+    void push(AST::NodePtr node) { m_stack.push_back(std::move(node)); }
 
-    void pushOpenParen(const int32_t posInRe) {
-        m_groupStarts.push_back({m_stack.size(), posInRe, GroupStartType::parenthesis});
+    void pushOpenParen(const int32_t posInRe, const uint32_t group) {
+        m_groupStarts.push_back({m_stack.size(), posInRe, GroupStartType::parenthesis, group});
     }
 
     void pushBar(const int32_t posInRe) {
         m_groupStarts.push_back({m_stack.size(), posInRe, GroupStartType::bar});
     }
 
-    NFA popOne();
-    Stack_t popTillLastGroupStart(const GroupStartType);
+    /**
+     * Capture group of the innermost open parenthesis, 0 if there is none
+     */
+    uint32_t getLastOpenGroup() const;
+
+    AST::NodePtr popOne();
+    /* The nodes of the group, which become the children of a node */
+    std::vector<AST::NodePtr> popTillLastGroupStart(const GroupStartType);
 
 private:
     Stack_t m_stack;
-    std::vector<GroupStart> m_groupStarts{{0u, -1, GroupStartType::re_start}};
+    std::pmr::vector<GroupStart> m_groupStarts;
 };
 
 } // namespace RE
@@ -0,0 +1,280 @@
+#include "DFAMinimizer.h"
+#include "SearchPlan.h"
+#include "StateManager.h"
+
+#include <algorithm>
+#include <queue>
+
+namespace RE {
+
+SearchPlan::SearchPlan(const DFA& dfa) :
+    m_dfa(dfa)
+{
+    if (m_dfa.start() == DFA::DEAD) {
+        return;
+    }
+    m_matchesEmpty = m_dfa.isFinal(m_dfa.start());
+    const auto& byteClasses = m_dfa.byteClasses();
+    for (size_t cls = 0u; cls < byteClasses.numClasses(); cls++) {
+        if (m_dfa.nextByClass(m_dfa.start(), cls) != DFA::DEAD) {
+            m_firstBytes.add(byteClasses.bytesOf(cls));
+        }
+    }
+    if (m_dfa.numStates() > MAX_NUM_STATES) {
+        return;
+    }
+    findLiteral();
+    if (m_strategy == Strategy::reverse_suffix or m_strategy == Strategy::reverse_inner) {
+        buildReverseDFA();
+    }
+}
+
+/**
+ * Every state of a minimized DFA but the dead one is on the way from the
+ * start to a final state. The states all the matches go through are those
+ * whose removal disconnects the start from the final states; the literal is
+ * the longest chain of them where each one is entered from the previous
+ * one only, by a single byte.
+ */
+void SearchPlan::findLiteral() {
+    const auto numStates = static_cast<DFA::StateId>(m_dfa.numStates());
+    const auto& byteClasses = m_dfa.byteClasses();
+    const auto start = m_dfa.start();
+
+    std::vector<std::vector<DFA::StateId>> successors(numStates);
+    for (DFA::StateId state = DFA::DEAD + 1; state < numStates; state++) {
+        for (size_t cls = 0u; cls < byteClasses.numClasses(); cls++) {
+            const auto to = m_dfa.nextByClass(state, cls);
+            auto& stateSuccessors = successors[state];
+            if (to != DFA::DEAD and
+                std::find(stateSuccessors.begin(), stateSuccessors.end(), to) == stateSuccessors.end())
+            {
+                stateSuccessors.push_back(to);
+            }
+        }
+    }
+
+    /* breadth-first distances from the start, -1 for the unreached states */
+    const auto distancesWithout = [&](const DFA::StateId removed) {
+        std::vector<int32_t> distances(numStates, -1);
+        std::queue<DFA::StateId> toVisit;
+        distances[start] = 0;
+        toVisit.push(start);
+        while (not toVisit.empty()) {
+            const auto state = toVisit.front();
+            toVisit.pop();
+            for (const auto to : successors[state]) {
+                if (to != removed and distances[to] < 0) {
+                    distances[to] = distances[state] + 1;
+                    toVisit.push(to);
+                }
+            }
+        }
+        return distances;
+    };
+    const auto distances = distancesWithout(DFA::DEAD);
+    std::vector<DFA::StateId> dominators{start};
+    /* the states reached without the state, i.e. before it */
+    std::vector<std::vector<int32_t>> before(numStates);
+    for (DFA::StateId state = DFA::DEAD + 1; state < numStates; state++) {
+        if (state == start) {
+            continue;
+        }
+        before[state] = distancesWithout(state);
+        bool reachesFinal = false;
+        for (DFA::StateId finalState = DFA::DEAD + 1; finalState < numStates; finalState++) {
+            reachesFinal |= m_dfa.isFinal(finalState) and before[state][finalState] >= 0;
+        }
+        if (not reachesFinal) {
+            dominators.push_back(state);
+        }
+    }
+    std::sort(dominators.begin(), dominators.end(),
+              [&distances](const DFA::StateId a, const DFA::StateId b) {
+                  return distances[a] < distances[b];
+              });
+
+    /**
+     * The transition by which each state is first entered, if it reads a
+     * single byte. Transitions from the states behind it only reenter it,
+     * unless it is inside the literal, where they would break the literal.
+     */
+    struct Entry {
+        DFA::StateId from = DFA::DEAD;
+        int32_t cls = -1;
+        bool isSingleByte = true;
+        bool isOnlyEntry = true;
+    };
+    std::vector<Entry> entries(numStates);
+    bool isStartEntered = false;
+    for (DFA::StateId state = DFA::DEAD + 1; state < numStates; state++) {
+        for (size_t cls = 0u; cls < byteClasses.numClasses(); cls++) {
+            const auto to = m_dfa.nextByClass(state, cls);
+            if (to == DFA::DEAD) {
+                continue;
+            }
+            isStartEntered |= to == start;
+            auto& entry = entries[to];
+            const bool isReentry = to != start and before[to][state] < 0;
+            if (isReentry) {
+                entry.isOnlyEntry = false;
+            }
+            else if (entry.cls < 0) {
+                entry.from = state;
+                entry.cls = cls;
+                entry.isSingleByte = byteClasses.bytesOf(cls).count() == 1u;
+            }
+            else {
+                entry.isSingleByte = false;
+                entry.isOnlyEntry = false;
+            }
+        }
+    }
+
+    std::string literal;
+    DFA::StateId literalStart = start;
+    DFA::StateId literalEnd = start;
+    for (auto it = std::next(dominators.begin()); it != dominators.end(); it++) {
+        const auto& entry = entries[*it];
+        if (not entry.isSingleByte) {
+            literal.clear();
+            continue;
+        }
+        if (literal.empty() or entry.from != literalEnd or not entries[literalEnd].isOnlyEntry) {
+            literal.clear();
+            literalStart = entry.from;
+        }
+        literal.push_back(static_cast<char>(byteClasses.representative(entry.cls)));
+        literalEnd = *it;
+        if (literal.size() > m_literal.size()) {
+            m_literal = literal;
+            m_literalStart = literalStart;
+            m_literalEnd = literalEnd;
+        }
+    }
+
+    if (m_literal.empty()) {
+        return;
+    }
+    if (m_literalStart == start and not isStartEntered) {
+        m_strategy = Strategy::prefix;
+    }
+    else if (not isLiteralOnlyInChain()) {
+        m_literal.clear();
+    }
+    else if (m_dfa.isFinal(m_literalEnd) and successors[m_literalEnd].empty()) {
+        m_strategy = Strategy::reverse_suffix;
+    }
+    else {
+        m_strategy = Strategy::reverse_inner;
+    }
+}
+
+/**
+ * The first occurrence of the literal followed by a match gives the leftmost
+ * match only if no match can read the literal elsewhere than in the chain:
+ * a match starting earlier and ending at a later occurrence would otherwise
+ * be missed.
+ */
+bool SearchPlan::isLiteralOnlyInChain() const {
+    const auto numStates = static_cast<DFA::StateId>(m_dfa.numStates());
+    for (DFA::StateId state = DFA::DEAD + 1; state < numStates; state++) {
+        if (state == m_literalStart) {
+            continue;
+        }
+        auto to = state;
+        for (const auto c : m_literal) {
+            to = m_dfa.next(to, c);
+            if (to == DFA::DEAD) {
+                break;
+            }
+        }
+        if (to != DFA::DEAD) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void SearchPlan::buildReverseDFA() {
+    std::vector<bool> finals(m_dfa.numStates(), false);
+    finals[m_literalStart] = true;
+    StateManager stateManager;
+    const auto nfa = stateManager.makeFromDFA(m_dfa, finals, true);
+    stateManager.DFAFromNFA(nfa.startState);
+    m_reverseDFA = DFAMinimizer(stateManager).minimize();
+    m_reverseDFA.freeze();
+}
+
+bool SearchPlan::find(std::string_view str, const size_t from, size_t& start, size_t& end) const {
+    if (m_dfa.start() == DFA::DEAD or from > str.size()) {
+        return false;
+    }
+    switch (m_strategy) {
+    case Strategy::prefix:
+        return findPrefix(str, from, start, end);
+    case Strategy::reverse_suffix:
+    case Strategy::reverse_inner:
+        return findReverse(str, from, start, end);
+    default:
+        return findDFA(str, from, start, end);
+    }
+}
+
+bool SearchPlan::findPrefix(std::string_view str, const size_t from, size_t& start, size_t& end) const {
+    for (auto hit = str.find(m_literal, from);
+         hit != std::string_view::npos;
+         hit = str.find(m_literal, start))
+    {
+        end = m_dfa.leftmostLongest(str, hit, start);
+        if (end != DFA::NO_MATCH) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * A match reads the literal in the chain only, so none starts at or before
+ * an occurrence which gave no match, and the reversed DFA does not read
+ * backwards past it again: each byte is read backwards once.
+ */
+bool SearchPlan::findReverse(std::string_view str, const size_t from, size_t& start, size_t& end) const {
+    auto min = from;
+    for (auto hit = str.find(m_literal, from);
+         hit != std::string_view::npos;
+         min = hit + 1, hit = str.find(m_literal, hit + 1))
+    {
+        start = m_reverseDFA.longestMatchBackwards(str, hit, min);
+        if (start == DFA::NO_MATCH) {
+            continue;
+        }
+        end = m_strategy == Strategy::reverse_suffix ?
+              hit + m_literal.size() :
+              m_dfa.longestMatch(str, hit + m_literal.size(), m_literalEnd);
+        if (end != DFA::NO_MATCH) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool SearchPlan::findDFA(std::string_view str, const size_t from, size_t& start, size_t& end) const {
+    for (auto pos = from; pos <= str.size(); pos = start) {
+        if (not m_matchesEmpty) {
+            while (pos < str.size() and not m_firstBytes.contains(str[pos])) {
+                pos++;
+            }
+            if (pos == str.size()) {
+                return false;
+            }
+        }
+        end = m_dfa.leftmostLongest(str, pos, start);
+        if (end != DFA::NO_MATCH) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace RE
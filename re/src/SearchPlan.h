@@ -0,0 +1,72 @@
+#pragma once
+
+#include "ByteSet.h"
+#include "FA.h"
+
+#include <RE.h>
+
+#include <string>
+#include <vector>
+
+namespace RE {
+
+/**
+ * How REParser::find looks for the leftmost-longest match, chosen from the
+ * literal required by every match, read off the minimized DFA as a chain of
+ * single-byte transitions between the states all the matches go through.
+ *
+ *   prefix:         the literal starts every match; the DFA is run from an
+ *                   occurrence as with dfa below, and the literal is looked
+ *                   for again where it stops
+ *   reverse_suffix: the literal ends every match, e.g. \w+\.log; the start
+ *                   is found by a reversed DFA running backwards from an
+ *                   occurrence
+ *   reverse_inner:  the literal is inside every match, e.g. \d+ ms \w+; as
+ *                   above, then the DFA runs forwards from the occurrence
+ *   dfa:            no usable literal; the runs of the DFA from the positions
+ *                   starting with a byte that can begin a match are read
+ *                   together, until they all die
+ */
+class SearchPlan {
+public:
+    enum class Strategy { prefix, reverse_suffix, reverse_inner, dfa };
+
+    SearchPlan(const DFA&);
+
+    Strategy strategy() const { return m_strategy; }
+    const std::string& literal() const { return m_literal; }
+    bool find(std::string_view, const size_t from, size_t& start, size_t& end) const;
+    /* All the bytes taken by the plan, the reversed DFA included */
+    size_t memoryUsage() const {
+        return sizeof(*this) + m_literal.capacity() + m_reverseDFA.memoryUsage() - sizeof(m_reverseDFA);
+    }
+    /* The bytes taken by the table of the reversed DFA, if any */
+    size_t tableSize() const {
+        return m_strategy == Strategy::reverse_suffix or m_strategy == Strategy::reverse_inner ?
+               m_reverseDFA.tableSize() : 0u;
+    }
+
+private:
+    /* The analysis is quadratic in the number of states */
+    static constexpr size_t MAX_NUM_STATES = 512u;
+
+    void findLiteral();
+    bool isLiteralOnlyInChain() const;
+    void buildReverseDFA();
+
+    bool findPrefix(std::string_view, const size_t, size_t&, size_t&) const;
+    bool findReverse(std::string_view, const size_t, size_t&, size_t&) const;
+    bool findDFA(std::string_view, const size_t, size_t&, size_t&) const;
+
+    const DFA& m_dfa;
+    Strategy m_strategy = Strategy::dfa;
+    std::string m_literal;
+    DFA::StateId m_literalStart = DFA::DEAD;  // the state reading the literal
+    DFA::StateId m_literalEnd = DFA::DEAD;    // the state after the literal
+    /* reads backwards the strings leading from the start to m_literalStart */
+    DFA m_reverseDFA;
+    ByteSet m_firstBytes;
+    bool m_matchesEmpty = false;  // the DFA is not to be read once frozen
+};
+
+} // namespace RE
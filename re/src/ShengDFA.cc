@@ -0,0 +1,131 @@
+#include "ShengDFA.h"
+
+#include <algorithm>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define RE_HAS_SHENG 1
+#include <immintrin.h>
+#define RE_TARGET_SSSE3 __attribute__((target("ssse3")))
+#else
+#define RE_TARGET_SSSE3
+#endif
+
+namespace RE {
+
+namespace {
+
+/* The input is read by chunks between the checks for the dead state */
+constexpr size_t CHUNK_SIZE = 64u;
+
+} // namespace
+
+bool ShengDFA::isSupported() {
+#if defined(RE_HAS_SHENG)
+    static const bool hasSSSE3 = __builtin_cpu_supports("ssse3");
+    return hasSSSE3;
+#else
+    return false;
+#endif
+}
+
+ShengDFA::ShengDFA(const std::vector<int32_t>& transitions, const ByteClasses& byteClasses,
+                   const std::vector<bool>& finals, const std::vector<uint32_t>& tokens) {
+    const auto numClasses = byteClasses.numClasses();
+    for (size_t state = 0u; state < finals.size(); state++) {
+        for (size_t byte = 0u; byte < 256u; byte++) {
+            m_shuffles[byte][state] = static_cast<uint8_t>(
+                transitions[state * numClasses + byteClasses.classOf(byte)]);
+        }
+        m_finals |= finals[state] ? 1u << state : 0u;
+        m_tokens[state] = tokens[state];
+    }
+}
+
+#if defined(RE_HAS_SHENG)
+
+namespace {
+
+RE_TARGET_SSSE3 __m128i step(const uint8_t (&shuffles)[256][ShengDFA::MAX_NUM_STATES], const char byte,
+                             const __m128i state) {
+    const auto shuffle = _mm_load_si128(reinterpret_cast<const __m128i*>(shuffles[static_cast<uint8_t>(byte)]));
+    return _mm_shuffle_epi8(shuffle, state);
+}
+
+RE_TARGET_SSSE3 ShengDFA::State_t stateOf(const __m128i state) {
+    return static_cast<ShengDFA::State_t>(_mm_cvtsi128_si32(state));
+}
+
+} // namespace
+
+RE_TARGET_SSSE3 bool ShengDFA::accept(std::string_view str, const State_t start) const {
+    auto state = _mm_set1_epi8(static_cast<char>(start));
+    for (size_t pos = 0u; pos < str.size(); ) {
+        const auto chunkEnd = std::min(pos + CHUNK_SIZE, str.size());
+        for (; pos < chunkEnd; pos++) {
+            state = step(m_shuffles, str[pos], state);
+        }
+        if (stateOf(state) == 0u) {
+            return false;
+        }
+    }
+    return isFinal(stateOf(state));
+}
+
+/* The state is read out after each step, off the chain of the shuffles */
+RE_TARGET_SSSE3 size_t ShengDFA::longestMatch(std::string_view str, size_t pos, const State_t start,
+                                              State_t& lastFinal) const {
+    size_t end = NO_MATCH;
+    if (isFinal(start)) {
+        end = pos;
+        lastFinal = start;
+    }
+    auto state = _mm_set1_epi8(static_cast<char>(start));
+    while (pos < str.size()) {
+        state = step(m_shuffles, str[pos++], state);
+        const auto current = stateOf(state);
+        if (current == 0u) {
+            break;
+        }
+        if (isFinal(current)) {
+            end = pos;
+            lastFinal = current;
+        }
+    }
+    return end;
+}
+
+RE_TARGET_SSSE3 size_t ShengDFA::longestMatchBackwards(std::string_view str, size_t pos, const size_t min,
+                                                       const State_t start) const {
+    size_t matchStart = isFinal(start) ? pos : NO_MATCH;
+    auto state = _mm_set1_epi8(static_cast<char>(start));
+    while (pos > min) {
+        state = step(m_shuffles, str[--pos], state);
+        const auto current = stateOf(state);
+        if (current == 0u) {
+            break;
+        }
+        if (isFinal(current)) {
+            matchStart = pos;
+        }
+    }
+    return matchStart;
+}
+
+#else
+
+// never called, as isSupported() is false
+bool ShengDFA::accept(std::string_view, const State_t) const {
+    return false;
+}
+
+size_t ShengDFA::longestMatch(std::string_view, size_t, const State_t, State_t&) const {
+    return NO_MATCH;
+}
+
+size_t ShengDFA::longestMatchBackwards(std::string_view, size_t, const size_t, const State_t) const {
+    return NO_MATCH;
+}
+
+#endif
+
+} // namespace RE
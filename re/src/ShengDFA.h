@@ -0,0 +1,51 @@
+#pragma once
+
+#include "ByteClasses.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace RE {
+
+/**
+ * The matching of a DFA of at most 16 states in SIMD registers (Sheng):
+ * the state is a byte broadcast to a 16-byte vector, and for each input
+ * byte a vector maps every state to its successor, so that a step is a
+ * single pshufb of that vector by the state. The vector of a byte is
+ * loaded from its address alone, thus the only dependency between the
+ * steps is the shuffle, with no load from the state.
+ *
+ * The shuffle needs SSSE3, which is checked at run time as the library is
+ * built for the baseline x86-64; the DFA keeps its table otherwise.
+ */
+class ShengDFA {
+public:
+    using State_t = uint8_t;
+    static constexpr size_t MAX_NUM_STATES = 16u;
+    static constexpr size_t NO_MATCH = std::string_view::npos;
+
+    /* Whether the engine runs on this CPU */
+    static bool isSupported();
+
+    /* From the dense table of the DFA, state 0 being the dead one */
+    ShengDFA(const std::vector<int32_t>& transitions, const ByteClasses&,
+             const std::vector<bool>& finals, const std::vector<uint32_t>& tokens);
+
+    bool accept(std::string_view, const State_t start) const;
+    /* As DFA::longestMatch, lastFinal being the last final state entered */
+    size_t longestMatch(std::string_view, size_t pos, const State_t state, State_t& lastFinal) const;
+    size_t longestMatchBackwards(std::string_view, size_t pos, const size_t min, const State_t start) const;
+    uint32_t token(const State_t state) const { return m_tokens[state]; }
+
+private:
+    bool isFinal(const State_t state) const { return m_finals >> state & 1u; }
+
+    /* by byte and state, the successor */
+    alignas(16) uint8_t m_shuffles[256][MAX_NUM_STATES] = {};
+    uint16_t m_finals = 0u;  // a bit per state
+    uint32_t m_tokens[MAX_NUM_STATES] = {};
+};
+
+} // namespace RE
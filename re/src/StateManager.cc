@@ -4,38 +4,80 @@
 
 #include <REExceptions.h>
 
+#include <algorithm>
 #include <cassert>
+#include <condition_variable>
+#include <thread>
 
 namespace RE {
 
 // NFA
 
-NFA StateManager::concatenateNFAs(std::vector<NFA>& nfas) {
-    // TODO investigate it
-    // NFA emptyNfa;
-    // NFA nfa = std::accumulate(nfas.begin(), nfas.end(), emptyNfa,
-                            //   std::bind(&StateManager::makeConcatenation, this, _1, _2));
-                            //   [this](NFA& a, NFA& b) {
-                            //       return makeConcatenation(a, b);
-                            //   });
-    NFA resultNfa;
-    for (auto& nfa : nfas) {
-        resultNfa = makeConcatenation(resultNfa, nfa);
-    }
-    return { resultNfa.startState, resultNfa.endState };
-}
-
 NFAState* StateManager::makeNFAState(const bool isFinal) {
     m_NFAs.emplace_back(m_NFAs.size(), isFinal);
     assert(m_NFAs.back().m_id == m_NFAs.size() - 1 and "Wrong NFAState id");
     return &(m_NFAs.back());
 }
 
-NFA StateManager::makeSymbol(const char sym) {
+NFAState* StateManager::makeTaggedNFAState(const int32_t tag) {
+    auto state = makeNFAState();
+    state->m_tag = tag;
+    return state;
+}
+
+/* A chain of states reading the bytes one after the other */
+NFA StateManager::makeLiteral(const std::string& bytes) {
+    auto startState = makeNFAState();
+    auto endState = startState;
+    for (const auto byte : bytes) {
+        auto nextState = makeNFAState();
+        endState->addTransition(ByteSet(static_cast<uint8_t>(byte)), nextState);
+        endState = nextState;
+    }
+    endState->m_isFinal = true;
+    return { startState, endState };
+}
+
+NFA StateManager::makeByteSet(const ByteSet& byteSet) {
     auto startState = makeNFAState();
     auto endState = makeNFAState(true);
-    startState->addTransition(sym, endState);
-    m_inputSymbols.insert(sym);
+    startState->addTransition(byteSet, endState);
+    return { startState, endState };
+}
+
+/**
+ * The sequences share their common prefixes as a trie and a single end
+ * state; the remaining common suffixes are merged by the DFA minimization.
+ */
+NFA StateManager::makeUTF8Sequences(const std::vector<UTF8::Sequence>& sequences) {
+    struct TrieEdge {
+        NFAState const* from;
+        ByteSet byteSet;
+        NFAState* to;
+    };
+    std::pmr::vector<TrieEdge> trie(m_allocator);
+
+    auto startState = makeNFAState();
+    auto endState = makeNFAState(true);
+    for (const auto& sequence : sequences) {
+        NFAState* state = startState;
+        for (size_t i = 0u; i + 1 < sequence.size(); i++) {
+            const auto& byteSet = sequence[i];
+            const auto it = std::find_if(trie.begin(), trie.end(),
+                [state, &byteSet](const TrieEdge& edge) {
+                    return edge.from == state and edge.byteSet == byteSet;
+                });
+            if (it != trie.end()) {
+                state = it->to;
+                continue;
+            }
+            auto next = makeNFAState();
+            state->addTransition(byteSet, next);
+            trie.push_back({state, byteSet, next});
+            state = next;
+        }
+        state->addTransition(sequence.back(), endState);
+    }
     return { startState, endState };
 }
 
@@ -47,7 +89,7 @@ NFA StateManager::makeConcatenation(NFA& a, NFA& b) {
         return a;
     }
     a.endState->m_isFinal = false;
-    a.endState->addTransition(EPS, b.startState);
+    a.endState->addEpsTransition(b.startState);
     return { a.startState, b.endState };
 }
 
@@ -68,11 +110,11 @@ NFA StateManager::makeAlternation(NFA& a, NFA& b) {
     a.endState->m_isFinal = false;
     b.endState->m_isFinal = false;
 
-    startState->addTransition(EPS, a.startState);
-    startState->addTransition(EPS, b.startState);
+    startState->addEpsTransition(a.startState);
+    startState->addEpsTransition(b.startState);
 
-    a.endState->addTransition(EPS, endState);
-    b.endState->addTransition(EPS, endState);
+    a.endState->addEpsTransition(endState);
+    b.endState->addEpsTransition(endState);
 
     return { startState, endState };
 }
@@ -83,97 +125,306 @@ NFA StateManager::makeAlternation(std::vector<NFA>& nfas) {
 
     for (auto nfa : nfas) {
         nfa.endState->m_isFinal = false;
-        startState->addTransition(EPS, nfa.startState);
-        nfa.endState->addTransition(EPS, endState);
+        startState->addEpsTransition(nfa.startState);
+        nfa.endState->addEpsTransition(endState);
     }
 
     return { startState, endState };
 }
 
-NFA StateManager::makeCharset(std::string_view charset) {
-    std::vector<NFA> syms;
-    for (auto sym : charset) {
-        syms.push_back(makeSymbol(sym));
-    }
-    return makeAlternation(syms);
-}
-
 NFA StateManager::makeKleeneClousure(NFA& nfa) {
-    nfa.startState->addTransition(EPS, nfa.endState);
-    nfa.endState->addTransition(EPS, nfa.startState);
+    nfa.startState->addEpsTransition(nfa.endState);
+    nfa.endState->addEpsTransition(nfa.startState);
     return { nfa.startState, nfa.endState };
 }
 
 NFA StateManager::makePlus(NFA& nfa) {
-    nfa.endState->addTransition(EPS, nfa.startState);
+    nfa.endState->addEpsTransition(nfa.startState);
     return { nfa.startState, nfa.endState };
 }
 
 NFA StateManager::makeQuestion(NFA& nfa) {
-    nfa.startState->addTransition(EPS, nfa.endState);
+    nfa.startState->addEpsTransition(nfa.endState);
     return { nfa.startState, nfa.endState };
 }
 
-NFA StateManager::makeCopy(const NFA& nfa) {
+/**
+ * The quantifiers above add edges between the start and end states, which
+ * must not be entered again from within the NFA, e.g. by the loop of a+ in
+ * (a+b)?, hence the NFA is wrapped by fresh states.
+ */
+NFA StateManager::makeIsolated(NFA& nfa) {
+    auto startState = makeNFAState();
+    auto endState = makeNFAState(true);
+    nfa.endState->m_isFinal = false;
+    startState->addEpsTransition(nfa.startState);
+    nfa.endState->addEpsTransition(endState);
+    return { startState, endState };
+}
+
+/**
+ * The tagged states are wrapped by untagged start and end states so that
+ * repetitions skipping the group do not record its tags.
+ */
+NFA StateManager::makeCapture(NFA& nfa, const uint32_t group) {
+    auto startState = makeNFAState();
+    auto openState = makeTaggedNFAState(openTag(group));
+    auto closeState = makeTaggedNFAState(closeTag(group));
+    auto endState = makeNFAState(true);
+
+    startState->addEpsTransition(openState);
     if (nfa.isEmpty()) {
-        return nfa;
+        openState->addEpsTransition(closeState);
+    }
+    else {
+        nfa.endState->m_isFinal = false;
+        openState->addEpsTransition(nfa.startState);
+        nfa.endState->addEpsTransition(closeState);
     }
-    std::map<NFAState const*, NFAState*> copied;
-    copied[nfa.startState] = makeNFAState();
-    copyTransitions(nfa.startState, copied);
-    return { copied.at(nfa.startState), copied.at(nfa.endState) };
+    closeState->addEpsTransition(endState);
+    return { startState, endState };
+}
+
+/**
+ * The rules keep their own final states, which tell the rule a token
+ * matches, rather than sharing the end state of an alternation. An empty
+ * rule only matches the empty string, which is no token.
+ */
+NFAState* StateManager::makeScanner(std::vector<NFA>& rules) {
+    auto startState = makeNFAState();
+    for (uint32_t token = 0u; token < rules.size(); token++) {
+        if (rules[token].isEmpty()) {
+            continue;
+        }
+        rules[token].endState->m_token = token;
+        startState->addEpsTransition(rules[token].startState);
+    }
+    return startState;
 }
 
-void StateManager::copyTransitions(NFAState const* copyFrom, std::map<NFAState const*, NFAState*>& copied) {
-    for (const auto& [sym, tos] : copyFrom->m_transitions) {
-        for (auto const* to : tos) {
-            if (copied.find(to) == copied.end()) {
-                copied[to] = makeNFAState(to->m_isFinal);
-                copyTransitions(to, copied);
+/**
+ * The NFA reading the strings which lead the DFA from its start to one of
+ * the final states given, or the mirror images of the strings if reversed.
+ * Reversing the transitions makes the automaton nondeterministic, hence it
+ * goes through the subset construction and the minimization again.
+ */
+NFA StateManager::makeFromDFA(const DFA& dfa, const std::vector<bool>& finals, const bool reversed) {
+    const auto& byteClasses = dfa.byteClasses();
+    std::pmr::vector<NFAState*> states(dfa.numStates(), nullptr, m_allocator);
+    for (DFA::StateId state = DFA::DEAD + 1; state < static_cast<DFA::StateId>(dfa.numStates()); state++) {
+        states[state] = makeNFAState();
+    }
+    for (DFA::StateId state = DFA::DEAD + 1; state < static_cast<DFA::StateId>(dfa.numStates()); state++) {
+        std::pmr::map<DFA::StateId, ByteSet> transitions(m_allocator);
+        for (size_t cls = 0u; cls < byteClasses.numClasses(); cls++) {
+            if (const auto to = dfa.nextByClass(state, cls); to != DFA::DEAD) {
+                transitions[to].add(byteClasses.bytesOf(cls));
+            }
+        }
+        for (const auto& [to, byteSet] : transitions) {
+            if (reversed) {
+                states[to]->addTransition(byteSet, states[state]);
+            }
+            else {
+                states[state]->addTransition(byteSet, states[to]);
             }
-            copied.at(copyFrom)->addTransition(sym, copied.at(to));
         }
     }
+
+    auto startState = makeNFAState();
+    auto endState = makeNFAState(true);
+    if (dfa.start() == DFA::DEAD) {
+        return { startState, endState };  // the end state is unreachable
+    }
+    for (DFA::StateId state = DFA::DEAD + 1; state < static_cast<DFA::StateId>(dfa.numStates()); state++) {
+        if (not finals[state]) {
+            continue;
+        }
+        if (reversed) {
+            startState->addEpsTransition(states[state]);
+        }
+        else {
+            states[state]->addEpsTransition(endState);
+        }
+    }
+    if (reversed) {
+        states[dfa.start()]->addEpsTransition(endState);
+    }
+    else {
+        startState->addEpsTransition(states[dfa.start()]);
+    }
+    return { startState, endState };
 }
 
 // DFA
 
-DFAStateFromNFA* StateManager::DFAFromNFA(NFAState const* nfa) {
-    const auto dfaInfo = mergeEPSTransitions(nfa);
-    DFAStateFromNFA* dfa = getDFAState(dfaInfo);
-    generateDFATransitions(dfa);
+DFAStateFromNFA* StateManager::DFAFromNFA(NFAState const* nfa, const size_t numThreads) {
+    computeByteClasses();
+    computeEpsClosures(nfa);
+    DFAStateFromNFA* dfa = getDFAState(m_epsClosures[nfa->m_id]);
+    if (numThreads > 1u) {
+        generateDFATransitionsInParallel(dfa, numThreads);
+    }
+    else {
+        generateDFATransitions(dfa);
+    }
     return dfa;
 }
 
 DFAStateFromNFA* StateManager::getDFAState(const DFAInfo& dfaInfo) {
-    const auto nfasInvolved = dfaInfo.nfasInvolved;
-    if (m_DFAs.find(dfaInfo.nfasInvolved) == m_DFAs.end()) {
-        m_DFAs.try_emplace(
-            dfaInfo.nfasInvolved,
-            m_DFAs.size(),
-            dfaInfo.isFinal,
-            dfaInfo.nfasInvolved);
+    const auto [it, _] = m_DFAs.try_emplace(
+        dfaInfo.nfasInvolved,
+        m_DFAs.size(),
+        dfaInfo.isFinal,
+        dfaInfo.token,
+        dfaInfo.nfasInvolved);
+    return &(it->second);
+}
+
+void StateManager::computeByteClasses() {
+    m_byteClasses = ByteClasses();
+    for (const auto& nfaState : m_NFAs) {
+        for (const auto& [byteSet, _] : nfaState.m_transitions) {
+            m_byteClasses.refine(byteSet);
+        }
     }
-    return &(m_DFAs.at(nfasInvolved));
 }
 
-void StateManager::generateDFATransitions(DFAStateFromNFA* dfaState) {
-    for (const auto sym : m_inputSymbols) {
-        assert(sym != EPS);
-        if (dfaState->hasTransition(sym)) {
+/* Depth-first from the state, as a recursion on each new target would go, without the depth of the DFA on the stack */
+void StateManager::generateDFATransitions(DFAStateFromNFA* start) {
+    std::pmr::vector<std::pair<DFAStateFromNFA*, size_t>> path({{start, 0u}}, m_allocator);
+    while (not path.empty()) {
+        auto& [dfaState, nextCls] = path.back();
+        if (nextCls == m_byteClasses.numClasses()) {
+            path.pop_back();
             continue;
         }
-        const auto dfaInfo = mergeTransitions(dfaState, sym);
+        const auto cls = nextCls++;
+        if (dfaState->hasTransition(cls)) {
+            continue;
+        }
+        const auto dfaInfo = mergeTransitions(dfaState, cls, m_allocator);
+        if (dfaInfo.nfasInvolved.empty()) {
+            continue;  // left to the dead state
+        }
         DFAStateFromNFA* to = getDFAState(dfaInfo);
-        dfaState->addTransition(sym, to);
-        generateDFATransitions(to);
+        dfaState->addTransition(cls, to);
+        path.emplace_back(to, 0u);
     }
 }
 
-StateManager::DFAInfo StateManager::mergeEPSTransitions(NFAState const* nfaState) {
-    DFAInfo dfaInfo;
-    mergeEPSTransitions(nfaState, dfaInfo);
-    return dfaInfo;
+/**
+ * The workers take the states to expand from a shared frontier and compute
+ * their transitions without a lock, which is where the time goes; only the
+ * interning of the target states in m_DFAs is serialized. Each state is
+ * expanded by a single worker, so its transitions need no lock. The DFA is
+ * the sequential one but for the numbering of the states, which the
+ * minimization does not depend on.
+ *
+ * The sets merged for each class are temporaries, allocated from a pool of
+ * the worker, which only takes chunks from the resource of the manager:
+ * its lock, if any, is only taken for the states interned and their
+ * transitions, which outlive the workers.
+ */
+void StateManager::generateDFATransitionsInParallel(DFAStateFromNFA* start, const size_t numThreads) {
+    std::mutex frontierMutex;
+    std::condition_variable frontierChanged;
+    std::vector<DFAStateFromNFA*> frontier{start};
+    size_t numBusyWorkers = 0u;
+
+    const auto work = [&]() {
+        std::pmr::unsynchronized_pool_resource pool(&m_resource);
+        const Allocator allocator(&pool);
+        std::pmr::vector<DFAStateFromNFA*> newStates(allocator);
+        std::unique_lock<std::mutex> lock(frontierMutex);
+        while (true) {
+            frontierChanged.wait(lock, [&]() {
+                return not frontier.empty() or numBusyWorkers == 0u;
+            });
+            if (frontier.empty()) {
+                return;  // no state left and none being expanded
+            }
+            auto* dfaState = frontier.back();
+            frontier.pop_back();
+            numBusyWorkers++;
+            lock.unlock();
+
+            newStates.clear();
+            for (size_t cls = 0u; cls < m_byteClasses.numClasses(); cls++) {
+                const auto dfaInfo = mergeTransitions(dfaState, cls, allocator);
+                if (dfaInfo.nfasInvolved.empty()) {
+                    continue;  // left to the dead state
+                }
+                const auto [to, isNew] = internDFAState(dfaInfo);
+                dfaState->addTransition(cls, to);
+                if (isNew) {
+                    newStates.push_back(to);
+                }
+            }
+
+            lock.lock();
+            numBusyWorkers--;
+            frontier.insert(frontier.end(), newStates.begin(), newStates.end());
+            frontierChanged.notify_all();
+        }
+    };
+
+    m_resource.setLocking(true);
+    std::vector<std::thread> workers;
+    for (size_t i = 0u; i < numThreads; i++) {
+        workers.emplace_back(work);
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    m_resource.setLocking(false);
+}
+
+std::pair<DFAStateFromNFA*, bool> StateManager::internDFAState(const DFAInfo& dfaInfo) {
+    std::lock_guard<std::mutex> lock(m_DFAsMutex);
+    const auto [it, isNew] = m_DFAs.try_emplace(
+        dfaInfo.nfasInvolved,
+        m_DFAs.size(),
+        dfaInfo.isFinal,
+        dfaInfo.token,
+        dfaInfo.nfasInvolved);
+    return { &(it->second), isNew };
+}
+
+/**
+ * The closure is computed once for the start state and for each target of
+ * a byte transition. The states only left by epsilon edges are dropped from
+ * it, as they add nothing to the transitions of a DFA state, and a DFA
+ * state then gets its transitions from the closures without following an
+ * epsilon edge again.
+ */
+void StateManager::computeEpsClosures(NFAState const* start) {
+    m_epsClosures.assign(m_NFAs.size(), DFAInfo(m_allocator));
+    std::pmr::vector<bool> isVisited(m_NFAs.size(), false, m_allocator);
+    std::pmr::vector<NFAState const*> toVisit({start}, m_allocator);
+    isVisited[start->m_id] = true;
+    while (not toVisit.empty()) {
+        auto const* nfaState = toVisit.back();
+        toVisit.pop_back();
+
+        DFAInfo closure(m_allocator);
+        mergeEPSTransitions(nfaState, closure);
+        auto& epsFreeClosure = m_epsClosures[nfaState->m_id];
+        epsFreeClosure.isFinal = closure.isFinal;
+        epsFreeClosure.token = closure.token;
+        for (auto const* inClosure : closure.nfasInvolved) {
+            if (inClosure->m_transitions.empty() and not inClosure->m_isFinal) {
+                continue;
+            }
+            epsFreeClosure.addNfaState(inClosure);
+            for (const auto& [_, to] : inClosure->m_transitions) {
+                if (not isVisited[to->m_id]) {
+                    isVisited[to->m_id] = true;
+                    toVisit.push_back(to);
+                }
+            }
+        }
+    }
 }
 
 void StateManager::mergeEPSTransitions(NFAState const* nfaState, DFAInfo& dfaInfo) {
@@ -182,22 +433,25 @@ void StateManager::mergeEPSTransitions(NFAState const* nfaState, DFAInfo& dfaInf
     }
     dfaInfo.addNfaState(nfaState);
     if (nfaState->m_isFinal) {
-        dfaInfo.isFinal = true;
-    }
-    if (not nfaState->hasTransition(EPS)) {
-        return;
+        dfaInfo.addFinal(nfaState->m_token);
     }
-    for (auto const* to : nfaState->m_transitions.at(EPS)) {
+    for (auto const* to : nfaState->m_epsTransitions) {
         mergeEPSTransitions(to, dfaInfo);
     }
 }
 
-StateManager::DFAInfo StateManager::mergeTransitions(DFAStateFromNFA const* dfaState, const char sym) {
-    DFAInfo dfaInfo;
+StateManager::DFAInfo StateManager::mergeTransitions(DFAStateFromNFA const* dfaState, const uint8_t cls,
+                                                     const Allocator& allocator) const {
+    const auto byte = m_byteClasses.representative(cls);
+    DFAInfo dfaInfo(allocator);
     for (auto const* nfaState : dfaState->m_NFAStateSet) {
-        if (nfaState->hasTransition(sym)) {
-            for (auto const* to : nfaState->m_transitions.at(sym)) {
-                mergeEPSTransitions(to, dfaInfo);
+        for (const auto& [byteSet, to] : nfaState->m_transitions) {
+            if (byteSet.contains(byte)) {
+                const auto& closure = m_epsClosures[to->m_id];
+                dfaInfo.nfasInvolved.insert(closure.nfasInvolved.begin(), closure.nfasInvolved.end());
+                if (closure.isFinal) {
+                    dfaInfo.addFinal(closure.token);
+                }
             }
         }
     }
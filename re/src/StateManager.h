@@ -1,51 +1,117 @@
 #pragma once
 
+#include "ByteClasses.h"
+#include "ByteSet.h"
 #include "FA.h"
 #include "REDef.h"
+#include "UTF8.h"
 
+#include <algorithm>
 #include <vector>
 #include <list>
 #include <map>
+#include <memory_resource>
+#include <mutex>
 #include <set>
+#include <string>
+#include <utility>
 
 namespace RE {
 
 class REParsingStack;
 
 /**
- * Manages the life cycle of NFA and DFA states
+ * Manages the life cycle of NFA and DFA states, which are allocated from
+ * the memory resource given, as are the temporaries of the constructions
  */
 class StateManager {
-    friend class REParserImpl;
+    friend class RECompiler;
     friend class DFAMinimizer;
+    friend class DFAProduct;
+    friend class SearchPlan;
+
+public:
+    explicit StateManager(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) :
+        m_resource(resource) {}
 
 private:
-    // NFA
-    NFA concatenateNFAs(std::vector<NFA>&);
+    /**
+     * A resource such as std::pmr::monotonic_buffer_resource is not
+     * thread-safe, so its allocations are serialized while the workers of
+     * the parallel subset construction run, and only then; those of the
+     * heap and of a synchronized pool are not, as they need no lock
+     */
+    class LockableResource : public std::pmr::memory_resource {
+    public:
+        explicit LockableResource(std::pmr::memory_resource* upstream) :
+            m_upstream(upstream),
+            m_isSynchronized(upstream == std::pmr::new_delete_resource() or
+                             dynamic_cast<std::pmr::synchronized_pool_resource*>(upstream) != nullptr)
+        {}
+        void setLocking(const bool isLocking) { m_isLocking = isLocking and not m_isSynchronized; }
+
+    private:
+        void* do_allocate(const size_t bytes, const size_t alignment) override {
+            if (not m_isLocking) {
+                return m_upstream->allocate(bytes, alignment);
+            }
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_upstream->allocate(bytes, alignment);
+        }
+        void do_deallocate(void* pointer, const size_t bytes, const size_t alignment) override {
+            if (not m_isLocking) {
+                return m_upstream->deallocate(pointer, bytes, alignment);
+            }
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_upstream->deallocate(pointer, bytes, alignment);
+        }
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+
+        std::pmr::memory_resource* const m_upstream;
+        const bool m_isSynchronized;
+        std::mutex m_mutex;
+        bool m_isLocking = false;
+    };
 
+    // NFA
     NFAState* makeNFAState(const bool isFinal = false);
+    NFAState* makeTaggedNFAState(const int32_t tag);
 
-    NFA makeSymbol(const char);
+    NFA makeLiteral(const std::string&);
+    NFA makeByteSet(const ByteSet&);
+    NFA makeUTF8Sequences(const std::vector<UTF8::Sequence>&);
     NFA makeConcatenation(NFA&, NFA&);
     NFA makeAlternation(NFA&, NFA&);
     NFA makeAlternation(std::vector<NFA>&);
-    NFA makeCharset(std::string_view);
-    NFA makeDigit() {
-        return makeCharset("0123456789");
-    }
 
     NFA makeKleeneClousure(NFA&);
     NFA makePlus(NFA&);
     NFA makeQuestion(NFA&);
-    NFA makeCopy(const NFA&);
-    void copyTransitions(NFAState const*, std::map<NFAState const*, NFAState*>&);
+    NFA makeCapture(NFA&, const uint32_t);
+    NFA makeIsolated(NFA&);
+    NFA makeFromDFA(const DFA&, const std::vector<bool>& finals, const bool reversed);
+    NFAState* makeScanner(std::vector<NFA>& rules);
 
     // DFA
-    DFAStateFromNFA* DFAFromNFA(NFAState const*);
+    DFAStateFromNFA* DFAFromNFA(NFAState const*, const size_t numThreads = 1u);
 
     struct DFAInfo {
+        using allocator_type = Allocator;
+
+        explicit DFAInfo(const allocator_type& allocator) : nfasInvolved(allocator) {}
+        DFAInfo(const DFAInfo& other, const allocator_type& allocator) :
+            nfasInvolved(other.nfasInvolved, allocator), isFinal(other.isFinal), token(other.token) {}
+
         NFAStateSet nfasInvolved;
         bool isFinal = false;
+        uint32_t token = NO_TOKEN;
+
+        void addFinal(const uint32_t finalToken) {
+            isFinal = true;
+            token = std::min(token, finalToken);
+        }
 
         bool containsNfaState(NFAState const* nfaState) const {
             return nfasInvolved.find(nfaState) != nfasInvolved.end();
@@ -58,12 +124,18 @@ private:
 
     DFAStateFromNFA* getDFAState(const DFAInfo&);
     void generateDFATransitions(DFAStateFromNFA*);
-    static DFAInfo mergeEPSTransitions(NFAState const*);
+    void generateDFATransitionsInParallel(DFAStateFromNFA*, const size_t);
+    std::pair<DFAStateFromNFA*, bool> internDFAState(const DFAInfo&);
+    void computeEpsClosures(NFAState const*);
     static void mergeEPSTransitions(NFAState const*, DFAInfo&);
-    static DFAInfo mergeTransitions(DFAStateFromNFA const*, const char);
+    /* The set is allocated by the allocator given, e.g. one of the worker for a temporary */
+    DFAInfo mergeTransitions(DFAStateFromNFA const*, const uint8_t, const Allocator&) const;
+    void computeByteClasses();
 
 private:
-    std::set<char> m_inputSymbols;
+    LockableResource m_resource;
+    const Allocator m_allocator{&m_resource};
+    ByteClasses m_byteClasses;
     /**
      * Use STL containers to automatically manage resourses and remove the
      * need to use smart pointers, which could produce circular references.
@@ -73,9 +145,15 @@ private:
      * invalidated, resulting in undefined behaviors.
      */
     /* unlike vector, lists don't change their capacity */
-    std::list<NFAState> m_NFAs;
+    std::pmr::list<NFAState> m_NFAs{m_allocator};
     /* unlike unordered_map, maps don't change their capacity */
-    std::map<NFAStateSet, DFAStateFromNFA> m_DFAs;
+    std::pmr::map<NFAStateSet, DFAStateFromNFA> m_DFAs{m_allocator};
+    /**
+     * The epsilon-free NFA the subset construction runs on: by NFA state id,
+     * the states of the epsilon closure which read a byte or are final
+     */
+    std::pmr::vector<DFAInfo> m_epsClosures{m_allocator};
+    std::mutex m_DFAsMutex;  // guards m_DFAs during the parallel construction
 };
 
 } // namespace RE
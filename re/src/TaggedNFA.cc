@@ -0,0 +1,146 @@
+#include "TaggedNFA.h"
+
+#include <algorithm>
+#include <map>
+
+namespace RE {
+
+TaggedNFA::TaggedNFA(NFAState const* start, const uint32_t numGroups) :
+    m_numGroups(numGroups),
+    m_numTags(2 * (numGroups + 1))
+{
+    std::map<NFAState const*, int32_t> ids{{start, 0}};
+    std::vector<NFAState const*> toVisit{start};
+    const auto idOf = [&](NFAState const* nfaState) {
+        const auto [it, isNew] = ids.try_emplace(nfaState, ids.size());
+        if (isNew) {
+            toVisit.push_back(nfaState);
+        }
+        return it->second;
+    };
+    for (size_t i = 0; i < toVisit.size(); i++) {
+        NFAState const* nfaState = toVisit[i];
+        State state;
+        state.tag = nfaState->m_tag;
+        state.isFinal = nfaState->m_isFinal;
+        for (auto const* to : nfaState->m_epsTransitions) {
+            state.epsTransitions.push_back(idOf(to));
+        }
+        for (const auto& [byteSet, to] : nfaState->m_transitions) {
+            state.transitions.emplace_back(byteSet, idOf(to));
+        }
+        m_states.push_back(std::move(state));
+    }
+}
+
+size_t TaggedNFA::memoryUsage() const {
+    auto bytes = sizeof(*this) + m_states.capacity() * sizeof(State);
+    for (const auto& state : m_states) {
+        bytes += state.epsTransitions.capacity() * sizeof(int32_t) +
+                 state.transitions.capacity() * sizeof(state.transitions.front());
+    }
+    return bytes;
+}
+
+bool TaggedNFA::match(std::string_view str, REParser::Groups_t& groups) const {
+    Threads current(m_states.size(), m_numTags);
+    Threads next(m_states.size(), m_numTags);
+    const std::vector<int32_t> noTags(m_numTags, -1);
+    ToVisit_t toVisit;
+    std::vector<int32_t> candidate(m_numTags);
+
+    addThread(current, 0, noTags.data(), 0, toVisit, candidate);
+    for (size_t pos = 0; pos < str.size(); pos++) {
+        next.clear();
+        for (const auto from : current.states()) {
+            for (const auto& [byteSet, to] : m_states[from].transitions) {
+                if (byteSet.contains(str[pos])) {
+                    addThread(next, to, current.tagsOf(from), pos + 1,
+                              toVisit, candidate);
+                }
+            }
+        }
+        std::swap(current, next);
+        if (current.states().empty()) {
+            return false;
+        }
+    }
+
+    int32_t const* best = nullptr;
+    for (const auto state : current.states()) {
+        if (m_states[state].isFinal and
+            (best == nullptr or isBetter(current.tagsOf(state), best))) {
+            best = current.tagsOf(state);
+        }
+    }
+    if (best == nullptr) {
+        return false;
+    }
+    fillGroups(str, best, m_numGroups, groups);
+    return true;
+}
+
+/**
+ * Follow the epsilon closure of the state. A state already in the list is
+ * revisited only when the new tags are better, which terminates since
+ * "better" is a strict order on the finitely many tag vectors.
+ */
+void TaggedNFA::addThread(Threads& threads, const int32_t state,
+                          int32_t const* tags, const int32_t pos,
+                          ToVisit_t& toVisit, std::vector<int32_t>& candidate) const {
+    toVisit.emplace_back(state, tags);
+    while (not toVisit.empty()) {
+        const auto [current, fromTags] = toVisit.back();
+        toVisit.pop_back();
+
+        std::copy(fromTags, fromTags + m_numTags, candidate.begin());
+        if (m_states[current].tag != NO_TAG) {
+            candidate[m_states[current].tag] = pos;
+        }
+        int32_t* currentTags = threads.tagsOf(current);
+        if (threads.contains(current)) {
+            if (not isBetter(candidate.data(), currentTags)) {
+                continue;
+            }
+        }
+        else {
+            threads.insert(current);
+        }
+        std::copy(candidate.begin(), candidate.end(), currentTags);
+        for (const auto to : m_states[current].epsTransitions) {
+            toVisit.emplace_back(to, currentTags);
+        }
+    }
+}
+
+/**
+ * Groups are compared in order; a group that is set beats one that is not,
+ * then the leftmost start wins, then the longest end.
+ */
+bool TaggedNFA::isBetter(int32_t const* a, int32_t const* b) const {
+    for (size_t tag = openTag(1); tag < m_numTags; tag++) {
+        if (a[tag] == b[tag]) {
+            continue;
+        }
+        if (a[tag] < 0 or b[tag] < 0) {
+            return b[tag] < 0;
+        }
+        return tag % 2 == 0 ? a[tag] < b[tag] : a[tag] > b[tag];
+    }
+    return false;
+}
+
+void TaggedNFA::fillGroups(std::string_view str, int32_t const* tags,
+                           const uint32_t numGroups, REParser::Groups_t& groups) {
+    groups.assign(numGroups + 1, std::string_view());
+    groups[0] = str;
+    for (auto group = 1u; group <= numGroups; group++) {
+        const auto open = tags[openTag(group)];
+        const auto close = tags[closeTag(group)];
+        if (open >= 0 and close >= open) {
+            groups[group] = str.substr(open, close - open);
+        }
+    }
+}
+
+} // namespace RE
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "ByteSet.h"
+#include "FA.h"
+#include "REDef.h"
+
+#include <RE.h>
+
+#include <cstdint>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace RE {
+
+/**
+ * A flattened copy of the NFA, keeping the tags of the capture groups.
+ *
+ * Submatches are extracted by simulating the NFA with a tag vector per
+ * thread (Laurikari's TNFA). When two threads reach the same state at the
+ * same position, the one with the leftmost-longest groups is kept, so the
+ * extraction is linear in the length of the input without backtracking.
+ */
+class TaggedNFA {
+    friend class OnePassDFA;
+
+public:
+    TaggedNFA(NFAState const*, const uint32_t numGroups);
+
+    bool match(std::string_view, REParser::Groups_t&) const;
+    size_t memoryUsage() const;
+
+    static void fillGroups(std::string_view, int32_t const* tags,
+                           const uint32_t numGroups, REParser::Groups_t&);
+
+private:
+    struct State {
+        int32_t tag = NO_TAG;
+        bool isFinal = false;
+        std::vector<int32_t> epsTransitions;
+        std::vector<std::pair<ByteSet, int32_t>> transitions;
+    };
+
+    class Threads {
+    public:
+        Threads(const size_t numStates, const size_t numTags)
+            : m_numTags(numTags), m_slots(numStates, -1),
+              m_tags(numStates * numTags, -1) {}
+
+        bool contains(const int32_t state) const { return m_slots[state] >= 0; }
+        void insert(const int32_t state) {
+            m_slots[state] = m_states.size();
+            m_states.push_back(state);
+        }
+        void clear() {
+            for (const auto state : m_states) {
+                m_slots[state] = -1;
+            }
+            m_states.clear();
+        }
+        int32_t* tagsOf(const int32_t state) { return &m_tags[state * m_numTags]; }
+        const std::vector<int32_t>& states() const { return m_states; }
+
+    private:
+        size_t m_numTags;
+        std::vector<int32_t> m_slots;  // state -> index in m_states
+        std::vector<int32_t> m_states;
+        std::vector<int32_t> m_tags;
+    };
+
+    using ToVisit_t = std::vector<std::pair<int32_t, int32_t const*>>;
+    void addThread(Threads&, const int32_t, int32_t const*, const int32_t,
+                   ToVisit_t&, std::vector<int32_t>&) const;
+    bool isBetter(int32_t const*, int32_t const*) const;
+
+    std::vector<State> m_states;
+    uint32_t m_numGroups;
+    size_t m_numTags;
+};
+
+} // namespace RE
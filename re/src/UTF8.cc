@@ -0,0 +1,130 @@
+#include "UTF8.h"
+
+namespace RE::UTF8 {
+
+namespace {
+
+constexpr uint32_t MAX_ONE_BYTE = 0x7fu;
+constexpr uint32_t MAX_TWO_BYTES = 0x7ffu;
+constexpr uint32_t MAX_THREE_BYTES = 0xffffu;
+
+void splitRange(const uint32_t lo, const uint32_t hi, std::vector<Sequence>& sequences) {
+    if (lo <= SURROGATE_END and hi >= SURROGATE_START) {
+        if (lo < SURROGATE_START) {
+            splitRange(lo, SURROGATE_START - 1, sequences);
+        }
+        if (hi > SURROGATE_END) {
+            splitRange(SURROGATE_END + 1, hi, sequences);
+        }
+        return;
+    }
+    // codepoints of the range must have the same encoded length
+    for (const auto max : {MAX_ONE_BYTE, MAX_TWO_BYTES, MAX_THREE_BYTES}) {
+        if (lo <= max and max < hi) {
+            splitRange(lo, max, sequences);
+            splitRange(max + 1, hi, sequences);
+            return;
+        }
+    }
+    // and the bytes after a differing one must span the whole [80-BF]
+    for (auto i = 1u; i < MAX_SEQUENCE_LENGTH and hi > MAX_ONE_BYTE; i++) {
+        const uint32_t mask = (1u << (6 * i)) - 1;
+        if ((lo & ~mask) == (hi & ~mask)) {
+            continue;
+        }
+        if ((lo & mask) != 0u) {
+            splitRange(lo, lo | mask, sequences);
+            splitRange((lo | mask) + 1, hi, sequences);
+            return;
+        }
+        if ((hi & mask) != mask) {
+            splitRange(lo, (hi & ~mask) - 1, sequences);
+            splitRange(hi & ~mask, hi, sequences);
+            return;
+        }
+    }
+
+    uint8_t loBytes[MAX_SEQUENCE_LENGTH];
+    uint8_t hiBytes[MAX_SEQUENCE_LENGTH];
+    const auto length = encode(lo, loBytes);
+    encode(hi, hiBytes);
+    Sequence sequence;
+    for (auto i = 0u; i < length; i++) {
+        sequence.push_back(ByteSet::range(loBytes[i], hiBytes[i]));
+    }
+    sequences.push_back(std::move(sequence));
+}
+
+} // namespace
+
+std::vector<Sequence> sequencesOf(const CharClass& charClass) {
+    std::vector<Sequence> sequences;
+    for (const auto& [lo, hi] : charClass.ranges()) {
+        splitRange(lo, hi, sequences);
+    }
+    return sequences;
+}
+
+uint32_t encode(const uint32_t codepoint, uint8_t* bytes) {
+    if (codepoint <= MAX_ONE_BYTE) {
+        bytes[0] = codepoint;
+        return 1u;
+    }
+    if (codepoint <= MAX_TWO_BYTES) {
+        bytes[0] = 0xc0u | (codepoint >> 6);
+        bytes[1] = 0x80u | (codepoint & 0x3fu);
+        return 2u;
+    }
+    if (codepoint <= MAX_THREE_BYTES) {
+        bytes[0] = 0xe0u | (codepoint >> 12);
+        bytes[1] = 0x80u | ((codepoint >> 6) & 0x3fu);
+        bytes[2] = 0x80u | (codepoint & 0x3fu);
+        return 3u;
+    }
+    bytes[0] = 0xf0u | (codepoint >> 18);
+    bytes[1] = 0x80u | ((codepoint >> 12) & 0x3fu);
+    bytes[2] = 0x80u | ((codepoint >> 6) & 0x3fu);
+    bytes[3] = 0x80u | (codepoint & 0x3fu);
+    return 4u;
+}
+
+int32_t decode(std::string_view str, size_t& pos) {
+    const uint8_t lead = str[pos];
+    uint32_t length;
+    uint32_t codepoint;
+    uint32_t min;
+    if (lead <= MAX_ONE_BYTE) {
+        pos++;
+        return lead;
+    }
+    else if ((lead & 0xe0u) == 0xc0u) {
+        length = 2u, codepoint = lead & 0x1fu, min = MAX_ONE_BYTE + 1;
+    }
+    else if ((lead & 0xf0u) == 0xe0u) {
+        length = 3u, codepoint = lead & 0x0fu, min = MAX_TWO_BYTES + 1;
+    }
+    else if ((lead & 0xf8u) == 0xf0u) {
+        length = 4u, codepoint = lead & 0x07u, min = MAX_THREE_BYTES + 1;
+    }
+    else {
+        return INVALID;
+    }
+    if (pos + length > str.size()) {
+        return INVALID;
+    }
+    for (auto i = 1u; i < length; i++) {
+        const uint8_t byte = str[pos + i];
+        if ((byte & 0xc0u) != 0x80u) {
+            return INVALID;
+        }
+        codepoint = (codepoint << 6) | (byte & 0x3fu);
+    }
+    if (codepoint < min or codepoint > CharClass::MAX_CODEPOINT or
+        (codepoint >= SURROGATE_START and codepoint <= SURROGATE_END)) {
+        return INVALID;
+    }
+    pos += length;
+    return codepoint;
+}
+
+} // namespace RE::UTF8
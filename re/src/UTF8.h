@@ -0,0 +1,38 @@
+#pragma once
+
+#include "ByteSet.h"
+#include "CharClass.h"
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace RE::UTF8 {
+
+constexpr uint32_t MAX_SEQUENCE_LENGTH = 4u;
+constexpr uint32_t SURROGATE_START = 0xd800u;
+constexpr uint32_t SURROGATE_END = 0xdfffu;
+constexpr int32_t INVALID = -1;
+
+/**
+ * Byte ranges matching the UTF-8 encodings of a range of codepoints, one
+ * per byte of the sequence, e.g. U+0080..U+07FF is [C2-DF][80-BF]
+ */
+using Sequence = std::vector<ByteSet>;
+
+/**
+ * Split the codepoints of the class into ranges that each encode into a
+ * single sequence of byte ranges (the utf8-ranges technique). Surrogates
+ * are left out since they are not valid in UTF-8.
+ */
+std::vector<Sequence> sequencesOf(const CharClass&);
+
+uint32_t encode(const uint32_t codepoint, uint8_t* bytes);
+
+/**
+ * Decode the codepoint starting at str[pos], advancing pos past it.
+ * Returns INVALID for malformed, overlong and surrogate encodings.
+ */
+int32_t decode(std::string_view str, size_t& pos);
+
+} // namespace RE::UTF8
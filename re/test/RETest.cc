@@ -344,6 +344,17 @@ TEST(RETest, Repetitions_5) {
     EXPECT_FALSE(parser.matchExact(std::string(29u, 'a')));
 }
 
+TEST(RETest, Repetitions_6) {
+    RE::REParser parser("((a?)*(()|b?)*)*c");
+    EXPECT_TRUE(parser.matchExact("c"));
+    EXPECT_TRUE(parser.matchExact("abbac"));
+    EXPECT_TRUE(parser.matchExact("bbbbc"));
+
+    EXPECT_FALSE(parser.matchExact(""));
+    EXPECT_FALSE(parser.matchExact("ab"));
+    EXPECT_FALSE(parser.matchExact("acc"));
+}
+
 TEST(RETest, CanParseAndMatchGeneralRE_1) {
     RE::REParser parser("a*bc+d?");
     EXPECT_TRUE(parser.matchExact("aaabccd"));
@@ -359,7 +370,6 @@ TEST(RETest, CanParseAndMatchGeneralRE_1) {
 }
 
 TEST(RETest, CanParseAndMatchGeneralRE_EmailAddress) {
-    // TODO currently wildcard . as well as \w is not supported
     RE::REParser parser("(_|a|b|c|d|e|f|g|h|i|j|k|l|m|n|o|p|q|r|s|t|u|v|w|x|y|z)+@(gmail|yahoo|hotmail).com");
     EXPECT_TRUE(parser.matchExact("alan_turing@gmail.com"));
     EXPECT_TRUE(parser.matchExact("__admin__@hotmail.com"));
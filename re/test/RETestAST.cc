@@ -0,0 +1,107 @@
+#include <RE.h>
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+
+/**
+ * The patterns are rewritten before the NFA is built, which must not change
+ * what they match nor what their groups capture.
+ */
+TEST(RETest, AST_NestedQuantifiers) {
+    for (const auto re : {"(a*)*", "(a+)*", "(a*)+", "(a?)*", "(a+)?", "((a?)?)*"}) {
+        RE::REParser parser(re);
+        EXPECT_TRUE(parser.matchExact("")) << re;
+        EXPECT_TRUE(parser.matchExact("a")) << re;
+        EXPECT_FALSE(parser.matchExact("b")) << re;
+    }
+    EXPECT_TRUE(RE::REParser("(a*)*").matchExact("aaaa"));
+    EXPECT_TRUE(RE::REParser("(a+)+").matchExact("aaaa"));
+    EXPECT_FALSE(RE::REParser("(a+)+").matchExact(""));
+    EXPECT_FALSE(RE::REParser("(a?)?").matchExact("aa"));
+    EXPECT_TRUE(RE::REParser("(a?){3}").matchExact("aa"));
+    EXPECT_FALSE(RE::REParser("(a?){3}").matchExact("aaaa"));
+    EXPECT_TRUE(RE::REParser("(a+){2}").matchExact("aa"));
+    EXPECT_FALSE(RE::REParser("(a+){2}").matchExact("a"));
+}
+
+TEST(RETest, AST_CommonPrefixes) {
+    RE::REParser parser("foo|bar|baz|ba|foobar");
+    for (const auto str : {"foo", "bar", "baz", "ba", "foobar"}) {
+        EXPECT_TRUE(parser.matchExact(str)) << str;
+    }
+    for (const auto str : {"fo", "b", "bax", "foob", ""}) {
+        EXPECT_FALSE(parser.matchExact(str)) << str;
+    }
+
+    std::string_view match;
+    EXPECT_EQ(RE::REParser("a|ab").find("xab", match), 1);
+    EXPECT_EQ(match, "ab");
+}
+
+TEST(RETest, AST_SingleCharAlternatives) {
+    RE::REParser parser("x|y|[0-9]|z|xy");
+    for (const auto str : {"x", "y", "z", "5", "xy"}) {
+        EXPECT_TRUE(parser.matchExact(str)) << str;
+    }
+    EXPECT_FALSE(parser.matchExact("w"));
+    EXPECT_FALSE(parser.matchExact("yx"));
+}
+
+TEST(RETest, AST_EmptyAlternatives) {
+    RE::REParser parser("a(|b|)c");
+    EXPECT_TRUE(parser.matchExact("ac"));
+    EXPECT_TRUE(parser.matchExact("abc"));
+    EXPECT_FALSE(parser.matchExact("abbc"));
+    EXPECT_TRUE(RE::REParser("()").matchExact(""));
+    EXPECT_TRUE(RE::REParser("(|)*").matchExact(""));
+    EXPECT_TRUE(RE::REParser("a{0}b").matchExact("b"));
+    // the loop of the alternative must not lead back to its start
+    EXPECT_FALSE(RE::REParser("(|ab*)").matchExact("b"));
+    EXPECT_FALSE(RE::REParser("(|cab(a)*)").matchExact("a"));
+}
+
+TEST(RETest, AST_QuantifiedSequences) {
+    RE::REParser parser("((b)+(cab)*){2}");
+    EXPECT_TRUE(parser.matchExact("bb"));
+    EXPECT_TRUE(parser.matchExact("bcabbbcab"));
+    EXPECT_FALSE(parser.matchExact("b"));
+    EXPECT_FALSE(parser.matchExact("bcab"));
+    EXPECT_FALSE(RE::REParser("(b+c)?").matchExact("b"));
+    EXPECT_FALSE(RE::REParser("(b+c)*").matchExact("bcb"));
+}
+
+TEST(RETest, AST_GroupsKeptInPlace) {
+    RE::REParser::Groups_t groups;
+    RE::REParser parser("(foo)|(bar)|(baz)");
+    ASSERT_TRUE(parser.matchExact("baz", groups));
+    ASSERT_EQ(groups.size(), 4u);
+    EXPECT_EQ(groups[1].data(), nullptr);
+    EXPECT_EQ(groups[2].data(), nullptr);
+    EXPECT_EQ(groups[3], "baz");
+
+    ASSERT_TRUE(RE::REParser("((a*)*)b").matchExact("aab", groups));
+    EXPECT_EQ(groups[1], "aa");
+
+    ASSERT_TRUE(RE::REParser("(x)|(y)|z").matchExact("y", groups));
+    EXPECT_EQ(groups[1].data(), nullptr);
+    EXPECT_EQ(groups[2], "y");
+}
+
+/* The parser nests the alternatives, which the passes over the tree must not recurse into */
+TEST(RETest, AST_ManyAlternatives) {
+    std::string re;
+    for (size_t i = 0u; i < 100000u; i++) {
+        re += (i == 0u ? "" : "|") + std::string("w") + std::to_string(i);
+    }
+    RE::REParser dictionary(re);
+    EXPECT_TRUE(dictionary.matchExact("w99999"));
+    EXPECT_FALSE(dictionary.matchExact("w100000"));
+
+    RE::REParser::Groups_t groups;
+    RE::REParser grouped("(" + re + ")[xy]");
+    ASSERT_TRUE(grouped.matchExact("w123x", groups));
+    EXPECT_EQ(groups[1], "w123");
+    EXPECT_FALSE(grouped.matchExact("w123"));
+}
@@ -0,0 +1,65 @@
+#include <RE.h>
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+using namespace std::string_literals;
+
+
+/**
+ * The loops of .* and [^"]* are skipped by searching for their exit bytes,
+ * so the exits are put at every offset of the vectors compared at once.
+ */
+TEST(RETest, Acceleration_MatchExact) {
+    RE::REParser parser(".*ERROR");
+    for (size_t length = 0u; length < 100u; length++) {
+        const auto prefix = std::string(length, 'x');
+        EXPECT_TRUE(parser.matchExact(prefix + "ERROR"));
+        EXPECT_TRUE(parser.matchExact(prefix + "EERROR"));
+        EXPECT_TRUE(parser.matchExact("ERROR" + prefix + "ERROR"));
+        EXPECT_FALSE(parser.matchExact(prefix + "ERRO"));
+        EXPECT_FALSE(parser.matchExact(prefix + "ERROR" + "x"));
+        EXPECT_FALSE(parser.matchExact(prefix + "\nERROR"));
+    }
+}
+
+TEST(RETest, Acceleration_MultipleExits) {
+    RE::REParser parser(R"("[^"\\]*(\\.[^"\\]*)*")");
+    for (size_t length = 0u; length < 80u; length++) {
+        const auto chars = std::string(length, 'c');
+        EXPECT_TRUE(parser.matchExact("\"" + chars + "\""));
+        EXPECT_TRUE(parser.matchExact("\"" + chars + R"(\")" + chars + "\""));
+        EXPECT_FALSE(parser.matchExact("\"" + chars + "\"" + chars + "\""));
+        EXPECT_FALSE(parser.matchExact("\"" + chars));
+    }
+}
+
+TEST(RETest, Acceleration_FinalLoop) {
+    RE::REParser parser("key=.*");
+    std::string_view match;
+    for (size_t length = 0u; length < 80u; length++) {
+        const auto value = std::string(length, 'v');
+        const auto str = "a key=" + value + "\nkey=x";
+        EXPECT_EQ(parser.find(str, match), 2);
+        EXPECT_EQ(match, "key=" + value);
+    }
+}
+
+TEST(RETest, Acceleration_Backwards) {
+    RE::REParser parser(R"(#[^#]*\d+ms)");
+    std::string_view match;
+    for (size_t length = 0u; length < 80u; length++) {
+        const auto text = std::string(length, 't');
+        const auto str = "#a#" + text + " 12ms#";
+        EXPECT_EQ(parser.find(str, match), 2);
+        EXPECT_EQ(match, "#" + text + " 12ms");
+    }
+}
+
+TEST(RETest, Acceleration_AnyByte) {
+    RE::REParser parser(R"(a[\x00-\xff]*)");
+    EXPECT_TRUE(parser.matchExact("a"));
+    EXPECT_TRUE(parser.matchExact("a" + std::string(100, '\0') + "\xff"));
+    EXPECT_FALSE(parser.matchExact("b" + std::string(100, 'a')));
+}
@@ -0,0 +1,159 @@
+#include <RE.h>
+#include <REApproxMatcher.h>
+#include <REExceptions.h>
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <set>
+#include <string>
+#include <string_view>
+
+namespace {
+
+/* The strings one edit away over the alphabet */
+std::set<std::string> editsOf(const std::string& str, const std::string_view alphabet) {
+    std::set<std::string> edited;
+    for (size_t pos = 0u; pos <= str.size(); pos++) {
+        for (const auto c : alphabet) {
+            edited.insert(str.substr(0u, pos) + c + str.substr(pos));
+            if (pos < str.size()) {
+                edited.insert(str.substr(0u, pos) + c + str.substr(pos + 1u));
+            }
+        }
+        if (pos < str.size()) {
+            edited.insert(str.substr(0u, pos) + str.substr(pos + 1u));
+        }
+    }
+    return edited;
+}
+
+/* The fewest edits making the parser match the string, by trying every edit */
+int32_t bruteForceDistance(const RE::REParser& parser, const std::string& str,
+                           const uint32_t maxEdits, const std::string_view alphabet) {
+    std::set<std::string> reached{str};
+    for (uint32_t edits = 0u; edits <= maxEdits; edits++) {
+        std::set<std::string> next;
+        for (const auto& candidate : reached) {
+            if (parser.matchExact(candidate)) {
+                return static_cast<int32_t>(edits);
+            }
+            const auto edited = editsOf(candidate, alphabet);
+            next.insert(edited.begin(), edited.end());
+        }
+        reached = std::move(next);
+    }
+    return -1;
+}
+
+} // namespace
+
+TEST(RETest, Approx_Distance) {
+    RE::REApproxMatcher matcher("colou?r", 2u);
+    EXPECT_EQ(matcher.numPositions(), 6u);
+    EXPECT_EQ(matcher.distance("color"), 0);
+    EXPECT_EQ(matcher.distance("colour"), 0);
+    EXPECT_EQ(matcher.distance("colr"), 1);     // a deletion
+    EXPECT_EQ(matcher.distance("collor"), 1);   // an insertion
+    EXPECT_EQ(matcher.distance("celor"), 1);    // a substitution
+    EXPECT_EQ(matcher.distance("kolr"), 2);
+    EXPECT_EQ(matcher.distance("cl"), -1);
+    EXPECT_EQ(matcher.distance(""), -1);
+    EXPECT_TRUE(matcher.matchExact("clor"));
+    EXPECT_FALSE(matcher.matchExact("colorful"));
+
+    RE::REApproxMatcher exact("colou?r", 0u);
+    EXPECT_TRUE(exact.matchExact("color"));
+    EXPECT_FALSE(exact.matchExact("colr"));
+
+    RE::REApproxMatcher empty("", 1u);
+    EXPECT_EQ(empty.distance(""), 0);
+    EXPECT_EQ(empty.distance("x"), 1);
+    EXPECT_EQ(empty.distance("xy"), -1);
+}
+
+TEST(RETest, Approx_Identifiers) {
+    RE::REApproxMatcher getter("get[A-Z][a-z]*", 1u);
+    EXPECT_EQ(getter.distance("getName"), 0);
+    EXPECT_EQ(getter.distance("getname"), 1);
+    EXPECT_EQ(getter.distance("gtName"), 1);
+    EXPECT_EQ(getter.distance("gteName"), -1);
+
+    RE::REApproxMatcher keywords("(while|for|return)", 1u);
+    EXPECT_EQ(keywords.distance("retrun"), -1);  // a transposition is two edits
+    EXPECT_EQ(keywords.distance("retun"), 1);
+    EXPECT_EQ(keywords.distance("fore"), 1);
+    EXPECT_EQ(RE::REApproxMatcher("(while|for|return)", 2u).distance("retrun"), 2);
+
+    RE::REApproxMatcher counted("[a-z]{3}_[0-9]", 1u);
+    EXPECT_EQ(counted.numPositions(), 5u);
+    EXPECT_EQ(counted.distance("abc_1"), 0);
+    EXPECT_EQ(counted.distance("abc1"), 1);
+    EXPECT_EQ(counted.distance("ab_1"), 1);
+    EXPECT_EQ(counted.distance("a_1"), -1);
+}
+
+TEST(RETest, Approx_Flags) {
+    RE::REApproxMatcher utf8("naïve", 1u, RE::REParser::UTF8);
+    EXPECT_EQ(utf8.distance("naive"), 1);
+    EXPECT_EQ(utf8.distance("naïv"), 1);
+    EXPECT_EQ(utf8.distance("naïveté"), -1);
+    EXPECT_EQ(utf8.distance("na\xffve"), 1);  // a malformed byte is a character
+    // in bytes, ï is two characters
+    EXPECT_EQ(RE::REApproxMatcher("naïve", 2u).distance("naive"), 2);
+
+    RE::REApproxMatcher caseless("select", 1u, RE::REParser::CASE_INSENSITIVE);
+    EXPECT_EQ(caseless.distance("SELECT"), 0);
+    EXPECT_EQ(caseless.distance("Selct"), 1);
+}
+
+TEST(RETest, Approx_Find) {
+    RE::REApproxMatcher matcher("hello", 1u);
+    std::string_view match;
+    EXPECT_EQ(matcher.find("say helo!", match), 4);
+    EXPECT_EQ(match, "helo");
+    EXPECT_EQ(matcher.find("say hello!", match), 4);
+    EXPECT_EQ(match, "hello");
+    EXPECT_EQ(matcher.find("jello, hello", match), 0);
+    EXPECT_EQ(match, "jello");
+    EXPECT_EQ(matcher.find("help"), -1);
+    EXPECT_EQ(RE::REApproxMatcher("hello", 0u).find("jello, hello", match), 7);
+
+    RE::REApproxMatcher utf8("ωmega", 1u, RE::REParser::UTF8);
+    EXPECT_EQ(utf8.find("an omega", match), 3);
+    EXPECT_EQ(match, "omega");
+    EXPECT_EQ(utf8.find("το ωmeg", match), 5);
+    EXPECT_EQ(match, "ωmeg");
+}
+
+TEST(RETest, Approx_TooManyPositions) {
+    EXPECT_THROW(RE::REApproxMatcher("a{600}", 1u), RE::TooManyPositionsException);
+    EXPECT_THROW(RE::REApproxMatcher(std::string(513u, 'a'), 1u), RE::TooManyPositionsException);
+    EXPECT_EQ(RE::REApproxMatcher(std::string(512u, 'a'), 1u).distance(std::string(511u, 'a')), 1);
+    // states past the first word of the sets
+    RE::REApproxMatcher wide("[a-c]{100}x", 2u);
+    EXPECT_EQ(wide.distance(std::string(100u, 'b') + "x"), 0);
+    EXPECT_EQ(wide.distance(std::string(99u, 'b') + "y"), 2);
+}
+
+TEST(RETest, Approx_BruteForce) {
+    constexpr std::string_view ALPHABET = "abc";
+    const char* const PATTERNS[] = {
+        "abc", "a*b", "(ab|ba)*", "a(b|c)?c+", "[ab]*c[ab]*", "a?b?c?", "(a|bc)(ca|b)*a", "b{3}", "",
+    };
+    std::mt19937 random(48u);
+    for (const auto pattern : PATTERNS) {
+        const RE::REParser parser(pattern);
+        for (const auto maxEdits : {0u, 1u, 2u}) {
+            const RE::REApproxMatcher matcher(pattern, maxEdits);
+            for (int i = 0; i < 40; i++) {
+                std::string str(random() % 6u, 'a');
+                for (auto& c : str) {
+                    c = ALPHABET[random() % ALPHABET.size()];
+                }
+                EXPECT_EQ(matcher.distance(str), bruteForceDistance(parser, str, maxEdits, ALPHABET))
+                    << pattern << " " << str << " " << maxEdits;
+            }
+        }
+    }
+}
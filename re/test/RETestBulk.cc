@@ -0,0 +1,96 @@
+#include <REBulkCompile.h>
+#include <RECompileProfile.h>
+#include <REExceptions.h>
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+namespace {
+
+/* Rethrown so that the test can check the exact type */
+void rethrow(const RE::CompiledPattern& compiled) {
+    std::rethrow_exception(compiled.error);
+}
+
+} // namespace
+
+TEST(RETest, Bulk_SameAsOneByOne) {
+    std::vector<std::string> patterns;
+    for (auto i = 0; i < 200; i++) {
+        patterns.push_back("id" + std::to_string(i) + "(-[a-z]+)*|[0-9]{" + std::to_string(i % 5 + 1) + "}x");
+    }
+    const std::vector<std::string_view> views(patterns.begin(), patterns.end());
+    const auto compilation = RE::compileAll(views, RE::REParser::NONE, 4u);
+    ASSERT_EQ(compilation.patterns.size(), patterns.size());
+    EXPECT_EQ(compilation.numErrors, 0u);
+    EXPECT_EQ(compilation.numThreads, 4u);
+    EXPECT_GT(compilation.wallMicroseconds, 0.0);
+    EXPECT_GT(compilation.summedMicroseconds, 0.0);
+
+    for (size_t i = 0u; i < patterns.size(); i++) {
+        const auto& parser = compilation.patterns[i].parser;
+        ASSERT_NE(parser, nullptr);
+        EXPECT_EQ(compilation.patterns[i].error, nullptr);
+        const auto id = "id" + std::to_string(i);
+        EXPECT_TRUE(parser->matchExact(id + "-foo-bar")) << patterns[i];
+        EXPECT_FALSE(parser->matchExact(id + "-")) << patterns[i];
+        EXPECT_TRUE(parser->matchExact(std::string(i % 5 + 1, '7') + "x")) << patterns[i];
+        EXPECT_EQ(parser->find("an " + id + "-x here"), 3) << patterns[i];
+    }
+}
+
+TEST(RETest, Bulk_Errors) {
+    const auto compilation = RE::compileAll({"a(b", "ab+", "*", "[z-a]", "\\"}, RE::REParser::NONE, 2u);
+    ASSERT_EQ(compilation.patterns.size(), 5u);
+    EXPECT_EQ(compilation.numErrors, 4u);
+    EXPECT_THROW(rethrow(compilation.patterns[0]), RE::MissingParenthsisException);
+    ASSERT_NE(compilation.patterns[1].parser, nullptr);
+    EXPECT_TRUE(compilation.patterns[1].parser->matchExact("abbb"));
+    EXPECT_THROW(rethrow(compilation.patterns[2]), RE::NothingToRepeatException);
+    EXPECT_THROW(rethrow(compilation.patterns[3]), RE::InvalidRangeException);
+    EXPECT_THROW(rethrow(compilation.patterns[4]), RE::REException);
+    for (const auto i : {0, 2, 3, 4}) {
+        EXPECT_EQ(compilation.patterns[i].parser, nullptr);
+    }
+}
+
+TEST(RETest, Bulk_Flags) {
+    const auto compilation = RE::compileAll(
+        {"héllo", "[a-c]+"},
+        RE::REParser::UTF8 | RE::REParser::CASE_INSENSITIVE | RE::REParser::PARALLEL_DETERMINIZATION);
+    ASSERT_EQ(compilation.numErrors, 0u);
+    EXPECT_TRUE(compilation.patterns[0].parser->matchExact("HÉLLO"));
+    EXPECT_TRUE(compilation.patterns[1].parser->matchExact("AbC"));
+}
+
+TEST(RETest, Bulk_FewPatterns) {
+    const auto none = RE::compileAll({}, RE::REParser::NONE, 8u);
+    EXPECT_TRUE(none.patterns.empty());
+    EXPECT_EQ(none.numErrors, 0u);
+    EXPECT_EQ(none.numThreads, 1u);
+
+    // no more threads than patterns
+    const auto one = RE::compileAll({"a|b"}, RE::REParser::NONE, 8u);
+    EXPECT_EQ(one.numThreads, 1u);
+    EXPECT_TRUE(one.patterns[0].parser->matchExact("b"));
+}
+
+TEST(RETest, Bulk_ProfileCompile) {
+    std::vector<RE::CompileProfile::Phase> phases;
+    const auto profile = RE::profileCompile("(a|b)*a(a|b){3}", RE::REParser::NONE,
+                                            [&phases](const RE::CompileProfile::Phase phase) { phases.push_back(phase); });
+    EXPECT_EQ(phases, (std::vector<RE::CompileProfile::Phase>{RE::CompileProfile::PARSE, RE::CompileProfile::NFA,
+                                                              RE::CompileProfile::SUBSETS,
+                                                              RE::CompileProfile::MINIMIZATION}));
+    EXPECT_GT(profile.numNFAStates, 0u);
+    // the last 4 bytes, and the dead state
+    EXPECT_EQ(profile.numMinimizedStates, 17u);
+    EXPECT_GE(profile.numDFAStates + 1u, profile.numMinimizedStates);
+
+    const auto derivatives = RE::profileCompile("(a|b)*a(a|b){3}", RE::REParser::DERIVATIVES);
+    EXPECT_EQ(derivatives.numNFAStates, 0u);
+    EXPECT_EQ(derivatives.numMinimizedStates, 17u);
+    EXPECT_THROW(RE::profileCompile("(a"), RE::REException);
+}
@@ -0,0 +1,90 @@
+#include <RE.h>
+#include <REExceptions.h>
+
+#include <gtest/gtest.h>
+
+#include <string_view>
+
+
+TEST(RETest, NumGroups) {
+    EXPECT_EQ(RE::REParser("abc").numGroups(), 0u);
+    EXPECT_EQ(RE::REParser("(a)(b)").numGroups(), 2u);
+    EXPECT_EQ(RE::REParser("((a)|(b))*").numGroups(), 3u);
+    EXPECT_EQ(RE::REParser(R"(\(a\))").numGroups(), 0u);
+}
+
+TEST(RETest, CanCaptureWithoutGroups) {
+    RE::REParser parser("ab*");
+    RE::REParser::Groups_t groups;
+    EXPECT_TRUE(parser.matchExact("abb", groups));
+    ASSERT_EQ(groups.size(), 1u);
+    EXPECT_EQ(groups[0], "abb");
+    EXPECT_FALSE(parser.matchExact("ba", groups));
+}
+
+TEST(RETest, CanCaptureGroups_1) {
+    RE::REParser parser(R"((\d+)-(\d+))");
+    RE::REParser::Groups_t groups;
+    const std::string_view str = "2021-1024";
+    ASSERT_TRUE(parser.matchExact(str, groups));
+    ASSERT_EQ(groups.size(), 3u);
+    EXPECT_EQ(groups[0], "2021-1024");
+    EXPECT_EQ(groups[1], "2021");
+    EXPECT_EQ(groups[2], "1024");
+    // zero-copy: spans point into the input
+    EXPECT_EQ(groups[2].data(), str.data() + 5);
+
+    EXPECT_FALSE(parser.matchExact("2021-", groups));
+}
+
+TEST(RETest, CanCaptureGroups_Nested) {
+    RE::REParser parser("((a+)(b+))c");
+    RE::REParser::Groups_t groups;
+    ASSERT_TRUE(parser.matchExact("aabbbc", groups));
+    ASSERT_EQ(groups.size(), 4u);
+    EXPECT_EQ(groups[1], "aabbb");
+    EXPECT_EQ(groups[2], "aa");
+    EXPECT_EQ(groups[3], "bbb");
+}
+
+TEST(RETest, CanCaptureGroups_Unmatched) {
+    RE::REParser parser("(a)|(b)");
+    RE::REParser::Groups_t groups;
+    ASSERT_TRUE(parser.matchExact("b", groups));
+    ASSERT_EQ(groups.size(), 3u);
+    EXPECT_EQ(groups[1].data(), nullptr);
+    EXPECT_EQ(groups[2], "b");
+
+    ASSERT_TRUE(RE::REParser("(a)*").matchExact("", groups));
+    EXPECT_EQ(groups[1].data(), nullptr);
+
+    ASSERT_TRUE(RE::REParser("x()y").matchExact("xy", groups));
+    ASSERT_NE(groups[1].data(), nullptr);
+    EXPECT_EQ(groups[1], "");
+}
+
+TEST(RETest, CanCaptureGroups_LastIteration) {
+    RE::REParser::Groups_t groups;
+    ASSERT_TRUE(RE::REParser("(ab)*").matchExact("ababab", groups));
+    EXPECT_EQ(groups[1], "ab");
+    EXPECT_EQ(groups[1].data() - groups[0].data(), 4);
+
+    ASSERT_TRUE(RE::REParser("(a|b){3}").matchExact("aab", groups));
+    EXPECT_EQ(groups[1], "b");
+}
+
+TEST(RETest, CanCaptureGroups_LeftmostLongest) {
+    RE::REParser::Groups_t groups;
+    ASSERT_TRUE(RE::REParser("(a*)(a*)").matchExact("aaa", groups));
+    EXPECT_EQ(groups[1], "aaa");
+    EXPECT_EQ(groups[2], "");
+
+    ASSERT_TRUE(RE::REParser("(a|ab)(c|bcd)(d*)").matchExact("abcd", groups));
+    EXPECT_EQ(groups[1], "ab");
+    EXPECT_EQ(groups[2], "c");
+    EXPECT_EQ(groups[3], "d");
+
+    ASSERT_TRUE(RE::REParser("(a+)(a)").matchExact("aaaa", groups));
+    EXPECT_EQ(groups[1], "aaa");
+    EXPECT_EQ(groups[2], "a");
+}
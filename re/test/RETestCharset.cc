@@ -0,0 +1,203 @@
+#include <RE.h>
+#include <REExceptions.h>
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+using namespace std::string_literals;
+
+
+TEST(RETest, BracketExceptions) {
+    EXPECT_THROW(RE::REParser("["), RE::MissingBracketException);
+    EXPECT_THROW(RE::REParser("[a-z"), RE::MissingBracketException);
+    EXPECT_THROW(RE::REParser("[]"), RE::MissingBracketException);
+    EXPECT_THROW(RE::REParser("[^]"), RE::MissingBracketException);
+    EXPECT_THROW(RE::REParser("a]"), RE::UnbalancedBracketException);
+    EXPECT_THROW(RE::REParser("[z-a]"), RE::InvalidRangeException);
+    EXPECT_THROW(RE::REParser(R"([\d-z])"), RE::InvalidRangeException);
+    EXPECT_THROW(RE::REParser(R"([\q])"), RE::EscapeException);
+    EXPECT_THROW(RE::REParser(R"(\xg0)"), RE::EscapeException);
+    EXPECT_THROW(RE::REParser(R"(\x0)"), RE::EscapeException);
+    EXPECT_THROW(RE::REParser("[a]*{2}"), RE::MultipleRepeatException);
+}
+
+TEST(RETest, CanParseAndMatchBrackets_1) {
+    RE::REParser parser("[abc]");
+    EXPECT_TRUE(parser.matchExact("a"));
+    EXPECT_TRUE(parser.matchExact("b"));
+    EXPECT_TRUE(parser.matchExact("c"));
+
+    EXPECT_FALSE(parser.matchExact(""));
+    EXPECT_FALSE(parser.matchExact("d"));
+    EXPECT_FALSE(parser.matchExact("ab"));
+    EXPECT_FALSE(parser.matchExact("[abc]"));
+}
+
+TEST(RETest, CanParseAndMatchBrackets_Ranges) {
+    RE::REParser parser("[a-z_][a-z0-9_]*");
+    EXPECT_TRUE(parser.matchExact("alan_turing"));
+    EXPECT_TRUE(parser.matchExact("_1"));
+    EXPECT_TRUE(parser.matchExact("x86_64"));
+
+    EXPECT_FALSE(parser.matchExact("1a"));
+    EXPECT_FALSE(parser.matchExact("Alan"));
+    EXPECT_FALSE(parser.matchExact("a-b"));
+
+    EXPECT_TRUE(RE::REParser("[a-]+").matchExact("-a-"));
+    EXPECT_TRUE(RE::REParser("[-a]+").matchExact("-a-"));
+    EXPECT_TRUE(RE::REParser("[]a]+").matchExact("]a]"));
+    EXPECT_TRUE(RE::REParser(R"([\]\-]+)").matchExact("]-"));
+    EXPECT_TRUE(RE::REParser("[(|)*+?.{}]+").matchExact("(|)*+?.{}"));
+    EXPECT_FALSE(RE::REParser("[(|)*+?.{}]+").matchExact("a"));
+}
+
+TEST(RETest, CanParseAndMatchBrackets_Negated) {
+    RE::REParser parser(R"("[^"]*")");
+    EXPECT_TRUE(parser.matchExact(R"("")"));
+    EXPECT_TRUE(parser.matchExact(R"("hello, world")"));
+    EXPECT_TRUE(parser.matchExact("\"\0\xff\n\""s));
+
+    EXPECT_FALSE(parser.matchExact(R"("a"b")"));
+    EXPECT_FALSE(parser.matchExact(R"("a)"));
+
+    EXPECT_TRUE(RE::REParser("[^^]").matchExact("a"));
+    EXPECT_FALSE(RE::REParser("[^^]").matchExact("^"));
+    EXPECT_TRUE(RE::REParser("[a^]+").matchExact("^a"));
+}
+
+TEST(RETest, CanParseAndMatchBrackets_Escapes) {
+    RE::REParser parser(R"([\d\s]+)");
+    EXPECT_TRUE(parser.matchExact("1 2\t3\n"));
+    EXPECT_FALSE(parser.matchExact("1 a"));
+
+    RE::REParser hex(R"([\x00-\x1f\x7f]+)");
+    EXPECT_TRUE(hex.matchExact("\0\x01\x1f\x7f"s));
+    EXPECT_FALSE(hex.matchExact(" "));
+    EXPECT_FALSE(hex.matchExact("\x80"));
+}
+
+TEST(RETest, CanParseAndMatchDot) {
+    RE::REParser parser("a.c");
+    EXPECT_TRUE(parser.matchExact("abc"));
+    EXPECT_TRUE(parser.matchExact("a.c"));
+    EXPECT_TRUE(parser.matchExact("a\0c"s));
+    EXPECT_TRUE(parser.matchExact("a\xff" "c"));
+
+    EXPECT_FALSE(parser.matchExact("a\nc"));
+    EXPECT_FALSE(parser.matchExact("ac"));
+    EXPECT_FALSE(parser.matchExact("abbc"));
+
+    EXPECT_TRUE(RE::REParser(R"(a\.c)").matchExact("a.c"));
+    EXPECT_FALSE(RE::REParser(R"(a\.c)").matchExact("abc"));
+    EXPECT_TRUE(RE::REParser(".*ERROR.*").matchExact("2021-01-01 ERROR: disk full"));
+}
+
+TEST(RETest, CanParseAndMatchClassEscapes) {
+    RE::REParser word(R"(\w+)");
+    EXPECT_TRUE(word.matchExact("Alan_Turing1912"));
+    EXPECT_FALSE(word.matchExact("alan turing"));
+    EXPECT_FALSE(word.matchExact("a-b"));
+
+    RE::REParser nonWord(R"(\W+)");
+    EXPECT_TRUE(nonWord.matchExact(" -+\n\x80"));
+    EXPECT_FALSE(nonWord.matchExact("a"));
+
+    RE::REParser space(R"(\s+)");
+    EXPECT_TRUE(space.matchExact(" \t\n\r\f\v"));
+    EXPECT_FALSE(space.matchExact(" a "));
+
+    RE::REParser nonSpace(R"(\S+)");
+    EXPECT_TRUE(nonSpace.matchExact("abc"));
+    EXPECT_FALSE(nonSpace.matchExact("a c"));
+
+    EXPECT_TRUE(RE::REParser(R"(\f\v)").matchExact("\f\v"));
+}
+
+TEST(RETest, CanParseAndMatchFullByteRange) {
+    RE::REParser parser(R"([\x00-\xff]*)");
+    std::string allBytes;
+    for (auto byte = 0; byte < 256; byte++) {
+        allBytes.push_back(static_cast<char>(byte));
+    }
+    EXPECT_TRUE(parser.matchExact(allBytes));
+
+    RE::REParser nul("a\0b"s);
+    EXPECT_TRUE(nul.matchExact("a\0b"s));
+    EXPECT_FALSE(nul.matchExact("ab"));
+    EXPECT_FALSE(nul.matchExact("a"));
+
+    RE::REParser nulEscape(R"(\x00+)");
+    EXPECT_TRUE(nulEscape.matchExact("\0\0"s));
+    EXPECT_FALSE(nulEscape.matchExact(""));
+
+    EXPECT_TRUE(RE::REParser(R"(\xFF\xfe)").matchExact("\xff\xfe"));
+}
+
+TEST(RETest, CanParseAndMatchGeneralRE_EmailAddressWithClasses) {
+    RE::REParser parser(R"([_a-z]+@(gmail|yahoo|hotmail)\.com)");
+    EXPECT_TRUE(parser.matchExact("alan_turing@gmail.com"));
+    EXPECT_TRUE(parser.matchExact("__admin__@hotmail.com"));
+
+    EXPECT_FALSE(parser.matchExact("alan.turing@gmail.com"));
+    EXPECT_FALSE(parser.matchExact("alan_turing@gmail_com"));
+    EXPECT_FALSE(parser.matchExact("@gmail.com"));
+}
+
+TEST(RETest, CanCaptureGroupsWithClasses) {
+    RE::REParser parser(R"(([^=]+)=(.*))");
+    RE::REParser::Groups_t groups;
+    ASSERT_TRUE(parser.matchExact("key=va=lue", groups));
+    EXPECT_EQ(groups[1], "key");
+    EXPECT_EQ(groups[2], "va=lue");
+}
+
+TEST(RETest, CanParseAndMatchCaseInsensitive) {
+    RE::REParser parser("content-type: [a-z]+/json", RE::REParser::CASE_INSENSITIVE);
+    EXPECT_TRUE(parser.matchExact("content-type: application/json"));
+    EXPECT_TRUE(parser.matchExact("Content-Type: Application/JSON"));
+    EXPECT_TRUE(parser.matchExact("CONTENT-TYPE: APPLICATION/JSON"));
+
+    EXPECT_FALSE(parser.matchExact("content_type: application/json"));
+    EXPECT_FALSE(parser.matchExact("content-type: app1ication/json"));
+
+    EXPECT_FALSE(RE::REParser("select").matchExact("SELECT"));
+    EXPECT_TRUE(RE::REParser("select|from", RE::REParser::CASE_INSENSITIVE).matchExact("FrOm"));
+    EXPECT_TRUE(RE::REParser("[A-C]+", RE::REParser::CASE_INSENSITIVE).matchExact("aBc"));
+    EXPECT_TRUE(RE::REParser(R"(\x41)", RE::REParser::CASE_INSENSITIVE).matchExact("a"));
+}
+
+TEST(RETest, CanParseAndMatchCaseInsensitiveNegated) {
+    RE::REParser parser("[^a]+", RE::REParser::CASE_INSENSITIVE);
+    EXPECT_TRUE(parser.matchExact("bcd"));
+    EXPECT_FALSE(parser.matchExact("bAd"));
+    EXPECT_FALSE(parser.matchExact("bad"));
+
+    RE::REParser word(R"(\W)", RE::REParser::CASE_INSENSITIVE);
+    EXPECT_TRUE(word.matchExact("-"));
+    EXPECT_FALSE(word.matchExact("A"));
+    EXPECT_FALSE(word.matchExact("a"));
+}
+
+TEST(RETest, CanParseAndMatchCaseInsensitiveUTF8) {
+    const auto flags = RE::REParser::UTF8 | RE::REParser::CASE_INSENSITIVE;
+    RE::REParser parser("straße|привет|αβγ", flags);
+    EXPECT_TRUE(parser.matchExact("STRAßE"));
+    EXPECT_TRUE(parser.matchExact("ПРИВЕТ"));
+    EXPECT_TRUE(parser.matchExact("Привет"));
+    EXPECT_TRUE(parser.matchExact("ΑΒΓ"));
+    EXPECT_FALSE(parser.matchExact("STRASSE"));
+
+    EXPECT_TRUE(RE::REParser("é", flags).matchExact("É"));
+    EXPECT_TRUE(RE::REParser("[à-þ]+", flags).matchExact("ÀÉÎ"));
+    // without the UTF-8 mode only ASCII letters are folded
+    EXPECT_FALSE(RE::REParser("é", RE::REParser::CASE_INSENSITIVE).matchExact("É"));
+}
+
+TEST(RETest, CanCaptureGroupsCaseInsensitive) {
+    RE::REParser parser("(get|post) (/[a-z]*)", RE::REParser::CASE_INSENSITIVE);
+    RE::REParser::Groups_t groups;
+    ASSERT_TRUE(parser.matchExact("GET /Index", groups));
+    EXPECT_EQ(groups[1], "GET");
+    EXPECT_EQ(groups[2], "/Index");
+}
@@ -0,0 +1,77 @@
+#include <RE.h>
+#include <RECompileProfile.h>
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+namespace {
+
+/* All the strings over the alphabet of at most maxLength characters */
+std::vector<std::string> allStrings(const std::string& alphabet, const size_t maxLength) {
+    std::vector<std::string> strings{""};
+    for (size_t i = 0u; i < strings.size(); i++) {
+        if (strings[i].size() < maxLength) {
+            for (const char c : alphabet) {
+                strings.push_back(strings[i] + c);
+            }
+        }
+    }
+    return strings;
+}
+
+void expectSameLanguage(const std::string& re, const uint32_t flags, const std::vector<std::string>& strings) {
+    RE::REParser thompson(re, flags);
+    RE::REParser derivatives(re, flags | RE::REParser::DERIVATIVES);
+    for (const auto& str : strings) {
+        EXPECT_EQ(derivatives.matchExact(str), thompson.matchExact(str)) << re << " on " << str;
+        std::string_view expected, match;
+        EXPECT_EQ(derivatives.find(str, match), thompson.find(str, expected)) << re << " on " << str;
+        EXPECT_EQ(match.size(), expected.size()) << re << " on " << str;
+    }
+}
+
+} // namespace
+
+TEST(RETest, Derivatives_SameLanguage) {
+    const auto strings = allStrings("abc", 6u);
+    for (const auto re : {"", "a", "abc", "a*", "(a|b)*abb", "(a|ab)(c|bcd)?", "((a*)*b)*", "(a?){3}b",
+                          "[ab]{3}c", "(|a)(b|)", "(a|b)*a(a|b){2}", "a+b+|b+a+", "(ab|a)*(ba|b)*", ".*c.*"}) {
+        expectSameLanguage(re, RE::REParser::NONE, strings);
+    }
+}
+
+TEST(RETest, Derivatives_Flags) {
+    expectSameLanguage("[a-c]+x|ABX", RE::REParser::CASE_INSENSITIVE, allStrings("abAxX", 5u));
+    expectSameLanguage("[α-γ]+|ω.", RE::REParser::UTF8, {"", "α", "αβγ", "αδ", "ωa", "ωω", "ω", "\xce", "\xce\xb1\xb1"});
+    RE::REParser derivatives("\\w+@\\w+\\.(com|org)", RE::REParser::DERIVATIVES);
+    EXPECT_TRUE(derivatives.matchExact("user@host.org"));
+    EXPECT_FALSE(derivatives.matchExact("user@host.net"));
+}
+
+TEST(RETest, Derivatives_Groups) {
+    RE::REParser derivatives("(a+)(b*)", RE::REParser::DERIVATIVES);
+    RE::REParser::Groups_t groups;
+    EXPECT_TRUE(derivatives.matchExact("aabbb", groups));
+    EXPECT_EQ(groups, (RE::REParser::Groups_t{"aabbb", "aa", "bbb"}));
+    EXPECT_FALSE(derivatives.matchExact("ba", groups));
+}
+
+TEST(RETest, Derivatives_NearMinimal) {
+    // the normalization identifies the derivatives of these as the minimizer does
+    for (const auto re : {"(a|b)*abb", "(a|b)*a(a|b){4}", "abc|abd|xyz", "[0-9]+(\\.[0-9]+)?"}) {
+        EXPECT_EQ(RE::REParser(re, RE::REParser::DERIVATIVES).tableSize(), RE::REParser(re).tableSize()) << re;
+    }
+    EXPECT_TRUE(RE::REParser("a[^\\x00-\\xff]b", RE::REParser::DERIVATIVES).isEmpty());
+}
+
+/* Nested counted repetitions, whose derivatives differ while matching the same */
+TEST(RETest, Derivatives_Minimized) {
+    const auto re = R"(b{2}((([^a]a)[ab](a)?)?((.{2}[ab]?){2}(.b{2}b{2})+b))*)";
+    const auto profile = RE::profileCompile(re, RE::REParser::DERIVATIVES);
+    EXPECT_GT(profile.numDFAStates, 3u * profile.numMinimizedStates);
+    EXPECT_EQ(profile.numMinimizedStates, 294u);
+    EXPECT_LE(profile.numMinimizedStates, RE::profileCompile(re).numMinimizedStates);
+    expectSameLanguage(re, RE::REParser::NONE, allStrings("ab\n", 7u));
+}
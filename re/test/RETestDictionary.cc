@@ -0,0 +1,84 @@
+#include <RE.h>
+#include <RECompileProfile.h>
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+TEST(RETest, Dictionary_Minimal) {
+    // tap and top share their states, as do the ones after p
+    const auto profile = RE::profileCompile("tap|taps|top|tops");
+    EXPECT_EQ(profile.numNFAStates, 0u);
+    EXPECT_EQ(profile.numMinimizedStates, 6u);
+    EXPECT_EQ(RE::profileCompile("ab|cb|db").numMinimizedStates, 4u);
+
+    RE::REParser parser("tap|taps|top|tops");
+    for (const auto word : {"tap", "taps", "top", "tops"}) {
+        EXPECT_TRUE(parser.matchExact(word)) << word;
+    }
+    for (const auto word : {"", "t", "ta", "tip", "tapss", "tos"}) {
+        EXPECT_FALSE(parser.matchExact(word)) << word;
+    }
+}
+
+TEST(RETest, Dictionary_Words) {
+    // duplicates, the empty word, and a prefix of another word
+    RE::REParser parser("ab|a||ab|abc");
+    for (const auto word : {"", "a", "ab", "abc"}) {
+        EXPECT_TRUE(parser.matchExact(word)) << word;
+    }
+    EXPECT_FALSE(parser.matchExact("b"));
+    EXPECT_FALSE(parser.matchExact("abcd"));
+
+    RE::REParser escaped("a\\.b|\\x41|\\|");
+    EXPECT_TRUE(escaped.matchExact("a.b"));
+    EXPECT_TRUE(escaped.matchExact("A"));
+    EXPECT_TRUE(escaped.matchExact("|"));
+    EXPECT_FALSE(escaped.matchExact("axb"));
+
+    RE::REParser utf8("αβ|γ|ωmega", RE::REParser::UTF8);
+    EXPECT_TRUE(utf8.matchExact("αβ"));
+    EXPECT_TRUE(utf8.matchExact("ωmega"));
+    EXPECT_FALSE(utf8.matchExact("α"));
+    EXPECT_EQ(RE::profileCompile("αβ|γ", RE::REParser::UTF8).numNFAStates, 0u);
+}
+
+TEST(RETest, Dictionary_NotLiterals) {
+    // classes, repetitions and case folding take the NFA
+    for (const auto& [re, flags] : {std::make_pair("ab|c[de]", RE::REParser::NONE),
+                                    std::make_pair("ab|c*", RE::REParser::NONE),
+                                    std::make_pair("ab|cd", RE::REParser::CASE_INSENSITIVE),
+                                    std::make_pair("abc", RE::REParser::NONE)}) {
+        EXPECT_GT(RE::profileCompile(re, flags).numNFAStates, 0u) << re;
+    }
+    RE::REParser folded("ab|cd", RE::REParser::CASE_INSENSITIVE);
+    EXPECT_TRUE(folded.matchExact("Cd"));
+}
+
+TEST(RETest, Dictionary_Groups) {
+    RE::REParser parser("(get|put)|(delete)");
+    EXPECT_EQ(RE::profileCompile("(get|put)|(delete)").numNFAStates, 0u);
+    RE::REParser::Groups_t groups;
+    EXPECT_TRUE(parser.matchExact("put", groups));
+    EXPECT_EQ(groups[1], "put");
+    EXPECT_EQ(groups[2].data(), nullptr);
+    std::string_view match;
+    EXPECT_EQ(parser.find("undelete it", match), 2);
+    EXPECT_EQ(match, "delete");
+}
+
+TEST(RETest, Dictionary_Large) {
+    std::vector<std::string> words;
+    std::string re;
+    for (auto i = 0; i < 5000; i++) {
+        words.push_back("w" + std::to_string(i * 7919 % 100003));
+        re += (i == 0 ? "" : "|") + words.back();
+    }
+    RE::REParser parser(re);
+    for (const auto& word : words) {
+        EXPECT_TRUE(parser.matchExact(word));
+        EXPECT_FALSE(parser.matchExact(word + "_"));
+        EXPECT_FALSE(parser.matchExact(word.substr(1u)));
+    }
+}
@@ -31,7 +31,8 @@ TEST_P(RETestEscape, CanPArserAndMatchSingleEscapes) {
 }
 
 INSTANTIATE_TEST_SUITE_P(TestEscape, RETestEscape,
-                         Values('(', ')', '{', '}', '|', '*', '+', '?', '\\'));
+                         Values('(', ')', '{', '}', '[', ']', '|', '*', '+', '?',
+                                '.', '^', '-', '\\'));
 
 TEST(RETest, CanParseAndMatchEscapes_RegexReserved) {
     EXPECT_TRUE(RE::REParser(R"(\++)").matchExact("+"));
@@ -91,16 +92,18 @@ TEST(RETest, CanParseAndMatchDigits_1) {
 TEST(RETest, CanParseAndMatchDigits_2) {
     RE::REParser parser(R"(\D*)");
     EXPECT_TRUE(parser.matchExact(""));
-    EXPECT_TRUE(parser.matchExact("0"));
-    EXPECT_TRUE(parser.matchExact("100"));
-    EXPECT_TRUE(parser.matchExact("0123456789"));
+    EXPECT_TRUE(parser.matchExact("abc"));
+    EXPECT_TRUE(parser.matchExact("a.b"));
+    EXPECT_TRUE(parser.matchExact(std::string("\0\n", 2u)));
 
+    EXPECT_FALSE(parser.matchExact("0"));
+    EXPECT_FALSE(parser.matchExact("100"));
     EXPECT_FALSE(parser.matchExact("0.5"));
-    EXPECT_FALSE(parser.matchExact("0a1"));
+    EXPECT_FALSE(parser.matchExact("a1b"));
 }
 
 TEST(RETest, CanParseAndMatchDigits_3) {  // TODO match real-life numerics
-    RE::REParser parser(R"(-?\d+.?\D*)");  // TODO . is wildcard
+    RE::REParser parser(R"(-?\d+\.?\d*)");
     EXPECT_TRUE(parser.matchExact("0"));
     EXPECT_TRUE(parser.matchExact("0.3423"));
     EXPECT_TRUE(parser.matchExact("0000.3423"));
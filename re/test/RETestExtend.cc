@@ -0,0 +1,144 @@
+#include <RE.h>
+#include <REExceptions.h>
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+/* All the strings over abc of at most 6 characters */
+std::vector<std::string> allStrings() {
+    std::vector<std::string> strings{""};
+    for (size_t i = 0u; i < strings.size(); i++) {
+        if (strings[i].size() < 6u) {
+            for (const char c : {'a', 'b', 'c'}) {
+                strings.push_back(strings[i] + c);
+            }
+        }
+    }
+    return strings;
+}
+
+} // namespace
+
+TEST(RETest, Extend_SameAsAlternation) {
+    const auto strings = allStrings();
+    const std::vector<std::pair<std::string, std::vector<std::string>>> cases = {
+        {"abc", {"abd", "ab", "c*"}},
+        {"[ab]*abb", {"cc", "(ab)+", "b*"}},
+        {"a+b", {"a+b", "a", ""}},
+        {"[ab]{3}", {"c[ab]c", "a.*c"}},
+    };
+    for (const auto& [re, alternatives] : cases) {
+        RE::REParser extended(re);
+        auto alternation = re;
+        for (const auto& alternative : alternatives) {
+            extended.addAlternative(alternative);
+            alternation += "|" + alternative;
+            RE::REParser expected(alternation);
+            for (const auto& str : strings) {
+                EXPECT_EQ(extended.matchExact(str), expected.matchExact(str)) << alternation << " on " << str;
+                std::string_view match, expectedMatch;
+                EXPECT_EQ(extended.find(str, match), expected.find(str, expectedMatch)) << alternation << " on " << str;
+                EXPECT_EQ(match.size(), expectedMatch.size()) << alternation << " on " << str;
+            }
+        }
+    }
+}
+
+TEST(RETest, Extend_ReusesStates) {
+    // nothing new: the DFA is the same
+    RE::REParser parser("foo|bar|baz");
+    const auto tableSize = parser.tableSize();
+    parser.addAlternative("ba[rz]");
+    EXPECT_EQ(parser.tableSize(), tableSize);
+
+    // the suffixes shared with the existing words are merged
+    RE::REParser words("cat|cats|dog");
+    words.addAlternative("dogs");
+    EXPECT_EQ(words.tableSize(), RE::REParser("cat|cats|dog|dogs").tableSize());
+    EXPECT_TRUE(words.matchExact("dogs"));
+    EXPECT_FALSE(words.matchExact("dogss"));
+}
+
+TEST(RETest, Extend_Blocklist) {
+    std::vector<std::string> entries;
+    std::string re;
+    for (auto i = 0; i < 300; i++) {
+        entries.push_back("host" + std::to_string(i * 7919 % 10007) + "\\.example\\.com");
+        re += (i == 0 ? "" : "|") + entries.back();
+    }
+    RE::REParser blocklist(re);
+    for (auto i = 0; i < 20; i++) {
+        blocklist.addAlternative("[a-z]+" + std::to_string(i) + "\\.evil\\.org");
+    }
+    EXPECT_TRUE(blocklist.matchExact("host7919.example.com"));
+    EXPECT_TRUE(blocklist.matchExact("abc19.evil.org"));
+    EXPECT_FALSE(blocklist.matchExact("abc20.evil.org"));
+    std::string_view match;
+    EXPECT_EQ(blocklist.find("see x7.evil.org now", match), 4);
+    EXPECT_EQ(match, "x7.evil.org");
+}
+
+/* Enough states for the rows added to be appended to the table, until it has doubled and is built again */
+TEST(RETest, Extend_ManyWords) {
+    std::mt19937 random(47u);
+    std::vector<std::string> words;
+    for (auto i = 0; i < 3000; i++) {
+        std::string word;
+        for (auto length = 5u + random() % 8u; length > 0u; length--) {
+            word += static_cast<char>('a' + random() % 26u);
+        }
+        words.push_back(word);
+    }
+    std::string re;
+    for (auto i = 0; i < 1000; i++) {
+        re += (re.empty() ? "" : "|") + words[i];
+    }
+    RE::REParser extended(re);
+    std::string text;
+    for (size_t i = 1000u; i < words.size(); i++) {
+        extended.addAlternative(words[i]);
+        re += "|" + words[i];
+        text += words[i - 1000u] + (i % 2u == 0u ? " " : "");
+    }
+    const RE::REParser expected(re);
+    for (const auto& word : words) {
+        for (const auto& str : {word, word.substr(1u), word + "e"}) {
+            EXPECT_EQ(extended.matchExact(str), expected.matchExact(str)) << str;
+        }
+    }
+    for (size_t pos = 0u; pos < text.size(); pos += 97u) {
+        const auto str = std::string_view(text).substr(pos);
+        std::string_view match, expectedMatch;
+        EXPECT_EQ(extended.find(str, match), expected.find(str, expectedMatch));
+        EXPECT_EQ(match, expectedMatch);
+    }
+}
+
+TEST(RETest, Extend_Flags) {
+    RE::REParser parser("αβ", RE::REParser::UTF8 | RE::REParser::CASE_INSENSITIVE);
+    parser.addAlternative("[γ-ε]x");
+    EXPECT_TRUE(parser.matchExact("αβ"));
+    EXPECT_TRUE(parser.matchExact("δX"));
+    EXPECT_FALSE(parser.matchExact("ωx"));
+
+    RE::REParser empty = RE::REParser::intersectionOf(RE::REParser("a"), RE::REParser("b"));
+    empty.addAlternative("c");
+    EXPECT_FALSE(empty.isEmpty());
+    EXPECT_TRUE(empty.matchExact("c"));
+}
+
+TEST(RETest, Extend_Groups) {
+    RE::REParser parser("(a)b");
+    EXPECT_THROW(parser.addAlternative("c"), RE::AlternativeToGroupsException);
+    EXPECT_TRUE(parser.matchExact("ab"));
+    // the groups of the alternative are ignored
+    RE::REParser noGroups("ab");
+    noGroups.addAlternative("(c)d");
+    EXPECT_EQ(noGroups.numGroups(), 0u);
+    EXPECT_TRUE(noGroups.matchExact("cd"));
+}
@@ -0,0 +1,193 @@
+#include <RE.h>
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std::string_literals;
+
+
+namespace {
+
+/* The leftmost-longest match by trying every substring, or (-1, -1) */
+std::pair<int32_t, int32_t> findBruteForce(const RE::REParser& parser, const std::string& str) {
+    for (size_t start = 0u; start <= str.size(); start++) {
+        for (size_t end = str.size() + 1; end-- > start; ) {
+            if (parser.matchExact(std::string_view(str).substr(start, end - start))) {
+                return {start, end};
+            }
+        }
+    }
+    return {-1, -1};
+}
+
+void expectSameAsBruteForce(const char* re, const std::vector<std::string>& strs) {
+    RE::REParser parser(re);
+    for (const auto& str : strs) {
+        std::string_view match;
+        const auto [start, end] = findBruteForce(parser, str);
+        EXPECT_EQ(parser.find(str, match), start) << re << " in " << str;
+        if (start >= 0) {
+            EXPECT_EQ(match, str.substr(start, end - start)) << re << " in " << str;
+        }
+    }
+}
+
+} // namespace
+
+TEST(RETest, Find_Basic) {
+    RE::REParser parser("b+");
+    std::string_view match;
+    EXPECT_EQ(parser.find("aabbbc", match), 2);
+    EXPECT_EQ(match, "bbb");
+    EXPECT_EQ(parser.find("aac"), -1);
+    EXPECT_EQ(parser.find(""), -1);
+}
+
+TEST(RETest, Find_Empty) {
+    RE::REParser parser("a*");
+    std::string_view match;
+    EXPECT_EQ(parser.find("bba", match), 0);
+    EXPECT_EQ(match, "");
+    EXPECT_EQ(parser.find("", match), 0);
+    EXPECT_EQ(parser.find("aab", match), 0);
+    EXPECT_EQ(match, "aa");
+}
+
+TEST(RETest, Find_LeftmostLongest) {
+    RE::REParser parser("a|ab|abc");
+    std::string_view match;
+    EXPECT_EQ(parser.find("xxabcd", match), 2);
+    EXPECT_EQ(match, "abc");
+}
+
+TEST(RETest, Find_Prefix) {
+    expectSameAsBruteForce(R"(GET /\w+)", {
+        "", "GET", "GET /", "GET /index", "xx GET /a GET /bb", "GET GET /x", "GGET /y"
+    });
+    expectSameAsBruteForce(R"(ab(c|d)*)", {"ab", "aab", "xabcdcx", "acab", "bbb"});
+    expectSameAsBruteForce(R"(ab*c)", {"ac", "abbc", "xabxac", "abab"});
+}
+
+TEST(RETest, Find_ReverseSuffix) {
+    expectSameAsBruteForce(R"(\d+ms)", {
+        "", "ms", "took 12ms", "1m 2ms", "12 ms 345ms", "ms9ms", "1ms2ms"
+    });
+    expectSameAsBruteForce(R"([a-z]+@example\.com)", {
+        "mail bob@example.com now", "@example.com", "a@example.co", "x@y a@example.com"
+    });
+    expectSameAsBruteForce("(foo|bar)baz", {"foobaz", "fobarbaz", "barbaz foobaz", "baz"});
+}
+
+TEST(RETest, Find_ReverseInner) {
+    expectSameAsBruteForce(R"(\d+ ms \w+)", {
+        "", " ms ", "12 ms x", "at 3 ms 4 ms done", "9 ms", "a 1 ms  b 2 ms c"
+    });
+    expectSameAsBruteForce(R"((xy)*z\d)", {"z1", "xyxyz2", "xz3", "yxyz4z", "zz5"});
+}
+
+/* The literal is not at the same place in every match: bms in abmsXms */
+TEST(RETest, Find_LiteralElsewhereInMatch) {
+    expectSameAsBruteForce("bms|abmsXms", {"abmsXms", "abms", "bms", "XabmsXmsms"});
+    expectSameAsBruteForce(R"(\w+x)", {"ab x", "abxcdx", "x", "--"});
+}
+
+TEST(RETest, Find_NoLiteral) {
+    expectSameAsBruteForce(R"([a-c]+\d|x+)", {"", "12 ab3 x", "cc", "xxa1"});
+    expectSameAsBruteForce("(a|b)*c?", {"", "dd", "abcab", "cc"});
+}
+
+/* Runs from several starts alive at once, the leftmost one matching last */
+TEST(RETest, Find_OverlappingRuns) {
+    expectSameAsBruteForce("abcd|c", {"abcd", "abce", "ababcd", "xcabcd"});
+    expectSameAsBruteForce("(a|b)*ab(a|b)", {"aab", "abab", "bbaba", "ba", "abaxaab"});
+    expectSameAsBruteForce(R"(\w*\d|[a-z]+!)", {"ab", "ab!", "a1b!", "xy z9", "!!"});
+}
+
+/* Each byte is read a bounded number of times, however many starts */
+TEST(RETest, Find_LongRuns) {
+    const std::string as(200000u, 'a');
+    std::string_view match;
+    RE::REParser noLiteral("a*[bc]");
+    EXPECT_EQ(noLiteral.find(as), -1);
+    EXPECT_EQ(noLiteral.find(as + "b", match), 0);
+    EXPECT_EQ(match.size(), as.size() + 1u);
+    RE::REParser longest("a*(ab|ac)+[bc]");
+    EXPECT_EQ(longest.find(as), -1);
+    EXPECT_EQ(longest.find(as + "bb", match), 0);
+    EXPECT_EQ(match.size(), as.size() + 2u);
+
+    std::string axs;
+    for (auto i = 0; i < 100000; i++) {
+        axs += "ax";
+    }
+    RE::REParser reverseInner(R"([a-z]+x\d)");
+    EXPECT_EQ(reverseInner.find(axs), -1);
+    EXPECT_EQ(reverseInner.find(axs + "1", match), 0);
+    EXPECT_EQ(match.size(), axs.size() + 1u);
+}
+
+TEST(RETest, Find_CaseInsensitive) {
+    RE::REParser parser("error: \\w+", RE::REParser::CASE_INSENSITIVE);
+    std::string_view match;
+    EXPECT_EQ(parser.find("[12:00] ERROR: disk", match), 8);
+    EXPECT_EQ(match, "ERROR: disk");
+}
+
+TEST(RETest, Find_NoMatchPossible) {
+    RE::REParser parser("[^\\x00-\\xff]");
+    EXPECT_EQ(parser.find("abc"), -1);
+}
+
+namespace {
+
+std::vector<std::string_view> findAll(const RE::REParser& parser, std::string_view str) {
+    std::vector<std::string_view> matches;
+    for (const auto match : parser.findAll(str)) {
+        matches.push_back(match);
+    }
+    return matches;
+}
+
+} // namespace
+
+TEST(RETest, FindAll_Basic) {
+    RE::REParser parser(R"(\d+)");
+    const std::string str = "a1 b22 c333 d";
+    const auto matches = findAll(parser, str);
+    ASSERT_EQ(matches.size(), 3u);
+    EXPECT_EQ(matches[0], "1");
+    EXPECT_EQ(matches[1], "22");
+    EXPECT_EQ(matches[2], "333");
+    /* the spans point into the string */
+    EXPECT_EQ(matches[2].data(), str.data() + 8);
+
+    EXPECT_TRUE(findAll(parser, "abc").empty());
+    EXPECT_TRUE(findAll(parser, "").empty());
+}
+
+TEST(RETest, FindAll_NonOverlapping) {
+    RE::REParser parser("aba");
+    EXPECT_EQ(findAll(parser, "ababababa"), (std::vector<std::string_view>{"aba", "aba"}));
+    RE::REParser adjacent(R"(\w+ms)");
+    EXPECT_EQ(findAll(adjacent, "1ms 2ms3ms"), (std::vector<std::string_view>{"1ms", "2ms3ms"}));
+}
+
+TEST(RETest, FindAll_EmptyMatches) {
+    RE::REParser parser("a*");
+    EXPECT_EQ(findAll(parser, "baac"), (std::vector<std::string_view>{"", "aa", "", ""}));
+    EXPECT_EQ(findAll(parser, ""), (std::vector<std::string_view>{""}));
+}
+
+TEST(RETest, FindAll_Iterator) {
+    RE::REParser parser("[a-z]+@example\\.com");
+    const auto matches = parser.findAll("to: a@example.com, b@example.com; c@example.org");
+    EXPECT_EQ(std::distance(matches.begin(), matches.end()), 2);
+    auto it = matches.begin();
+    EXPECT_EQ(*it++, "a@example.com");
+    EXPECT_EQ(it->size(), 13u);
+    EXPECT_NE(it, matches.end());
+    EXPECT_EQ(++it, matches.end());
+}
@@ -0,0 +1,82 @@
+#include <RE.h>
+#include <REHotSwap.h>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+TEST(RETest, HotSwap_Publish) {
+    RE::REHotSwap handle(std::make_unique<RE::REParser>("a+"));
+    EXPECT_EQ(handle.epoch(), 1u);
+    EXPECT_TRUE(handle.matchExact("aaa"));
+
+    handle.publish(std::make_unique<RE::REParser>("b+"));
+    EXPECT_EQ(handle.epoch(), 2u);
+    EXPECT_FALSE(handle.matchExact("aaa"));
+    std::string_view match;
+    EXPECT_EQ(handle.find("abba", match), 1);
+    EXPECT_EQ(match, "bb");
+    EXPECT_EQ(handle.reclaim(), 0u);
+}
+
+TEST(RETest, HotSwap_SnapshotKeepsParser) {
+    RE::REHotSwap handle(std::make_unique<RE::REParser>("a+"));
+    {
+        auto snapshot = handle.snapshot();
+        handle.publish(std::make_unique<RE::REParser>("b+"));
+        handle.publish(std::make_unique<RE::REParser>("c+"));
+        // both are kept, as they were replaced after the snapshot was taken
+        EXPECT_EQ(handle.reclaim(), 2u);
+        EXPECT_TRUE(snapshot->matchExact("aaa"));
+        EXPECT_TRUE(handle.matchExact("ccc"));
+
+        auto moved = std::move(snapshot);
+        EXPECT_TRUE(moved->matchExact("aaa"));
+        EXPECT_EQ(handle.reclaim(), 2u);
+    }
+    EXPECT_EQ(handle.reclaim(), 0u);
+
+    // a later snapshot holds the parser current in its epoch, not those replaced before it
+    auto older = std::make_unique<RE::REHotSwap::Snapshot>(handle.snapshot());
+    handle.publish(std::make_unique<RE::REParser>("d+"));
+    handle.publish(std::make_unique<RE::REParser>("e+"));
+    EXPECT_EQ(handle.reclaim(), 2u);
+    older.reset();
+    const auto snapshot = handle.snapshot();
+    handle.publish(std::make_unique<RE::REParser>("f+"));
+    EXPECT_EQ(handle.reclaim(), 1u);
+    EXPECT_TRUE(snapshot->matchExact("eee"));
+}
+
+/* Each parser matches exactly one of "aaa" and "bbb", so a reader seeing both or neither read a torn parser */
+TEST(RETest, HotSwap_ConcurrentReloads) {
+    for (const size_t numSlots : {2u, 64u}) {
+        RE::REHotSwap handle(std::make_unique<RE::REParser>("a+"), numSlots);
+        std::atomic<bool> isDone{false};
+        std::atomic<size_t> numInconsistent{0u};
+        std::vector<std::thread> readers;
+        for (int i = 0; i < 6; i++) {
+            readers.emplace_back([&] {
+                while (not isDone.load()) {
+                    const auto snapshot = handle.snapshot();
+                    numInconsistent += snapshot->matchExact("aaa") == snapshot->matchExact("bbb");
+                }
+            });
+        }
+        for (int i = 0; i < 200; i++) {
+            handle.publish(std::make_unique<RE::REParser>(i % 2 == 0 ? "b+" : "a+"));
+        }
+        isDone = true;
+        for (auto& reader : readers) {
+            reader.join();
+        }
+        EXPECT_EQ(numInconsistent.load(), 0u);
+        EXPECT_EQ(handle.epoch(), 201u);
+        EXPECT_EQ(handle.reclaim(), 0u);
+        EXPECT_TRUE(handle.matchExact("aaa"));
+    }
+}
@@ -0,0 +1,93 @@
+#include <RELexer.h>
+#include <REExceptions.h>
+
+#include <gtest/gtest.h>
+
+#include <memory_resource>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+enum Token : RE::RELexer::TokenId_t { IF, NAME, NUMBER, OPERATOR, SPACE };
+
+const std::vector<std::string_view> RULES = {
+    "if",
+    "[a-z_][a-z_0-9]*",
+    "[0-9]+(\\.[0-9]+)?",
+    "==|=|<=|<|\\+",
+    " +",
+};
+
+std::vector<std::pair<RE::RELexer::TokenId_t, std::string_view>> tokenize(
+    const RE::RELexer& lexer, std::string_view str)
+{
+    std::vector<std::pair<RE::RELexer::TokenId_t, std::string_view>> tokens;
+    for (const auto token : lexer.tokenize(str)) {
+        tokens.emplace_back(token.id, token.text);
+    }
+    return tokens;
+}
+
+} // namespace
+
+TEST(RETest, Lexer_MaximalMunch) {
+    RE::RELexer lexer(RULES);
+    const std::vector<std::pair<RE::RELexer::TokenId_t, std::string_view>> expected = {
+        {IF, "if"}, {SPACE, " "}, {NAME, "iffy"}, {SPACE, " "}, {OPERATOR, "<="},
+        {NUMBER, "3.14"}, {OPERATOR, "=="}, {NAME, "x1"}, {OPERATOR, "+"}, {NAME, "i"},
+    };
+    EXPECT_EQ(tokenize(lexer, "if iffy <=3.14==x1+i"), expected);
+}
+
+TEST(RETest, Lexer_RulePriority) {
+    // the first rule matching the longest token names it
+    RE::RELexer lexer({"[a-z]+", "if"});
+    RE::RELexer::Token token;
+    size_t pos = 0u;
+    ASSERT_TRUE(lexer.next("if", pos, token));
+    EXPECT_EQ(token.id, 0u);
+    EXPECT_EQ(pos, 2u);
+    EXPECT_FALSE(lexer.next("if", pos, token));
+}
+
+TEST(RETest, Lexer_UnknownBytes) {
+    RE::RELexer lexer(RULES);
+    const std::vector<std::pair<RE::RELexer::TokenId_t, std::string_view>> expected = {
+        {NAME, "a"}, {RE::RELexer::UNKNOWN, "#"}, {RE::RELexer::UNKNOWN, "#"}, {NUMBER, "1"},
+        {RE::RELexer::UNKNOWN, "."},
+    };
+    // the longest token backs off to the last accepted position
+    EXPECT_EQ(tokenize(lexer, "a##1."), expected);
+    EXPECT_TRUE(tokenize(lexer, "").empty());
+}
+
+TEST(RETest, Lexer_EmptyTokens) {
+    // a rule matching the empty string makes no empty token
+    RE::RELexer lexer({"a*", "b"});
+    const std::vector<std::pair<RE::RELexer::TokenId_t, std::string_view>> expected = {
+        {0u, "aa"}, {1u, "b"}, {RE::RELexer::UNKNOWN, "c"}, {0u, "a"},
+    };
+    EXPECT_EQ(tokenize(lexer, "aabca"), expected);
+    EXPECT_TRUE(tokenize(RE::RELexer({}), "").empty());
+}
+
+TEST(RETest, Lexer_Flags) {
+    RE::RELexer lexer({"select", "[a-z]+", " "}, RE::REParser::CASE_INSENSITIVE);
+    const std::vector<std::pair<RE::RELexer::TokenId_t, std::string_view>> expected = {
+        {0u, "SELECT"}, {2u, " "}, {1u, "Name"},
+    };
+    EXPECT_EQ(tokenize(lexer, "SELECT Name"), expected);
+}
+
+TEST(RETest, Lexer_CompileResource) {
+    std::pmr::unsynchronized_pool_resource pool;
+    RE::RELexer lexer(RULES, RE::REParser::NONE, &pool);
+    EXPECT_EQ(tokenize(lexer, "if x1 <= 2.5"), tokenize(RE::RELexer(RULES), "if x1 <= 2.5"));
+}
+
+TEST(RETest, Lexer_Exceptions) {
+    EXPECT_THROW(RE::RELexer({"a", "(b"}), RE::MissingParenthsisException);
+    EXPECT_THROW(RE::RELexer({"*"}), RE::NothingToRepeatException);
+}
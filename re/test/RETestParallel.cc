@@ -0,0 +1,71 @@
+#include <RE.h>
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+using namespace std::string_literals;
+
+
+namespace {
+
+/* Every string over the alphabet up to the length */
+std::vector<std::string> allStrings(const std::string& alphabet, const size_t maxLength) {
+    std::vector<std::string> strs{""};
+    for (size_t begin = 0u; begin < strs.size(); begin++) {
+        if (strs[begin].size() == maxLength) {
+            continue;
+        }
+        for (const auto c : alphabet) {
+            strs.push_back(strs[begin] + c);
+        }
+    }
+    return strs;
+}
+
+void expectSameAsSequential(const char* re, const std::string& alphabet, const size_t maxLength) {
+    const RE::REParser sequential(re);
+    const RE::REParser parallel(re, RE::REParser::PARALLEL_DETERMINIZATION);
+    for (const auto& str : allStrings(alphabet, maxLength)) {
+        EXPECT_EQ(parallel.matchExact(str), sequential.matchExact(str)) << re << " on " << str;
+    }
+}
+
+} // namespace
+
+TEST(RETest, Parallel_SameAsSequential) {
+    expectSameAsSequential("(a|b)*a(a|b){5}", "ab", 10);
+    expectSameAsSequential("(ab|ba)*|a*b*c", "abc", 7);
+    expectSameAsSequential("(a|ab)(c|bcd)(d*)", "abcd", 7);
+    expectSameAsSequential("", "a", 2);
+}
+
+TEST(RETest, Parallel_WithOtherFlags) {
+    RE::REParser parser("(héllo|wörld)+", RE::REParser::UTF8 |
+                                          RE::REParser::CASE_INSENSITIVE |
+                                          RE::REParser::PARALLEL_DETERMINIZATION);
+    EXPECT_TRUE(parser.matchExact("HÉLLOwörld"));
+    EXPECT_FALSE(parser.matchExact("hello"));
+    std::string_view match;
+    EXPECT_EQ(parser.find("say Hello, Héllo!", match), 11);
+    EXPECT_EQ(match, "Héllo");
+}
+
+TEST(RETest, Parallel_CompileResource) {
+    const char* const re = "(a|b)*a(a|b){5}";
+    const RE::REParser onHeap(re);
+    // the arena is released while the parsers are in use
+    std::unique_ptr<RE::REParser> sequential, parallel;
+    {
+        std::pmr::monotonic_buffer_resource arena;
+        sequential = std::make_unique<RE::REParser>(re, RE::REParser::NONE, &arena);
+        parallel = std::make_unique<RE::REParser>(re, RE::REParser::PARALLEL_DETERMINIZATION, &arena);
+    }
+    for (const auto& str : allStrings("ab", 10)) {
+        EXPECT_EQ(sequential->matchExact(str), onHeap.matchExact(str)) << str;
+        EXPECT_EQ(parallel->matchExact(str), onHeap.matchExact(str)) << str;
+    }
+}
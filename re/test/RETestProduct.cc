@@ -0,0 +1,122 @@
+#include <RE.h>
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+namespace {
+
+/* All the strings over abc of at most 6 characters */
+std::vector<std::string> allStrings() {
+    std::vector<std::string> strings{""};
+    for (size_t i = 0u; i < strings.size(); i++) {
+        if (strings[i].size() < 6u) {
+            for (const char c : {'a', 'b', 'c'}) {
+                strings.push_back(strings[i] + c);
+            }
+        }
+    }
+    return strings;
+}
+
+const std::vector<std::pair<std::string, std::string>> PAIRS = {
+    {"(a|b)*abb", "a*b*"},
+    {"a(b|c)*", "(a|b)*c"},
+    {"(ab)*", "(a|b)(a|b)*"},
+    {"", "c*"},
+    {"[ab]{3}", "a.*"},
+};
+
+} // namespace
+
+TEST(RETest, Product_Operations) {
+    const auto strings = allStrings();
+    for (const auto& [reA, reB] : PAIRS) {
+        RE::REParser a(reA);
+        RE::REParser b(reB);
+        const auto intersection = RE::REParser::intersectionOf(a, b);
+        const auto alternatives = RE::REParser::unionOf(a, b);
+        const auto difference = RE::REParser::differenceOf(a, b);
+        const auto complement = RE::REParser::complementOf(a);
+        for (const auto& str : strings) {
+            const auto inA = a.matchExact(str);
+            const auto inB = b.matchExact(str);
+            EXPECT_EQ(intersection.matchExact(str), inA and inB) << reA << " & " << reB << " on " << str;
+            EXPECT_EQ(alternatives.matchExact(str), inA or inB) << reA << " | " << reB << " on " << str;
+            EXPECT_EQ(difference.matchExact(str), inA and not inB) << reA << " - " << reB << " on " << str;
+            EXPECT_EQ(complement.matchExact(str), not inA) << "~" << reA << " on " << str;
+        }
+    }
+}
+
+TEST(RETest, Product_NoGroups) {
+    RE::REParser a("(a+)(b+)");
+    RE::REParser b("(a)*b");
+    const auto intersection = RE::REParser::intersectionOf(a, b);
+    EXPECT_EQ(intersection.numGroups(), 0u);
+    RE::REParser::Groups_t groups;
+    EXPECT_TRUE(intersection.matchExact("aab", groups));
+    EXPECT_EQ(groups, RE::REParser::Groups_t{"aab"});
+    EXPECT_FALSE(intersection.matchExact("abb"));
+}
+
+TEST(RETest, Product_Find) {
+    RE::REParser words("[a-z]+");
+    RE::REParser withX(".*x.*");
+    const auto wordsWithX = RE::REParser::intersectionOf(words, withX);
+    std::string_view match;
+    EXPECT_EQ(wordsWithX.find("ab cxd", match), 3);
+    EXPECT_EQ(match, "cxd");
+    EXPECT_EQ(wordsWithX.find("ab cd"), -1);
+
+    // leftmost-longest over the substrings: a prefix of a keyword is a name
+    const auto names = RE::REParser::differenceOf(words, RE::REParser("if|else|while"));
+    EXPECT_EQ(names.find("if iffy", match), 0);
+    EXPECT_EQ(match, "i");
+    std::vector<std::string_view> matches;
+    for (const auto m : names.findAll("while whiles")) {
+        matches.push_back(m);
+    }
+    EXPECT_EQ(matches, (std::vector<std::string_view>{"whil", "e", "whiles"}));
+}
+
+TEST(RETest, Product_Empty) {
+    EXPECT_FALSE(RE::REParser("a*").isEmpty());
+    EXPECT_FALSE(RE::REParser("").isEmpty());
+    EXPECT_TRUE(RE::REParser::intersectionOf(RE::REParser("a+"), RE::REParser("b+")).isEmpty());
+    EXPECT_TRUE(RE::REParser::differenceOf(RE::REParser("ab|ba"), RE::REParser("(a|b)*")).isEmpty());
+    EXPECT_FALSE(RE::REParser::differenceOf(RE::REParser("(a|b)*"), RE::REParser("ab|ba")).isEmpty());
+    // the complement of all the byte strings
+    EXPECT_TRUE(RE::REParser::complementOf(RE::REParser("(.|\\n)*")).isEmpty());
+    EXPECT_TRUE(RE::REParser::complementOf(RE::REParser::complementOf(RE::REParser("a+"))).isSubsetOf(RE::REParser("a+")));
+}
+
+TEST(RETest, Product_Subset) {
+    RE::REParser digits("[0-9]+");
+    RE::REParser number("[0-9]+(\\.[0-9]+)?");
+    RE::REParser hex("0x[0-9a-f]+");
+    EXPECT_TRUE(digits.isSubsetOf(number));
+    EXPECT_FALSE(number.isSubsetOf(digits));
+    EXPECT_FALSE(hex.isSubsetOf(number));
+    EXPECT_TRUE(hex.isSubsetOf(RE::REParser("[0-9a-z]+")));
+    EXPECT_TRUE(RE::REParser("ab|ba").isSubsetOf(RE::REParser("(a|b)*")));
+    // the empty language is a subset of any, the empty string is not
+    const auto empty = RE::REParser::intersectionOf(digits, hex);
+    EXPECT_TRUE(empty.isSubsetOf(RE::REParser("x")));
+    EXPECT_FALSE(RE::REParser("").isSubsetOf(RE::REParser("x")));
+}
+
+TEST(RETest, Product_UTF8) {
+    RE::REParser greek("[α-ω]+", RE::REParser::UTF8);
+    RE::REParser alpha("[α-γ]*", RE::REParser::UTF8);
+    const auto intersection = RE::REParser::intersectionOf(greek, alpha);
+    EXPECT_TRUE(intersection.matchExact("αβγ"));
+    EXPECT_FALSE(intersection.matchExact("αβδ"));
+    EXPECT_FALSE(intersection.matchExact(""));
+    EXPECT_TRUE(intersection.isSubsetOf(greek));
+    // bytes, not characters: the complement of valid UTF-8 is invalid UTF-8
+    const auto complement = RE::REParser::complementOf(greek);
+    EXPECT_TRUE(complement.matchExact("\xce"));
+    EXPECT_FALSE(complement.matchExact("αω"));
+}
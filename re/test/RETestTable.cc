@@ -0,0 +1,205 @@
+#include <RE.h>
+#include <RELexer.h>
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+/* Distinct words, each state of their DFA reading few of the letters */
+std::vector<std::string> makeWords(const size_t numWords) {
+    std::vector<std::string> words;
+    uint32_t seed = 12345u;
+    for (size_t i = 0u; i < numWords; i++) {
+        std::string word = "w" + std::to_string(i);
+        for (auto length = 0; length < 6; length++) {
+            seed = seed * 1103515245u + 12345u;
+            word += static_cast<char>('a' + (seed >> 16) % 26);
+        }
+        words.push_back(word);
+    }
+    return words;
+}
+
+} // namespace
+
+TEST(RETest, Table_SmallDFA) {
+    RE::REParser parser("[a-z]+@[a-z]+");
+    EXPECT_GT(parser.tableSize(), 0u);
+    // a byte per slot, and the byte classes of the DFA and of its reverse
+    EXPECT_LT(parser.tableSize(), 2048u);
+}
+
+/* Enough states for the sparse rows to be packed */
+TEST(RETest, Table_PackedRows) {
+    const auto words = makeWords(400u);
+    std::string re;
+    for (const auto& word : words) {
+        re += (re.empty() ? "" : "|") + word;
+    }
+    RE::REParser parser(re);
+    for (const auto& word : words) {
+        EXPECT_TRUE(parser.matchExact(word)) << word;
+        EXPECT_FALSE(parser.matchExact(word + "a")) << word;
+        EXPECT_FALSE(parser.matchExact(word.substr(0u, word.size() - 1u))) << word;
+    }
+    EXPECT_FALSE(parser.matchExact("w400abcdef"));
+
+    std::string_view match;
+    const auto str = "xx " + words[123] + " yy";
+    EXPECT_EQ(parser.find(str, match), 3);
+    EXPECT_EQ(match, words[123]);
+
+    // a few bytes per live transition, where a dense table of 4-byte ids
+    // takes more than 100 bytes per state
+    EXPECT_LT(parser.tableSize(), 400u * 10u * 8u);
+}
+
+TEST(RETest, Table_OptimizeLayout) {
+    const auto words = makeWords(400u);
+    std::string re;
+    for (const auto& word : words) {
+        re += (re.empty() ? "" : "|") + word;
+    }
+    std::string text;
+    for (size_t i = 0u; i < words.size(); i += 7u) {
+        text += words[i] + " and " + words[i / 2u].substr(0u, 4u) + ", ";
+    }
+
+    RE::REParser parser(re);
+    std::vector<std::string_view> expected;
+    for (const auto match : parser.findAll(text)) {
+        expected.push_back(match);
+    }
+    // a corpus of only a few of the words, the other states being cold
+    parser.optimizeLayout({words[0], words[1], "w1 w2 w3 " + words[2]});
+    std::vector<std::string_view> matches;
+    for (const auto match : parser.findAll(text)) {
+        matches.push_back(match);
+    }
+    EXPECT_EQ(matches, expected);
+    for (const auto& word : words) {
+        EXPECT_TRUE(parser.matchExact(word)) << word;
+        EXPECT_FALSE(parser.matchExact(word + "a")) << word;
+    }
+
+    // an empty corpus leaves the breadth-first order
+    parser.optimizeLayout({});
+    EXPECT_TRUE(parser.matchExact(words[321]));
+    EXPECT_EQ(parser.find("xx " + words[5]), 3);
+}
+
+TEST(RETest, Table_OptimizeLayoutLexer) {
+    RE::RELexer lexer({"if|else", "[a-z]+", "[0-9]+", " +"});
+    const std::string_view str = "if x1 else 42 elsewhere";
+    std::vector<std::pair<uint32_t, std::string_view>> expected;
+    for (const auto token : lexer.tokenize(str)) {
+        expected.emplace_back(token.id, token.text);
+    }
+    lexer.optimizeLayout({"if then else", "123 456"});
+    std::vector<std::pair<uint32_t, std::string_view>> tokens;
+    for (const auto token : lexer.tokenize(str)) {
+        tokens.emplace_back(token.id, token.text);
+    }
+    EXPECT_EQ(tokens, expected);
+}
+
+TEST(RETest, Table_MemoryUsage) {
+    const auto words = makeWords(400u);
+    std::string re;
+    for (const auto& word : words) {
+        re += (re.empty() ? "" : "|") + word;
+    }
+    RE::REParser parser(re);
+    // the table and the few bytes around it, not the thousands of states
+    // of the construction
+    EXPECT_GE(parser.memoryUsage(), parser.tableSize());
+    EXPECT_LT(parser.memoryUsage(), parser.tableSize() + 4096u);
+
+    // the dense table is rebuilt for the renumbering and freed again
+    parser.optimizeLayout({words[7]});
+    EXPECT_LT(parser.memoryUsage(), parser.tableSize() + 4096u);
+    EXPECT_TRUE(parser.matchExact(words[7]));
+    EXPECT_EQ(parser.find("xx " + words[8]), 3);
+
+    RE::REParser groups("(a+)(b+)");
+    EXPECT_GT(groups.memoryUsage(), groups.tableSize());
+    RE::REParser::Groups_t matches;
+    EXPECT_TRUE(groups.matchExact("aab", matches));
+    EXPECT_EQ(matches[2], "b");
+
+    const RE::RELexer lexer({"if", "[a-z]+"});
+    EXPECT_GE(lexer.memoryUsage(), lexer.tableSize());
+}
+
+/**
+ * Few byte classes, so the table reads two bytes per step, and more states
+ * than the shuffle engine takes
+ */
+TEST(RETest, Table_Stride2) {
+    RE::REParser parser("(ab|c)*d?(ef){9}");
+    const std::string ef9 = "efefefefefefefefef";
+    for (const auto str : {"", "d", "ab", "abd", "cab", "cabd", "ccccccc", "abababc", "abcabcd"}) {
+        EXPECT_TRUE(parser.matchExact(str + ef9)) << str;
+    }
+    for (const auto str : {"a", "b", "ba", "abdd", "abca", "cabcabb", "dab"}) {
+        EXPECT_FALSE(parser.matchExact(str + ef9)) << str;
+    }
+    EXPECT_FALSE(parser.matchExact("abef"));
+
+    // final states at odd and at even positions
+    RE::REParser words("wwwwwwwwwwwwwwwwx(yz)*y?");
+    const std::string w16 = "wwwwwwwwwwwwwwww";
+    const auto expectMatch = [&words](const std::string& str, const int32_t start, const std::string& expected) {
+        std::string_view match;
+        EXPECT_EQ(words.find(str, match), start) << str;
+        EXPECT_EQ(match, expected) << str;
+    };
+    expectMatch(".." + w16 + "xyzyzy..", 2, w16 + "xyzyzy");
+    expectMatch(".." + w16 + "xyzyz", 2, w16 + "xyzyz");
+    expectMatch(w16 + "xyzz", 0, w16 + "xyz");
+    expectMatch(w16 + "xzy", 0, w16 + "x");
+
+    const RE::RELexer lexer({"a+", "(ab)+", "b", "bbbbbbbbbbbbbbbbbbba"});
+    std::vector<std::pair<uint32_t, std::string_view>> tokens;
+    for (const auto token : lexer.tokenize("aaaabababbab")) {
+        tokens.emplace_back(token.id, token.text);
+    }
+    const std::vector<std::pair<uint32_t, std::string_view>> expected = {
+        {0u, "aaaa"}, {2u, "b"}, {1u, "abab"}, {2u, "b"}, {1u, "ab"},
+    };
+    EXPECT_EQ(tokens, expected);
+}
+
+/* At most 16 states, so the matching runs on the shuffle engine if the CPU has it */
+TEST(RETest, Table_Sheng) {
+    RE::REParser hex("(0x)?[0-9a-f]+");
+    EXPECT_TRUE(hex.matchExact("0x1234567890abcdef1234567890abcdef1234567890abcdef1234567890abcdef1234567890"));
+    EXPECT_FALSE(hex.matchExact("0x1234567890abcdef1234567890abcdef1234567890abcdef1234567890abcdef123456789g"));
+    EXPECT_FALSE(hex.matchExact("0x"));
+    EXPECT_TRUE(hex.matchExact("0"));
+    std::vector<std::string_view> matches;
+    for (const auto match : hex.findAll("xx 0xff, 12 or 0x")) {
+        matches.push_back(match);
+    }
+    EXPECT_EQ(matches, (std::vector<std::string_view>{"0xff", "12", "0"}));
+
+    // the start is found by a small reversed DFA running backwards
+    RE::REParser log("[a-z]+\\.log");
+    std::string_view match;
+    EXPECT_EQ(log.find("see 12 app.log.1", match), 7);
+    EXPECT_EQ(match, "app.log");
+
+    const RE::RELexer lexer({"[0-9]+", "[a-z]+", " "});
+    std::vector<std::pair<uint32_t, std::string_view>> tokens;
+    for (const auto token : lexer.tokenize("abc 123!")) {
+        tokens.emplace_back(token.id, token.text);
+    }
+    const std::vector<std::pair<uint32_t, std::string_view>> expected = {
+        {1u, "abc"}, {2u, " "}, {0u, "123"}, {RE::RELexer::UNKNOWN, "!"},
+    };
+    EXPECT_EQ(tokens, expected);
+}
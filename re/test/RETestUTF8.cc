@@ -0,0 +1,96 @@
+#include <RE.h>
+#include <REExceptions.h>
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+using namespace std::string_literals;
+
+
+TEST(RETest, UTF8Exceptions) {
+    EXPECT_THROW(RE::REParser("\xff", RE::REParser::UTF8), RE::InvalidUTF8Exception);
+    EXPECT_THROW(RE::REParser("a\xc3", RE::REParser::UTF8), RE::InvalidUTF8Exception);
+    EXPECT_THROW(RE::REParser("\xc0\xaf", RE::REParser::UTF8), RE::InvalidUTF8Exception);  // overlong
+    EXPECT_THROW(RE::REParser("[\xed\xa0\x80]", RE::REParser::UTF8), RE::InvalidUTF8Exception);  // surrogate
+    EXPECT_THROW(RE::REParser(R"(\u00e)", RE::REParser::UTF8), RE::EscapeException);
+    EXPECT_THROW(RE::REParser(R"(\ud800)", RE::REParser::UTF8), RE::EscapeException);
+    EXPECT_THROW(RE::REParser(R"(\u00e9)"), RE::EscapeException);
+    EXPECT_THROW(RE::REParser("[я-а]", RE::REParser::UTF8), RE::InvalidRangeException);
+}
+
+TEST(RETest, CanParseAndMatchUTF8Literals) {
+    RE::REParser parser("日本語", RE::REParser::UTF8);
+    EXPECT_TRUE(parser.matchExact("日本語"));
+    EXPECT_FALSE(parser.matchExact("日本"));
+
+    RE::REParser repeat("é+", RE::REParser::UTF8);
+    EXPECT_TRUE(repeat.matchExact("é"));
+    EXPECT_TRUE(repeat.matchExact("ééé"));
+    EXPECT_FALSE(repeat.matchExact("e"));
+    EXPECT_FALSE(repeat.matchExact("é\xa9"));
+
+    // without the UTF-8 mode the repetition applies to the last byte
+    EXPECT_TRUE(RE::REParser("é+").matchExact("é\xa9"));
+}
+
+TEST(RETest, CanParseAndMatchUTF8Dot) {
+    RE::REParser parser("a.c", RE::REParser::UTF8);
+    EXPECT_TRUE(parser.matchExact("abc"));
+    EXPECT_TRUE(parser.matchExact("aéc"));
+    EXPECT_TRUE(parser.matchExact("a€c"));
+    EXPECT_TRUE(parser.matchExact("a😀c"));
+
+    EXPECT_FALSE(parser.matchExact("a\nc"));
+    EXPECT_FALSE(parser.matchExact("a\xff" "c"));     // invalid byte
+    EXPECT_FALSE(parser.matchExact("a\xc3" "c"));     // truncated sequence
+    EXPECT_FALSE(parser.matchExact("a\xc0\xaf" "c"));  // overlong
+    EXPECT_FALSE(parser.matchExact("a\xed\xa0\x80" "c"));  // surrogate
+    EXPECT_FALSE(parser.matchExact("aééc"));
+
+    RE::REParser bytes("a.c");
+    EXPECT_FALSE(bytes.matchExact("aéc"));
+    EXPECT_TRUE(bytes.matchExact("a\xff" "c"));
+}
+
+TEST(RETest, CanParseAndMatchUTF8Brackets) {
+    RE::REParser greek("[α-ω]+", RE::REParser::UTF8);
+    EXPECT_TRUE(greek.matchExact("λογος"));
+    EXPECT_FALSE(greek.matchExact("λόγος"));  // ό is outside α-ω
+    EXPECT_FALSE(greek.matchExact("logos"));
+    EXPECT_FALSE(greek.matchExact("Λογος"));
+
+    RE::REParser notAscii("[^\\x00-\\x7f]+", RE::REParser::UTF8);
+    EXPECT_TRUE(notAscii.matchExact("日本語"));
+    EXPECT_TRUE(notAscii.matchExact("😀€é"));
+    EXPECT_FALSE(notAscii.matchExact("日本a"));
+
+    RE::REParser mixed(R"([a-zà-ÿ😀]+)", RE::REParser::UTF8);
+    EXPECT_TRUE(mixed.matchExact("càfé😀"));
+    EXPECT_FALSE(mixed.matchExact("café€"));
+
+    RE::REParser wide(R"([\u0080-￿])", RE::REParser::UTF8);
+    EXPECT_TRUE(wide.matchExact("\u0080"));
+    EXPECT_TRUE(wide.matchExact("߿"));
+    EXPECT_TRUE(wide.matchExact("ࠀ"));
+    EXPECT_TRUE(wide.matchExact("퟿"));
+    EXPECT_TRUE(wide.matchExact(""));
+    EXPECT_TRUE(wide.matchExact("￿"));
+    EXPECT_FALSE(wide.matchExact("\U00010000"));
+    EXPECT_FALSE(wide.matchExact("\x7f"));
+}
+
+TEST(RETest, CanParseAndMatchUTF8NegatedEscapes) {
+    RE::REParser parser(R"(\D\W\S)", RE::REParser::UTF8);
+    EXPECT_TRUE(parser.matchExact("aé€"));
+    EXPECT_FALSE(parser.matchExact("1é€"));
+    EXPECT_FALSE(parser.matchExact("a\xc3\xa9\xe2"));
+}
+
+TEST(RETest, CanCaptureUTF8Groups) {
+    RE::REParser parser("(.+)=(.*)", RE::REParser::UTF8);
+    RE::REParser::Groups_t groups;
+    ASSERT_TRUE(parser.matchExact("ключ=значение", groups));
+    EXPECT_EQ(groups[1], "ключ");
+    EXPECT_EQ(groups[2], "значение");
+}